@@ -11,14 +11,43 @@ del /q "%SHADER_DIR%\effects\*.spv" 2>nul
 
 if not exist "%BIN_DIR%" mkdir "%BIN_DIR%"
 del /q "%BIN_DIR%\*.spv" 2>nul
+rem A stale archive would shadow the new binaries, the build packs them again
+del /q "%BIN_DIR%\shaders.pak" 2>nul
 
 glslc -fshader-stage=vertex "%SHADER_DIR%\vertex.glsl" -o "%BIN_DIR%\vertex.spv"
 glslc -fshader-stage=fragment "%SHADER_DIR%\fragment.glsl" -o "%BIN_DIR%\fragment.spv"
-glslc -fshader-stage=compute "%SHADER_DIR%\sampler.glsl" -o "%BIN_DIR%\sampler.spv"
+call :compile_variants "%SHADER_DIR%\sampler.glsl" sampler
+call :compile_variants "%SHADER_DIR%\fused.glsl" fused
+call :compile_half_variant "%SHADER_DIR%\fused.glsl" fused
+glslc -fshader-stage=compute -I"%INCLUDE_DIR%" "%SHADER_DIR%\lut_bake.glsl" -o "%BIN_DIR%\lut_bake.spv"
+call :compile_variants "%SHADER_DIR%\lut_apply.glsl" lut_apply
+call :compile_variants "%SHADER_DIR%\blur_pass.glsl" blur_pass
+call :compile_variants "%SHADER_DIR%\blur_down.glsl" blur_down
+call :compile_variants "%SHADER_DIR%\blur_apply.glsl" blur_apply
+call :compile_variants "%SHADER_DIR%\blur_upsample.glsl" blur_upsample
+rem Subgroup operations need SPIR-V 1.3
+call :compile_variants "%SHADER_DIR%\stats_reduce.glsl" stats_reduce "--target-env=vulkan1.1"
+call :compile_variants "%SHADER_DIR%\stats_reduce.glsl" stats_reduce_atomic "-DSTATS_SHARED_ATOMICS"
+call :compile_variants "%SHADER_DIR%\mip_downsample.glsl" mip_downsample
 
 for %%f in ("%SHADER_DIR%\effects\*.glsl") do (
-    glslc -fshader-stage=compute -I"%INCLUDE_DIR%" "%%f" -o "%BIN_DIR%\%%~nf.spv"
+    call :compile_variants "%%f" %%~nf
+    call :compile_half_variant "%%f" %%~nf
     echo Compiled %%~nxf
 )
 
 echo Shaders compiled.
+goto :eof
+
+rem Shaders writing the chain images are built once per working format, see shaders\include\format.glsl.
+rem An optional third argument is passed on to glslc.
+:compile_variants
+glslc -fshader-stage=compute -I"%INCLUDE_DIR%" %~3 "%~1" -o "%BIN_DIR%\%~2.spv"
+glslc -fshader-stage=compute -I"%INCLUDE_DIR%" -DWORKING_FLOAT16 %~3 "%~1" -o "%BIN_DIR%\%~2.rgba16f.spv"
+glslc -fshader-stage=compute -I"%INCLUDE_DIR%" -DWORKING_FLOAT32 %~3 "%~1" -o "%BIN_DIR%\%~2.rgba32f.spv"
+goto :eof
+
+rem The fused kernel and the effects also get an RGBA16F build computing in float16, loaded on devices with shaderFloat16
+:compile_half_variant
+glslc -fshader-stage=compute -I"%INCLUDE_DIR%" -DWORKING_FLOAT16 -DWORKING_HALF_MATH "%~1" -o "%BIN_DIR%\%~2.rgba16f.f16.spv"
+goto :eof
@@ -8,15 +8,43 @@ rm -f "$SHADER_DIR"/*.spv "$SHADER_DIR"/effects/*.spv
 
 mkdir -p "$BIN_DIR"
 rm -f "$BIN_DIR"/*.spv
+# A stale archive would shadow the new binaries, the build packs them again
+rm -f "$BIN_DIR/shaders.pak"
+
+# Shaders writing the chain images are built once per working format, see shaders/include/format.glsl.
+# Further arguments are passed on to glslc.
+compile_variants() {
+    glslc -fshader-stage=compute -I"$INCLUDE_DIR" "${@:3}" "$1" -o "$BIN_DIR/$2.spv"
+    glslc -fshader-stage=compute -I"$INCLUDE_DIR" -DWORKING_FLOAT16 "${@:3}" "$1" -o "$BIN_DIR/$2.rgba16f.spv"
+    glslc -fshader-stage=compute -I"$INCLUDE_DIR" -DWORKING_FLOAT32 "${@:3}" "$1" -o "$BIN_DIR/$2.rgba32f.spv"
+}
+
+# The fused kernel and the effects also get an RGBA16F build computing in float16, loaded on devices with shaderFloat16
+compile_half_variant() {
+    glslc -fshader-stage=compute -I"$INCLUDE_DIR" -DWORKING_FLOAT16 -DWORKING_HALF_MATH "$1" -o "$BIN_DIR/$2.rgba16f.f16.spv"
+}
 
 glslc -fshader-stage=vertex "$SHADER_DIR/vertex.glsl" -o "$BIN_DIR/vertex.spv"
 glslc -fshader-stage=fragment "$SHADER_DIR/fragment.glsl" -o "$BIN_DIR/fragment.spv"
-glslc -fshader-stage=compute "$SHADER_DIR/sampler.glsl" -o "$BIN_DIR/sampler.spv"
+compile_variants "$SHADER_DIR/sampler.glsl" sampler
+compile_variants "$SHADER_DIR/fused.glsl" fused
+compile_half_variant "$SHADER_DIR/fused.glsl" fused
+glslc -fshader-stage=compute -I"$INCLUDE_DIR" "$SHADER_DIR/lut_bake.glsl" -o "$BIN_DIR/lut_bake.spv"
+compile_variants "$SHADER_DIR/lut_apply.glsl" lut_apply
+compile_variants "$SHADER_DIR/blur_pass.glsl" blur_pass
+compile_variants "$SHADER_DIR/blur_down.glsl" blur_down
+compile_variants "$SHADER_DIR/blur_apply.glsl" blur_apply
+compile_variants "$SHADER_DIR/blur_upsample.glsl" blur_upsample
+# Subgroup operations need SPIR-V 1.3
+compile_variants "$SHADER_DIR/stats_reduce.glsl" stats_reduce --target-env=vulkan1.1
+compile_variants "$SHADER_DIR/stats_reduce.glsl" stats_reduce_atomic -DSTATS_SHARED_ATOMICS
+compile_variants "$SHADER_DIR/mip_downsample.glsl" mip_downsample
 
 for shader in "$SHADER_DIR"/effects/*.glsl; do
     [ -f "$shader" ] || continue
     filename=$(basename "$shader" .glsl)
-    glslc -fshader-stage=compute -I"$INCLUDE_DIR" "$shader" -o "$BIN_DIR/${filename}.spv"
+    compile_variants "$shader" "$filename"
+    compile_half_variant "$shader" "$filename"
     echo "Compiled ${filename}.glsl"
 done
 
@@ -0,0 +1,33 @@
+#version 460 core
+
+#include "format.glsl"
+
+// The horizontally blurred image, and the original that is replaced by the result
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D blurImage;
+layout(binding = 1, WORKING_FORMAT) uniform image2D image;
+
+layout(push_constant) uniform pc {
+    float sigma;
+    int radius;
+    uint mode;
+    float amount;
+    float threshold;
+};
+
+#define BLUR_SOURCE blurImage
+#include "blur.glsl"
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// Vertical pass of a separable gaussian, composited over the original in place
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(image)))) {
+        return;
+    }
+
+    vec4 blurred = gaussianBlur(pixel, ivec2(0, 1), sigma, radius);
+
+    imageStore(image, pixel, compositeBlur(imageLoad(image, pixel), blurred, mode, amount, threshold));
+}
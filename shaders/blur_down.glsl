@@ -0,0 +1,28 @@
+#version 460 core
+
+#include "format.glsl"
+
+layout(set = 0, binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(set = 1, binding = 0, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// Halves the image with a 2x2 box, the next level of a blur pyramid
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(outImage)))) {
+        return;
+    }
+
+    // Odd edges repeat their last row or column
+    ivec2 maxCoord = imageSize(inImage) - 1;
+    ivec2 source = pixel * 2;
+
+    vec4 color = imageLoad(inImage, min(source, maxCoord))
+        + imageLoad(inImage, min(source + ivec2(1, 0), maxCoord))
+        + imageLoad(inImage, min(source + ivec2(0, 1), maxCoord))
+        + imageLoad(inImage, min(source + ivec2(1, 1), maxCoord));
+
+    imageStore(outImage, pixel, color * 0.25);
+}
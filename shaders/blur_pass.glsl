@@ -0,0 +1,28 @@
+#version 460 core
+
+#include "format.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(push_constant) uniform pc {
+    ivec2 direction;
+    float sigma;
+    int radius;
+};
+
+#define BLUR_SOURCE inImage
+#include "blur.glsl"
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// One direction of a separable gaussian
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(outImage)))) {
+        return;
+    }
+
+    imageStore(outImage, pixel, gaussianBlur(pixel, direction, sigma, radius));
+}
@@ -0,0 +1,36 @@
+#version 460 core
+
+#include "format.glsl"
+
+// The original, replaced by the result, and the blurred pyramid level
+layout(set = 0, binding = 1, WORKING_FORMAT) uniform image2D image;
+layout(set = 1, binding = 0) uniform sampler2D blurredLevel;
+
+layout(push_constant) uniform pc {
+    float sigma;
+    int radius;
+    uint mode;
+    float amount;
+    float threshold;
+    // Halvings between the image and the level
+    int level;
+};
+
+#include "blur.glsl"
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// Bilinearly upsamples a blurred pyramid level and composites it over the original in place
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(image)))) {
+        return;
+    }
+
+    // Level texels cover 2^level pixels per axis, starting at the image origin
+    vec2 coord = (vec2(pixel) + 0.5) / float(1 << level) / vec2(textureSize(blurredLevel, 0));
+    vec4 blurred = textureLod(blurredLevel, coord, 0.0);
+
+    imageStore(image, pixel, compositeBlur(imageLoad(image, pixel), blurred, mode, amount, threshold));
+}
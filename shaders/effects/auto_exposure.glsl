@@ -0,0 +1,36 @@
+#version 460 core
+
+#include "format.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(push_constant) uniform pc {
+    // Mean luminance the image is scaled towards
+    float target;
+    float strength;
+};
+
+#define STATS_ACCESS readonly
+#include "stats.glsl"
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+// Stops the image is scaled by at most, so black or blown out frames aren't amplified without bound
+#define MAX_STOPS 8.0
+#define MIN_MEAN 0.0001
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(outImage)))) {
+        return;
+    }
+
+    float mean = max(statsMean(STATS_LUMINANCE), MIN_MEAN);
+    float stops = clamp(log2(target / mean), -MAX_STOPS, MAX_STOPS) * strength;
+
+    vec4 color = imageLoad(inImage, pixel);
+
+    imageStore(outImage, pixel, vec4(color.rgb * exp2(stops), color.a));
+}
@@ -0,0 +1,87 @@
+#version 460 core
+
+#include "format.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(push_constant) uniform pc {
+    // Percentage of pixels clipped to black and to white per channel
+    float clip;
+    float amount;
+};
+
+#define STATS_ACCESS readonly
+#include "stats.glsl"
+
+// One invocation per histogram bin
+#define GROUP_SIZE 16
+
+layout(local_size_x = GROUP_SIZE, local_size_y = GROUP_SIZE, local_size_z = 1) in;
+
+shared uint cumulative[3][STATS_BIN_COUNT];
+shared uint lowBin[3];
+shared uint highBin[3];
+
+// Stretches every color channel between the percentiles of its histogram. Each workgroup finds
+// them itself, one invocation per bin, so the levels never go through the CPU.
+void main() {
+    uint bin = gl_LocalInvocationIndex;
+
+    for (uint channel = 0u; channel < 3u; channel++) {
+        cumulative[channel][bin] = stats.histogram[channel * STATS_BIN_COUNT + bin];
+    }
+
+    if (bin < 3u) {
+        lowBin[bin] = 0u;
+        highBin[bin] = 0u;
+    }
+
+    barrier();
+
+    // Inclusive prefix sums over the bins
+    for (uint offset = 1u; offset < STATS_BIN_COUNT; offset *= 2u) {
+        uvec3 previous = uvec3(0u);
+
+        if (bin >= offset) {
+            previous = uvec3(cumulative[0][bin - offset], cumulative[1][bin - offset], cumulative[2][bin - offset]);
+        }
+
+        barrier();
+
+        for (uint channel = 0u; channel < 3u; channel++) {
+            cumulative[channel][bin] += previous[channel];
+        }
+
+        barrier();
+    }
+
+    uint clipCount = uint(float(stats.pixelCount) * clip * 0.01);
+
+    // The first bin past the clipped dark pixels is where the count of bins below it ends
+    for (uint channel = 0u; channel < 3u; channel++) {
+        if (cumulative[channel][bin] <= clipCount) {
+            atomicAdd(lowBin[channel], 1u);
+        }
+        if (cumulative[channel][bin] + clipCount < stats.pixelCount) {
+            atomicAdd(highBin[channel], 1u);
+        }
+    }
+
+    barrier();
+
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+
+    if (any(greaterThanEqual(pixel, imageSize(outImage)))) {
+        return;
+    }
+
+    vec3 low = vec3(lowBin[0], lowBin[1], lowBin[2]) / float(STATS_BIN_COUNT - 1);
+    vec3 high = vec3(highBin[0], highBin[1], highBin[2]) / float(STATS_BIN_COUNT - 1);
+    high = max(high, low + 1.0 / float(STATS_BIN_COUNT - 1));
+
+    vec4 color = imageLoad(inImage, pixel);
+    vec3 stretched = (color.rgb - low) / (high - low);
+
+    imageStore(outImage, pixel, vec4(mix(color.rgb, stretched, amount), color.a));
+}
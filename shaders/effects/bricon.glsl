@@ -1,7 +1,10 @@
 #version 460 core
 
-layout(binding = 0, rgba8) uniform readonly image2D inImage;
-layout(binding = 1, rgba8) uniform writeonly image2D outImage;
+#include "format.glsl"
+#include "pointwise.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
 
 layout(push_constant) uniform pc {
     float brightness;
@@ -11,10 +14,9 @@ layout(push_constant) uniform pc {
 layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
 
 void main() {
-    vec4 color = imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy));
+    mvec4 color = mvec4(imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy)));
 
-    color.rgb += brightness;
-    color.rgb = (1.0 + contrast) * (color.rgb - 0.5) + 0.5;
+    color = applyBriCon(color, mfloat(brightness), mfloat(contrast));
 
-    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), color);
+    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), vec4(color));
 }
@@ -1,9 +1,10 @@
 #version 460 core
 
-#include "color.glsl"
+#include "format.glsl"
+#include "pointwise.glsl"
 
-layout(binding = 0, rgba8) uniform readonly image2D inImage;
-layout(binding = 1, rgba8) uniform writeonly image2D outImage;
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
 
 layout(push_constant) uniform pc {
     float hue;
@@ -14,14 +15,9 @@ layout(push_constant) uniform pc {
 layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
 
 void main() {
-    vec4 color = imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy));
+    mvec4 color = mvec4(imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy)));
 
-    vec3 hsl = rgbToHsl(color.rgb);
-    hsl.x = fract(hsl.x + hue);
-    hsl.y = clamp(hsl.y + saturation, 0.0, 1.0);
-    hsl.z = clamp(hsl.z + brightness, 0.0, 1.0);
+    color = applyHueSat(color, mfloat(hue), mfloat(saturation), mfloat(brightness));
 
-    color.rgb = hslToRgb(hsl);
-
-    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), color);
+    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), vec4(color));
 }
@@ -1,25 +1,31 @@
 #version 460 core
 
-layout(binding = 0, rgba8) uniform readonly image2D inImage;
-layout(binding = 1, rgba8) uniform writeonly image2D outImage;
+#include "format.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
 
 layout(push_constant) uniform pc {
     float sharpness;
 };
 
-layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+#define TILE_RADIUS 1
+#include "tile.glsl"
 
 void main() {
-    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    loadTile();
 
-    vec4 center = imageLoad(inImage, coord);
-    vec4 left = imageLoad(inImage, coord + ivec2(-1, 0));
-    vec4 right = imageLoad(inImage, coord + ivec2(1, 0));
-    vec4 up = imageLoad(inImage, coord + ivec2(0, -1));
-    vec4 down = imageLoad(inImage, coord + ivec2(0, 1));
+    if (!tileInBounds()) {
+        return;
+    }
 
-    vec4 edges = (left + right + up + down) * 0.25;
-    vec4 color = center + (center - edges) * sharpness;
+    // The center pushed away from the mean of its four direct neighbors
+    float edge = -0.25 * sharpness;
+    float weights[TILE_TAPS] = float[](
+        0.0, edge, 0.0,
+        edge, 1.0 + sharpness, edge,
+        0.0, edge, 0.0
+    );
 
-    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), color);
+    imageStore(outImage, tilePixel(), tileConvolve(weights));
 }
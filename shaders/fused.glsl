@@ -0,0 +1,34 @@
+#version 460 core
+
+#include "format.glsl"
+#include "ops.glsl"
+
+layout(binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(binding = 2, std430) readonly buffer Ops {
+    FusedOp ops[];
+};
+
+layout(push_constant) uniform pc {
+    uint opOffset;
+    uint opCount;
+};
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+void main() {
+    mvec4 color = mvec4(imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy)));
+    vec2 size = vec2(imageSize(inImage));
+
+    for (uint i = 0u; i < opCount; i++) {
+        color = applyOp(ops[opOffset + i], color, gl_GlobalInvocationID.xy, size);
+
+#ifdef WORKING_UNORM
+        // Unfused effects round-trip through an rgba8 image between stages
+        color = clamp(color, mfloat(0.0), mfloat(1.0));
+#endif
+    }
+
+    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), vec4(color));
+}
@@ -0,0 +1,52 @@
+#include "color.glsl"
+
+// Must match EffectBlurModes in src/effect/registry.hpp
+#define BLUR_GAUSSIAN 1
+#define BLUR_UNSHARP 2
+#define BLUR_GLOW 3
+
+// Unnormalized, the passes divide by the sum of the weights they used
+float gaussianWeight(int offset, float sigma) {
+    sigma = max(sigma, EPSILON);
+
+    return exp(-float(offset * offset) / (2.0 * sigma * sigma));
+}
+
+#ifdef BLUR_SOURCE
+// Gaussian of `radius` taps on each side along `direction`, clamping reads to the image edge.
+// Shaders define BLUR_SOURCE as the readonly image to blur before including this file.
+vec4 gaussianBlur(ivec2 center, ivec2 direction, float sigma, int radius) {
+    ivec2 maxCoord = imageSize(BLUR_SOURCE) - 1;
+
+    vec4 sum = vec4(0.0);
+    float total = 0.0;
+
+    for (int i = -radius; i <= radius; i++) {
+        float weight = gaussianWeight(i, sigma);
+
+        sum += imageLoad(BLUR_SOURCE, clamp(center + direction * i, ivec2(0), maxCoord)) * weight;
+        total += weight;
+    }
+
+    return sum / total;
+}
+#endif
+
+vec4 compositeBlur(vec4 original, vec4 blurred, uint mode, float amount, float threshold) {
+    if (mode == BLUR_UNSHARP) {
+        vec3 detail = original.rgb - blurred.rgb;
+
+        // Flat areas and noise below the threshold stay as they are
+        float mask = step(threshold, abs(luminance(detail)));
+
+        return vec4(original.rgb + detail * amount * mask, original.a);
+    }
+
+    if (mode == BLUR_GLOW) {
+        vec3 bright = max(blurred.rgb - threshold, 0.0);
+
+        return vec4(original.rgb + bright * amount, original.a);
+    }
+
+    return blurred;
+}
@@ -0,0 +1,25 @@
+// Storage format of the chain images, chosen per binary by the shader scripts.
+// Float formats keep values outside [0, 1] between stages, RGBA8 clamps and quantizes them.
+#if defined(WORKING_FLOAT16)
+    #define WORKING_FORMAT rgba16f
+#elif defined(WORKING_FLOAT32)
+    #define WORKING_FORMAT rgba32f
+#else
+    #define WORKING_FORMAT rgba8
+    #define WORKING_UNORM
+#endif
+
+// Arithmetic type of the color ops. The RGBA16F builds of the fused kernel and the effects
+// also come with WORKING_HALF_MATH, computing in float16 on devices with shaderFloat16.
+// Literals are wrapped in mfloat() since float16 values only widen implicitly.
+#ifdef WORKING_HALF_MATH
+    #extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+
+    #define mfloat float16_t
+    #define mvec3 f16vec3
+    #define mvec4 f16vec4
+#else
+    #define mfloat float
+    #define mvec3 vec3
+    #define mvec4 vec4
+#endif
@@ -0,0 +1,47 @@
+#include "pointwise.glsl"
+
+// Must match EffectOps in src/effect/registry.hpp
+#define OP_GRAYSCALE 1u
+#define OP_INVERT 2u
+#define OP_SEPIA 3u
+#define OP_POSTERIZE 4u
+#define OP_SOLARIZE 5u
+#define OP_THRESHOLD 6u
+#define OP_EXPOSURE 7u
+#define OP_GAMMA 8u
+#define OP_TEMPERATURE 9u
+#define OP_VIBRANCE 10u
+#define OP_BRICON 11u
+#define OP_LEVELS 12u
+#define OP_HUESAT 13u
+#define OP_COLOFFSET 14u
+#define OP_VIGNETTE 15u
+
+struct FusedOp {
+    uint op;
+    float p0;
+    float p1;
+    float p2;
+};
+
+// Parameters are stored in fp32 and narrowed per op in the half-math builds
+mvec4 applyOp(FusedOp op, mvec4 color, uvec2 coord, vec2 size) {
+    switch (op.op) {
+    case OP_GRAYSCALE: return applyGrayscale(color);
+    case OP_INVERT: return applyInvert(color);
+    case OP_SEPIA: return applySepia(color);
+    case OP_POSTERIZE: return applyPosterize(color, mfloat(op.p0));
+    case OP_SOLARIZE: return applySolarize(color, mfloat(op.p0));
+    case OP_THRESHOLD: return applyThreshold(color, mfloat(op.p0));
+    case OP_EXPOSURE: return applyExposure(color, mfloat(op.p0));
+    case OP_GAMMA: return applyGamma(color, mfloat(op.p0));
+    case OP_TEMPERATURE: return applyTemperature(color, mfloat(op.p0));
+    case OP_VIBRANCE: return applyVibrance(color, mfloat(op.p0));
+    case OP_BRICON: return applyBriCon(color, mfloat(op.p0), mfloat(op.p1));
+    case OP_LEVELS: return applyLevels(color, mfloat(op.p0), mfloat(op.p1), mfloat(op.p2));
+    case OP_HUESAT: return applyHueSat(color, mfloat(op.p0), mfloat(op.p1), mfloat(op.p2));
+    case OP_COLOFFSET: return applyColOffset(color, mfloat(op.p0), mfloat(op.p1), mfloat(op.p2));
+    case OP_VIGNETTE: return applyVignette(color, coord, size, op.p0, op.p1, op.p2);
+    default: return color;
+    }
+}
@@ -0,0 +1,116 @@
+#include "color.glsl"
+
+mvec4 applyGrayscale(mvec4 color) {
+    mfloat gray = dot(color.rgb, mvec3(0.299, 0.587, 0.114));
+    return mvec4(mvec3(gray), color.a);
+}
+
+mvec4 applyInvert(mvec4 color) {
+    bool linear = false;
+
+    if (linear) {
+        color.rgb = mfloat(1.0) - color.rgb;
+    }
+    else {
+        mvec3 srgb = pow(color.rgb, mvec3(1.0 / 2.2));
+        srgb = mfloat(1.0) - srgb;
+
+        color.rgb = pow(srgb, mvec3(2.2));
+    }
+
+    return color;
+}
+
+mvec4 applySepia(mvec4 color) {
+    mfloat red = dot(color.rgb, mvec3(0.393, 0.769, 0.189));
+    mfloat green = dot(color.rgb, mvec3(0.349, 0.686, 0.168));
+    mfloat blue = dot(color.rgb, mvec3(0.272, 0.534, 0.131));
+    return mvec4(red, green, blue, color.a);
+}
+
+mvec4 applyPosterize(mvec4 color, mfloat level) {
+    mfloat powLevel = pow(mfloat(2.0), level);
+    color.rgb = floor(color.rgb * powLevel) / powLevel;
+    return color;
+}
+
+mvec4 applySolarize(mvec4 color, mfloat threshold) {
+    color.rgb = mix(color.rgb, mfloat(1.0) - color.rgb, step(threshold, color.rgb));
+    return color;
+}
+
+mvec4 applyThreshold(mvec4 color, mfloat threshold) {
+    mfloat lum = luminance(color.rgb);
+    color.rgb = mvec3(step(threshold, lum));
+    return color;
+}
+
+mvec4 applyExposure(mvec4 color, mfloat exposure) {
+    color.rgb *= pow(mfloat(2.0), exposure);
+    return color;
+}
+
+mvec4 applyGamma(mvec4 color, mfloat gamma) {
+    color.rgb = pow(color.rgb, mvec3(mfloat(1.0) / gamma));
+    return color;
+}
+
+mvec4 applyTemperature(mvec4 color, mfloat temperature) {
+    color.r += temperature * mfloat(0.1);
+    color.b -= temperature * mfloat(0.1);
+    return color;
+}
+
+mvec4 applyVibrance(mvec4 color, mfloat vibrance) {
+    mfloat lum = luminance(color.rgb);
+    mfloat maxComp = max(color.r, max(color.g, color.b));
+    mfloat minComp = min(color.r, min(color.g, color.b));
+    mfloat sat = maxComp - minComp;
+
+    color.rgb = mix(mvec3(lum), color.rgb, mfloat(1.0) + vibrance * (mfloat(1.0) - sat));
+    return color;
+}
+
+mvec4 applyBriCon(mvec4 color, mfloat brightness, mfloat contrast) {
+    color.rgb += brightness;
+    color.rgb = (mfloat(1.0) + contrast) * (color.rgb - mfloat(0.5)) + mfloat(0.5);
+    return color;
+}
+
+mvec4 applyLevels(mvec4 color, mfloat blacks, mfloat whites, mfloat mids) {
+    mfloat range = max(whites - blacks, mfloat(EPSILON));
+    color.rgb = (color.rgb - blacks) / range;
+    color.rgb = clamp(color.rgb, mfloat(0.0), mfloat(1.0));
+    color.rgb = pow(color.rgb, mvec3(mfloat(1.0) / mids));
+    return color;
+}
+
+mvec4 applyHueSat(mvec4 color, mfloat hue, mfloat saturation, mfloat brightness) {
+    mvec3 hsl = rgbToHsl(color.rgb);
+    hsl.x = fract(hsl.x + hue);
+    hsl.y = clamp(hsl.y + saturation, mfloat(0.0), mfloat(1.0));
+    hsl.z = clamp(hsl.z + brightness, mfloat(0.0), mfloat(1.0));
+
+    color.rgb = hslToRgb(hsl);
+    return color;
+}
+
+mvec4 applyColOffset(mvec4 color, mfloat redOffset, mfloat greenOffset, mfloat blueOffset) {
+    color.rgb += mvec3(redOffset, greenOffset, blueOffset);
+    return color;
+}
+
+// The falloff is computed in fp32, float16 pixel coordinates lose precision on large images
+mvec4 applyVignette(mvec4 color, uvec2 coord, vec2 size, float radius, float softness, float darkness) {
+    vec2 uv = coord / size;
+    vec2 centered = (uv - 0.5) * 2.0;
+    centered.x *= size.x / size.y;
+
+    float invRadius = 1.75 - radius * 1.75;
+    float dist = length(centered);
+    float vig = smoothstep(invRadius, invRadius + softness, dist);
+
+    mvec3 vigColor = darkness > 0.0 ? mvec3(0.0) : mvec3(1.0);
+    color.rgb = mix(color.rgb, vigColor, mfloat(vig * abs(darkness)));
+    return color;
+}
@@ -0,0 +1,48 @@
+// Statistics of an image, bound as set 1. Shaders that only read them
+// define STATS_ACCESS as readonly before including this file.
+// Must match ImageStatsLayout and GpuImageStats in src/vulkan/query/image_stats.hpp
+#define STATS_CHANNEL_COUNT 4
+#define STATS_LUMINANCE 3
+#define STATS_BIN_COUNT 256
+
+// Steps per unit of the fixed point sums
+#define STATS_SUM_SCALE 4096.0
+
+#ifndef STATS_ACCESS
+    #define STATS_ACCESS
+#endif
+
+layout(std430, set = 1, binding = 0) STATS_ACCESS buffer ImageStatsBuffer {
+    uint histogram[STATS_CHANNEL_COUNT * STATS_BIN_COUNT];
+
+    // Ordered bits, see floatToOrdered
+    uint minBits[STATS_CHANNEL_COUNT];
+    uint maxBits[STATS_CHANNEL_COUNT];
+
+    // 64-bit sums, the high word counts the wraparounds of the low one
+    uint sumLow[STATS_CHANNEL_COUNT];
+    uint sumHigh[STATS_CHANNEL_COUNT];
+
+    uint pixelCount;
+} stats;
+
+// Maps floats to uints of the same order, so atomicMin and atomicMax work on them
+uint floatToOrdered(float value) {
+    uint bits = floatBitsToUint(value);
+
+    return (bits & 0x80000000u) != 0u ? ~bits : bits | 0x80000000u;
+}
+
+float orderedToFloat(uint ordered) {
+    return uintBitsToFloat((ordered & 0x80000000u) != 0u ? ordered & 0x7FFFFFFFu : ~ordered);
+}
+
+uint statsBin(float value) {
+    return uint(clamp(value * float(STATS_BIN_COUNT - 1) + 0.5, 0.0, float(STATS_BIN_COUNT - 1)));
+}
+
+float statsMean(uint channel) {
+    float sum = float(stats.sumHigh[channel]) * 4294967296.0 + float(stats.sumLow[channel]);
+
+    return sum / STATS_SUM_SCALE / max(float(stats.pixelCount), 1.0);
+}
@@ -0,0 +1,61 @@
+// Workgroup-tiled neighborhood access for convolution-style effects.
+// Before including, declare `inImage` and define TILE_RADIUS, the farthest tap from the center pixel.
+// Each workgroup loads its pixels plus a TILE_RADIUS halo into shared memory once,
+// clamping reads past the image edges to the nearest edge pixel.
+#ifndef TILE_RADIUS
+    #error "TILE_RADIUS must be defined before including tile.glsl"
+#endif
+
+// Must match the 16x16 groups the chain recorder dispatches
+#define TILE_SIZE 16
+#define TILE_EXTENT (TILE_SIZE + 2 * TILE_RADIUS)
+#define TILE_TAPS ((2 * TILE_RADIUS + 1) * (2 * TILE_RADIUS + 1))
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE, local_size_z = 1) in;
+
+// Radii up to 8 fit the 16 KiB of shared memory every device provides
+shared vec4 tileTexels[TILE_EXTENT * TILE_EXTENT];
+
+ivec2 tilePixel() {
+    return ivec2(gl_GlobalInvocationID.xy);
+}
+
+// Partial groups at the right and bottom edges run past the image
+bool tileInBounds() {
+    return all(lessThan(tilePixel(), imageSize(inImage)));
+}
+
+// Every invocation must call this before returning, it contains a barrier
+void loadTile() {
+    ivec2 size = imageSize(inImage);
+    ivec2 origin = ivec2(gl_WorkGroupID.xy) * TILE_SIZE - TILE_RADIUS;
+
+    for (int i = int(gl_LocalInvocationIndex); i < TILE_EXTENT * TILE_EXTENT; i += TILE_SIZE * TILE_SIZE) {
+        ivec2 offset = ivec2(i % TILE_EXTENT, i / TILE_EXTENT);
+        ivec2 coord = clamp(origin + offset, ivec2(0), size - 1);
+
+        tileTexels[i] = imageLoad(inImage, coord);
+    }
+
+    barrier();
+}
+
+// `offset` is relative to the invocation's pixel, each component within [-TILE_RADIUS, TILE_RADIUS]
+vec4 tileFetch(ivec2 offset) {
+    ivec2 local = ivec2(gl_LocalInvocationID.xy) + TILE_RADIUS + offset;
+    return tileTexels[local.y * TILE_EXTENT + local.x];
+}
+
+// Weighs the square neighborhood row by row, top-left tap first
+vec4 tileConvolve(float weights[TILE_TAPS]) {
+    vec4 sum = vec4(0.0);
+
+    for (int y = -TILE_RADIUS; y <= TILE_RADIUS; y++) {
+        for (int x = -TILE_RADIUS; x <= TILE_RADIUS; x++) {
+            int tap = (y + TILE_RADIUS) * (2 * TILE_RADIUS + 1) + (x + TILE_RADIUS);
+            sum += tileFetch(ivec2(x, y)) * weights[tap];
+        }
+    }
+
+    return sum;
+}
@@ -0,0 +1,20 @@
+#version 460 core
+
+#include "format.glsl"
+
+layout(set = 0, binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+layout(set = 0, binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
+
+layout(set = 1, binding = 0) uniform sampler3D lut;
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+void main() {
+    vec4 color = imageLoad(inImage, ivec2(gl_GlobalInvocationID.xy));
+
+    // Remap so 0 and 1 land on the centers of the outer lattice texels
+    float size = float(textureSize(lut, 0).x);
+    vec3 coord = color.rgb * ((size - 1.0) / size) + 0.5 / size;
+
+    imageStore(outImage, ivec2(gl_GlobalInvocationID.xy), vec4(textureLod(lut, coord, 0.0).rgb, color.a));
+}
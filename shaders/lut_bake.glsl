@@ -0,0 +1,36 @@
+#version 460 core
+
+#include "format.glsl"
+#include "ops.glsl"
+
+layout(set = 0, binding = 0, rgba16f) uniform writeonly image3D lut;
+
+layout(set = 0, binding = 1, std430) readonly buffer Ops {
+    FusedOp ops[];
+};
+
+layout(push_constant) uniform pc {
+    uint opCount;
+};
+
+layout(local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+
+void main() {
+    ivec3 coord = ivec3(gl_GlobalInvocationID.xyz);
+    ivec3 size = imageSize(lut);
+
+    if (any(greaterThanEqual(coord, size))) {
+        return;
+    }
+
+    // Lattice points span [0, 1] inclusive on every axis
+    vec4 color = vec4(vec3(coord) / vec3(size - 1), 1.0);
+
+    // Color-only ops never read the coordinate
+    for (uint i = 0u; i < opCount; i++) {
+        color = applyOp(ops[i], color, uvec2(0u), vec2(1.0));
+        color = clamp(color, 0.0, 1.0);
+    }
+
+    imageStore(lut, coord, vec4(color.rgb, 1.0));
+}
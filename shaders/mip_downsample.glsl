@@ -0,0 +1,157 @@
+#version 460 core
+
+#include "format.glsl"
+
+// Must match gMipMaxLevels in src/vulkan/chain_context.cpp, less the full resolution level
+#define MAX_MIP_LEVELS 12
+// Levels each workgroup reduces its 64x64 tile into, down to a single pixel
+#define TILE_LEVELS 6
+
+layout(set = 0, binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+// Levels 1 and up. Tile levels are read back by the last workgroup, so writes must bypass incoherent caches.
+layout(set = 0, binding = 1, WORKING_FORMAT) uniform coherent image2D outMips[MAX_MIP_LEVELS];
+// Zeroed before every dispatch
+layout(set = 0, binding = 2) coherent buffer MipCounter {
+    uint finishedGroups;
+};
+
+layout(push_constant) uniform pc {
+    // Levels below the full resolution one, at most MAX_MIP_LEVELS
+    int mipCount;
+};
+
+layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+shared vec4 sTile[16][16];
+shared bool sLastGroup;
+
+// Arrays of storage images can only be indexed by constants without shaderStorageImageArrayDynamicIndexing
+#define MIP_LOAD_CASE(i) case i: return imageLoad(outMips[i - 1], pixel);
+#define MIP_STORE_CASE(i) case i: imageStore(outMips[i - 1], pixel, color); break;
+
+vec4 loadMip(int level, ivec2 pixel) {
+    switch (level) {
+        MIP_LOAD_CASE(1) MIP_LOAD_CASE(2) MIP_LOAD_CASE(3) MIP_LOAD_CASE(4)
+        MIP_LOAD_CASE(5) MIP_LOAD_CASE(6) MIP_LOAD_CASE(7) MIP_LOAD_CASE(8)
+        MIP_LOAD_CASE(9) MIP_LOAD_CASE(10) MIP_LOAD_CASE(11) MIP_LOAD_CASE(12)
+    }
+
+    return vec4(0.0);
+}
+
+void storeMip(int level, ivec2 pixel, vec4 color) {
+    switch (level) {
+        MIP_STORE_CASE(1) MIP_STORE_CASE(2) MIP_STORE_CASE(3) MIP_STORE_CASE(4)
+        MIP_STORE_CASE(5) MIP_STORE_CASE(6) MIP_STORE_CASE(7) MIP_STORE_CASE(8)
+        MIP_STORE_CASE(9) MIP_STORE_CASE(10) MIP_STORE_CASE(11) MIP_STORE_CASE(12)
+    }
+}
+
+ivec2 mipSize(int level) {
+    return max(imageSize(inImage) >> level, ivec2(1));
+}
+
+void storeTileMip(int level, ivec2 pixel, vec4 color) {
+    if (all(lessThan(pixel, mipSize(level)))) {
+        storeMip(level, pixel, color);
+    }
+}
+
+// Odd edges repeat their last row or column
+vec4 loadSource(ivec2 pixel) {
+    return imageLoad(inImage, min(pixel, imageSize(inImage) - 1));
+}
+
+// Single-pass downsample: every workgroup halves its tile of the full resolution image six times,
+// and the workgroup finishing last reduces the remaining levels from level 6
+void main() {
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+    ivec2 group = ivec2(gl_WorkGroupID.xy);
+
+    // Each invocation owns a 2x2 block of level 1 and its level 2 pixel
+    ivec2 level1 = group * 32 + local * 2;
+    vec4 level2 = vec4(0.0);
+
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            ivec2 pixel = level1 + ivec2(x, y);
+            ivec2 source = pixel * 2;
+
+            vec4 color = 0.25 * (loadSource(source) + loadSource(source + ivec2(1, 0))
+                + loadSource(source + ivec2(0, 1)) + loadSource(source + ivec2(1, 1)));
+
+            storeTileMip(1, pixel, color);
+            level2 += 0.25 * color;
+        }
+    }
+
+    if (mipCount >= 2) {
+        storeTileMip(2, group * 16 + local, level2);
+    }
+
+    sTile[local.y][local.x] = level2;
+
+    int tileSize = 8;
+
+    for (int level = 3; level <= min(TILE_LEVELS, mipCount); level++) {
+        barrier();
+
+        bool active = all(lessThan(local, ivec2(tileSize)));
+        ivec2 source = local * 2;
+        vec4 color = vec4(0.0);
+
+        if (active) {
+            color = 0.25 * (sTile[source.y][source.x] + sTile[source.y][source.x + 1]
+                + sTile[source.y + 1][source.x] + sTile[source.y + 1][source.x + 1]);
+        }
+
+        // Every read of the previous level finishes before it is overwritten
+        barrier();
+
+        if (active) {
+            sTile[local.y][local.x] = color;
+            storeTileMip(level, group * tileSize + local, color);
+        }
+
+        tileSize /= 2;
+    }
+
+    if (mipCount <= TILE_LEVELS) {
+        return;
+    }
+
+    // The level 6 pixel of this workgroup is visible before the counter says so
+    memoryBarrierImage();
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0U) {
+        uint groupCount = gl_NumWorkGroups.x * gl_NumWorkGroups.y;
+        sLastGroup = atomicAdd(finishedGroups, 1U) == groupCount - 1U;
+    }
+
+    barrier();
+
+    if (!sLastGroup) {
+        return;
+    }
+
+    for (int level = TILE_LEVELS + 1; level <= mipCount; level++) {
+        ivec2 size = mipSize(level);
+        ivec2 maxSource = mipSize(level - 1) - 1;
+
+        for (int i = int(gl_LocalInvocationIndex); i < size.x * size.y; i += 256) {
+            ivec2 pixel = ivec2(i % size.x, i / size.x);
+            ivec2 source = pixel * 2;
+
+            vec4 color = loadMip(level - 1, min(source, maxSource))
+                + loadMip(level - 1, min(source + ivec2(1, 0), maxSource))
+                + loadMip(level - 1, min(source + ivec2(0, 1), maxSource))
+                + loadMip(level - 1, min(source + ivec2(1, 1), maxSource));
+
+            storeMip(level, pixel, color * 0.25);
+        }
+
+        memoryBarrierImage();
+        barrier();
+    }
+}
@@ -1,7 +1,9 @@
 #version 460 core
 
+#include "format.glsl"
+
 layout(binding = 0) uniform sampler2D inImage;
-layout(binding = 1, rgba8) uniform writeonly image2D outImage;
+layout(binding = 1, WORKING_FORMAT) uniform writeonly image2D outImage;
 
 layout(local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
 
@@ -0,0 +1,131 @@
+#version 460 core
+
+// STATS_SHARED_ATOMICS builds the variant for devices without subgroup arithmetic
+#ifndef STATS_SHARED_ATOMICS
+    #extension GL_KHR_shader_subgroup_basic : require
+    #extension GL_KHR_shader_subgroup_arithmetic : require
+#endif
+
+#include "format.glsl"
+
+layout(set = 0, binding = 0, WORKING_FORMAT) uniform readonly image2D inImage;
+
+#include "color.glsl"
+#include "stats.glsl"
+
+// Each invocation reads a block of pixels, strided by the workgroup size so neighbors read neighbors
+#define STATS_BLOCK 4
+#define GROUP_SIZE 16
+
+// Sums clamp every value to [0, STATS_SUM_MAX], which keeps the sum of a workgroup within 32 bits
+#define STATS_SUM_MAX 64.0
+
+layout(local_size_x = GROUP_SIZE, local_size_y = GROUP_SIZE, local_size_z = 1) in;
+
+shared uint localHistogram[STATS_CHANNEL_COUNT * STATS_BIN_COUNT];
+shared uint localMin[STATS_CHANNEL_COUNT];
+shared uint localMax[STATS_CHANNEL_COUNT];
+shared uint localSum[STATS_CHANNEL_COUNT];
+shared uint localCount;
+
+void addToSum(uint channel, uint value) {
+    uint previous = atomicAdd(stats.sumLow[channel], value);
+
+    // The low word wrapped around
+    if (previous + value < previous) {
+        atomicAdd(stats.sumHigh[channel], 1u);
+    }
+}
+
+// Histogram, min, max and mean per channel. Invocations reduce through subgroup operations, where
+// available, and shared atomics first, so the buffer only sees a few atomics per workgroup.
+void main() {
+    uint index = gl_LocalInvocationIndex;
+    uint groupInvocations = GROUP_SIZE * GROUP_SIZE;
+
+    for (uint i = index; i < STATS_CHANNEL_COUNT * STATS_BIN_COUNT; i += groupInvocations) {
+        localHistogram[i] = 0u;
+    }
+
+    if (index < STATS_CHANNEL_COUNT) {
+        localMin[index] = 0xFFFFFFFFu;
+        localMax[index] = 0u;
+        localSum[index] = 0u;
+    }
+
+    if (index == 0u) {
+        localCount = 0u;
+    }
+
+    barrier();
+
+    ivec2 size = imageSize(inImage);
+    ivec2 base = ivec2(gl_WorkGroupID.xy) * (GROUP_SIZE * STATS_BLOCK) + ivec2(gl_LocalInvocationID.xy);
+
+    vec4 minValue = vec4(uintBitsToFloat(0x7F800000u));
+    vec4 maxValue = -minValue;
+    vec4 sum = vec4(0.0);
+    uint count = 0u;
+
+    for (int y = 0; y < STATS_BLOCK; y++) {
+        for (int x = 0; x < STATS_BLOCK; x++) {
+            ivec2 pixel = base + ivec2(x, y) * GROUP_SIZE;
+
+            if (any(greaterThanEqual(pixel, size))) {
+                continue;
+            }
+
+            vec3 color = imageLoad(inImage, pixel).rgb;
+            vec4 values = vec4(color, luminance(color));
+
+            for (uint channel = 0u; channel < STATS_CHANNEL_COUNT; channel++) {
+                atomicAdd(localHistogram[channel * STATS_BIN_COUNT + statsBin(values[channel])], 1u);
+            }
+
+            minValue = min(minValue, values);
+            maxValue = max(maxValue, values);
+            sum += clamp(values, 0.0, STATS_SUM_MAX);
+            count++;
+        }
+    }
+
+#ifdef STATS_SHARED_ATOMICS
+    // Every invocation adds its own block to the shared values
+    bool leader = true;
+#else
+    minValue = subgroupMin(minValue);
+    maxValue = subgroupMax(maxValue);
+    sum = subgroupAdd(sum);
+    count = subgroupAdd(count);
+
+    bool leader = subgroupElect();
+#endif
+
+    if (leader) {
+        for (uint channel = 0u; channel < STATS_CHANNEL_COUNT; channel++) {
+            atomicMin(localMin[channel], floatToOrdered(minValue[channel]));
+            atomicMax(localMax[channel], floatToOrdered(maxValue[channel]));
+            atomicAdd(localSum[channel], uint(sum[channel] * STATS_SUM_SCALE));
+        }
+
+        atomicAdd(localCount, count);
+    }
+
+    barrier();
+
+    for (uint i = index; i < STATS_CHANNEL_COUNT * STATS_BIN_COUNT; i += groupInvocations) {
+        if (localHistogram[i] != 0u) {
+            atomicAdd(stats.histogram[i], localHistogram[i]);
+        }
+    }
+
+    if (index < STATS_CHANNEL_COUNT) {
+        atomicMin(stats.minBits[index], localMin[index]);
+        atomicMax(stats.maxBits[index], localMax[index]);
+        addToSum(index, localSum[index]);
+    }
+
+    if (index == 0u) {
+        atomicAdd(stats.pixelCount, localCount);
+    }
+}
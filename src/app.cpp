@@ -1,24 +1,10 @@
 #include "app.hpp"
 
-#if DEBUG
-    static const bool gEnableValidationLayers  = true;
-#else
-    static const bool gEnableValidationLayers  = false;
-#endif
-
-static const std::vector<const char*> gDeviceExtensions = {
-#ifdef __APPLE__
-    "VK_KHR_portability_subset",
-#endif
-
-    VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-};
-
-static const std::vector<const char*> gValidationLayers = {
-    "VK_LAYER_KHRONOS_validation",
-};
+#include <frontend.hpp>
 
 static const uint32_t gMaxFramesInFlight = 2;
+static const vk::DeviceSize gStageCacheBudget = 512ULL * 1024ULL * 1024ULL;
+static const vk::DeviceSize gStagingSize = 64ULL * 1024ULL * 1024ULL;
 
 static const std::vector<Vertex> gVertices = {
     {{ -1.0f, -1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f }},
@@ -31,9 +17,11 @@ static const std::vector<uint32_t> gIndices = {
     0, 1, 2, 2, 3, 0,
 };
 
-App::App()
+App::App(const AppConfig& config)
     : mWindow{ WindowConfig{} }
 {
+    mAppData.workingFormat = config.workingFormat;
+
     _createWindow();
     _initVulkan();
 }
@@ -77,12 +65,17 @@ void App::_initVulkan()
 
         .enableValidationLayers = gEnableValidationLayers,
         .validationLayers = gValidationLayers,
-        .deviceExtensions = gDeviceExtensions,
+        .deviceExtensions = gWindowDeviceExtensions,
 
         .vertices = gVertices,
         .indices = gIndices,
 
         .framesInFlight = gMaxFramesInFlight,
+        .stageCacheBudget = gStageCacheBudget,
+        .stagingSize = gStagingSize,
+        .lutSize = gLutSize,
+        .workingFormat = mAppData.workingFormat,
+        .useAsyncCompute = true,
 
         .window = mWindow,
     };
@@ -6,10 +6,16 @@
 #include <window.hpp>
 #include <vulkan/renderer.hpp>
 
+struct AppConfig
+{
+    // Half floats keep chains free of 8-bit banding at twice the bandwidth of RGBA8
+    WorkingFormat workingFormat = WorkingFormat::Rgba16f;
+};
+
 class App
 {
 public:
-    App();
+    explicit App(const AppConfig& config);
 
     void run();
 private:
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <effect/registry.hpp>
 #include <effect/instance.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/memory/allocator.hpp>
+#include <vulkan/query/gpu_profiler.hpp>
+#include <vulkan/query/image_stats.hpp>
 
 struct AppData
 {
@@ -12,6 +20,25 @@ struct AppData
 
     float mix = 1.0f;
 
+    // Fixed at startup
+    WorkingFormat workingFormat = WorkingFormat::Rgba16f;
+
+    // Evaluate runs of color effects through a baked 3D LUT, see canBakeLut
+    bool useLut = false;
+
+    // Set by the UI, consumed by the renderer on the next frame
+    std::optional<std::filesystem::path> pendingLutExport;
+    std::optional<std::filesystem::path> pendingImageExport;
+
+    // Refreshed by the renderer every frame
+    MemoryStats memoryStats;
+    // Lags a few frames behind, see GpuProfiler
+    std::vector<GpuTimingStats> gpuTimings;
+    // Ids of effects whose pipeline is still compiling, they are passed through meanwhile
+    std::unordered_set<std::string> pendingEffects;
+    // Of the last chain result, a few frames behind it. Kept while the chain is unchanged.
+    std::optional<ImageStats> imageStats;
+
     void addEffect(const Effect* effect);
     void deleteEffect(const size_t index);
     void moveUpEffect(const size_t index);
@@ -0,0 +1,343 @@
+#include "batch_processor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include <io/image.hpp>
+#include <trace/trace.hpp>
+#include <vulkan/device.hpp>
+#include <vulkan/buffer/commandbuffer.hpp>
+
+BatchProcessor::BatchProcessor(const BatchProcessorConfig& config)
+    : mRenderer{ config.renderer }
+    , mChain{ config.chain }
+    , mPool{ config.workerCount }
+{
+    const auto& device = mRenderer.getDevice();
+
+    mDecodeAlignment = device.isHostImportSupported()
+        ? static_cast<size_t>(device.getHostImportAlignment())
+        : alignof(std::max_align_t);
+    auto commandBuffers = createCommandBuffers(device.getVkHandle(), mRenderer.getCommandPool().getVkHandle(), config.imagesInFlight);
+
+    mSlots.reserve(config.imagesInFlight);
+
+    for (auto& commandBuffer : commandBuffers) {
+        mSlots.push_back(Slot{
+            .commandBuffer = std::move(commandBuffer),
+            .fence = Fence{ device, FenceConfig{ .signaled = false } },
+            .fusedOpBuffer = mRenderer.getChainContext().createFusedOpBuffer(),
+        });
+    }
+}
+
+BatchProcessor::~BatchProcessor()
+{
+    // Slots may still be in flight when run() was left through an exception
+    mRenderer.getDevice().getVkHandle().waitIdle();
+}
+
+BatchStats BatchProcessor::run(const std::vector<BatchJob>& jobs)
+{
+    mStats = BatchStats{};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Decoding runs ahead of the GPU by a bounded number of images to cap memory use
+    const size_t decodeAhead = mPool.getThreadCount() + mSlots.size();
+
+    std::deque<std::future<DecodedImage>> decodes;
+    size_t nextDecode = 0U;
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        while (nextDecode < jobs.size() && decodes.size() < decodeAhead) {
+            auto path = jobs[nextDecode++].input;
+            decodes.push_back(mPool.submit([path, alignment = mDecodeAlignment] { return _decode(path, alignment); }));
+        }
+
+        auto decode = std::move(decodes.front());
+        decodes.pop_front();
+
+        // The slot is reused round-robin, so its previous image is the oldest one in flight
+        auto& slot = mSlots[i % mSlots.size()];
+        _retire(slot, jobs);
+
+        try {
+            _submit(slot, i, decode.get(), jobs);
+        }
+        catch (const std::exception& e) {
+            std::cerr << jobs[i].input.string() << ": " << e.what() << "\n";
+            mStats.failed++;
+        }
+    }
+
+    for (auto& slot : mSlots) {
+        _retire(slot, jobs);
+    }
+
+    _waitForEncodes(0U);
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    mStats.seconds = std::chrono::duration<double>(elapsed).count();
+    mStats.imagesPerSecond = mStats.seconds > 0.0 ? static_cast<double>(mStats.processed) / mStats.seconds : 0.0;
+
+    return mStats;
+}
+
+void BatchProcessor::_prepareSlot(Slot& slot, vk::Extent2D extent)
+{
+    if (slot.source.has_value() && slot.extent == extent) {
+        return;
+    }
+
+    // Descriptor sets reference the images, so they go first
+    slot.descriptors.reset();
+    slot.images.reset();
+    slot.source.reset();
+
+    const auto& device = mRenderer.getDevice();
+    const auto& commandPool = mRenderer.getCommandPool();
+
+    SampledImageConfig sourceConfig = {
+        .commandPool = commandPool,
+        .width = extent.width,
+        .height = extent.height,
+    };
+
+    slot.source.emplace(device, sourceConfig);
+
+    ComputeImageConfig pingPongConfig = {
+        .commandPool = commandPool,
+        .width = extent.width,
+        .height = extent.height,
+        .format = mRenderer.getWorkingFormat(),
+    };
+
+    slot.images.emplace(
+        slot.source.value(),
+        TextureImage{ device, pingPongConfig },
+        TextureImage{ device, pingPongConfig }
+    );
+
+    slot.descriptors.emplace(mRenderer.getChainContext().createDescriptors(slot.images.value(), mRenderer.getSampler(), slot.fusedOpBuffer));
+    slot.extent = extent;
+}
+
+void BatchProcessor::_submit(Slot& slot, size_t jobIndex, DecodedImage image, const std::vector<BatchJob>& jobs)
+{
+    _prepareSlot(slot, vk::Extent2D{ image.width, image.height });
+
+    vk::Buffer uploadSource{};
+    vk::DeviceSize uploadOffset = 0U;
+
+    // Importing skips the copy into the staging ring, which is only used when the driver refuses it
+    slot.hostImport = HostImportBuffer::tryImport(mRenderer.getDevice(), image.pixels);
+
+    if (slot.hostImport.has_value()) {
+        uploadSource = slot.hostImport->getVkHandle();
+        slot.hostPixels.emplace(std::move(image.pixels));
+    }
+    else {
+        const auto staging = _stage(image, jobs);
+
+        uploadSource = mStagingArena->getBuffer().getVkHandle();
+        uploadOffset = staging.offset;
+    }
+
+    auto buffer = slot.commandBuffer.get();
+    buffer.reset();
+
+    vk::CommandBufferBeginInfo beginInfo{};
+    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+    buffer.begin(beginInfo);
+
+    slot.source->recordUpload(buffer, uploadSource, uploadOffset);
+
+    // Retiring this slot waited for the frame submitted a full round of slots ago, and every one before it
+    const auto frame = mRenderer.nextFrame();
+    const auto completedFrame = frame > mSlots.size() ? frame - mSlots.size() : 0U;
+
+    auto& recorder = mRenderer.getChainContext().getChainRecorder();
+    recorder.beginFrame(frame, completedFrame);
+
+    auto& images = slot.images.value();
+    bool resultInPong = recorder.record(buffer, mChain, images, slot.descriptors.value(), slot.fusedOpBuffer);
+
+    const auto& resultImage = resultInPong ? images.pong : images.ping;
+    auto ticket = _recordReadback(buffer, resultImage, jobs);
+
+    // The copy never runs unless the submission goes through, so its ring space is given back
+    try {
+        buffer.end();
+
+        slot.fence.reset();
+
+        vk::CommandBufferSubmitInfo commandBufferInfo{};
+        commandBufferInfo.setCommandBuffer(buffer);
+
+        std::vector signalInfos{ mReadbackRing->takeSignal() };
+
+        if (mStagingArena.has_value() && mStagingArena->hasUncommitted()) {
+            signalInfos.push_back(mStagingArena->takeSignal());
+        }
+
+        vk::SubmitInfo2 submitInfo{};
+        submitInfo.setCommandBufferInfos(commandBufferInfo);
+        submitInfo.setSignalSemaphoreInfos(signalInfos);
+
+        mRenderer.getDevice().getComputeQueue().submit2(submitInfo, slot.fence.getVkHandle());
+    }
+    catch (...) {
+        mReadbackRing->release(ticket);
+        throw;
+    }
+
+    slot.jobIndex = jobIndex;
+    slot.ticket = ticket;
+}
+
+void BatchProcessor::_retire(Slot& slot, const std::vector<BatchJob>& jobs)
+{
+    if (!slot.jobIndex.has_value()) {
+        return;
+    }
+
+    // The fence also guards reuse of the slot's command buffer and images
+    slot.fence.wait();
+
+    // The imported buffer goes before the host memory it wraps
+    slot.hostImport.reset();
+    slot.hostPixels.reset();
+
+    const auto ticket = slot.ticket.value();
+    const auto* data = mReadbackRing->getData(ticket);
+
+    std::vector<uint8_t> texels(data, data + ticket.size);
+
+    mReadbackRing->release(ticket);
+    slot.ticket.reset();
+
+    auto path = jobs[slot.jobIndex.value()].output;
+    slot.jobIndex.reset();
+
+    // Bound the finished images waiting on the encoder the same way as the decoded ones
+    _waitForEncodes(mPool.getThreadCount() + mSlots.size());
+
+    mEncodes.push_back(mPool.submit([path, ticket, texels = std::move(texels)]() {
+        _encode(path, ticket, texels);
+    }));
+}
+
+StagingRange BatchProcessor::_stage(const DecodedImage& image, const std::vector<BatchJob>& jobs)
+{
+    const vk::DeviceSize size = image.pixels.getSize();
+    const vk::DeviceSize arenaSize = size * (mSlots.size() + 1U);
+
+    if (!mStagingArena.has_value()) {
+        mStagingArena.emplace(mRenderer.getDevice(), StagingArenaConfig{ .commandPool = mRenderer.getCommandPool(), .size = arenaSize });
+    }
+
+    auto range = mStagingArena->allocate(size);
+
+    if (!range.has_value()) {
+        for (auto& slot : mSlots) {
+            _retire(slot, jobs);
+        }
+
+        mStagingArena->wait();
+        range = mStagingArena->allocate(size);
+    }
+
+    // Nothing is in flight at this point, so the arena can be replaced by a larger one
+    if (!range.has_value()) {
+        mStagingArena.emplace(mRenderer.getDevice(), StagingArenaConfig{ .commandPool = mRenderer.getCommandPool(), .size = arenaSize });
+        range = mStagingArena->allocate(size);
+    }
+
+    std::memcpy(range->data, image.pixels.getData(), image.pixels.getSize());
+
+    return range.value();
+}
+
+ReadbackTicket BatchProcessor::_recordReadback(vk::CommandBuffer buffer, const TextureImage& image, const std::vector<BatchJob>& jobs)
+{
+    // One spare image absorbs the space skipped when a copy would wrap around
+    const vk::DeviceSize ringSize = vk::DeviceSize{ image.getWidth() } * image.getHeight() * image.getPixelSize() * (mSlots.size() + 1U);
+
+    if (!mReadbackRing.has_value()) {
+        mReadbackRing.emplace(mRenderer.getDevice(), ReadbackRingConfig{ .commandPool = mRenderer.getCommandPool(), .size = ringSize });
+    }
+
+    if (auto ticket = mReadbackRing->record(buffer, image)) {
+        return ticket.value();
+    }
+
+    for (auto& slot : mSlots) {
+        _retire(slot, jobs);
+    }
+
+    if (auto ticket = mReadbackRing->record(buffer, image)) {
+        return ticket.value();
+    }
+
+    // Every ticket is released at this point, so the ring can be replaced by a larger one
+    mReadbackRing.emplace(mRenderer.getDevice(), ReadbackRingConfig{ .commandPool = mRenderer.getCommandPool(), .size = ringSize });
+
+    return mReadbackRing->record(buffer, image).value();
+}
+
+void BatchProcessor::_waitForEncodes(size_t maxPending)
+{
+    while (mEncodes.size() > maxPending) {
+        auto encode = std::move(mEncodes.front());
+        mEncodes.pop_front();
+
+        try {
+            encode.get();
+            mStats.processed++;
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            mStats.failed++;
+        }
+    }
+}
+
+DecodedImage BatchProcessor::_decode(const std::filesystem::path& path, size_t alignment)
+{
+    TRACE_SCOPE("Decode image");
+
+    auto image = Image{ path };
+    auto loadedImage = image.load();
+
+    if (loadedImage.pixels == nullptr) {
+        throw std::runtime_error("Failed to load image " + path.string() + ".");
+    }
+
+    const auto width = static_cast<uint32_t>(loadedImage.texWidth);
+    const auto height = static_cast<uint32_t>(loadedImage.texHeight);
+    const size_t size = size_t{ width } * height * 4U;
+
+    // Replaces the copy into a vector, so an imported image reaches the device without another one
+    HostAllocation pixels{ size, alignment };
+    std::memcpy(pixels.getData(), loadedImage.pixels, size);
+
+    return DecodedImage{
+        .width = width,
+        .height = height,
+        .pixels = std::move(pixels),
+    };
+}
+
+void BatchProcessor::_encode(const std::filesystem::path& path, const ReadbackTicket& ticket, const std::vector<uint8_t>& texels)
+{
+    TRACE_SCOPE("Encode image");
+
+    const auto pixels = encodeReadbackToSrgb(texels.data(), size_t{ ticket.width } * ticket.height, ticket.format);
+    Image::save(path, ticket.width, ticket.height, pixels);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <vector>
+
+#include <effect/chain.hpp>
+#include <util/thread_pool.hpp>
+#include <vulkan/headless_renderer.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/chain_recorder.hpp>
+#include <vulkan/buffer/readback_ring.hpp>
+#include <vulkan/buffer/staging_arena.hpp>
+#include <vulkan/buffer/texture.hpp>
+#include <vulkan/memory/host_import.hpp>
+#include <vulkan/sync/fence.hpp>
+
+struct BatchJob
+{
+    std::filesystem::path input;
+    std::filesystem::path output;
+};
+
+struct BatchProcessorConfig
+{
+    HeadlessRenderer& renderer;
+
+    const EffectChain& chain;
+
+    // GPU submissions in flight, must not exceed HeadlessRendererConfig::maxImagesInFlight
+    uint32_t imagesInFlight;
+
+    // Decode and encode workers
+    uint32_t workerCount;
+};
+
+// Decoded sRGB pixels, aligned so the device can read them in place
+struct DecodedImage
+{
+    uint32_t width;
+    uint32_t height;
+
+    HostAllocation pixels;
+};
+
+struct BatchStats
+{
+    size_t processed = 0U;
+    size_t failed = 0U;
+
+    double seconds = 0.0;
+    double imagesPerSecond = 0.0;
+};
+
+// Applies one chain to many images. Decoding and encoding run on a thread pool,
+// while each image in flight owns a slot with its own staging, images and fence,
+// so upload, compute and readback of one image overlap with the others.
+// Sources are imported in place when the device supports it and staged otherwise,
+// and both staging and readback go through rings shared by all slots.
+class BatchProcessor
+{
+public:
+    explicit BatchProcessor(const BatchProcessorConfig& config);
+    ~BatchProcessor();
+
+    BatchStats run(const std::vector<BatchJob>& jobs);
+private:
+    struct Slot
+    {
+        vk::UniqueCommandBuffer commandBuffer;
+        Fence fence;
+        Buffer fusedOpBuffer;
+
+        // Sized for the last image, recreated when the next one differs
+        vk::Extent2D extent{};
+        std::optional<TextureImage> source;
+
+        // Decoded pixels imported as the upload source, kept until the slot is retired
+        std::optional<HostImportBuffer> hostImport;
+        std::optional<HostAllocation> hostPixels;
+        std::optional<RenderImageSet> images;
+        std::optional<ComputeDescriptorSet> descriptors;
+
+        // Job whose readback is pending
+        std::optional<size_t> jobIndex;
+        std::optional<ReadbackTicket> ticket;
+    };
+
+    void _prepareSlot(Slot& slot, vk::Extent2D extent);
+    void _submit(Slot& slot, size_t jobIndex, DecodedImage image, const std::vector<BatchJob>& jobs);
+    void _retire(Slot& slot, const std::vector<BatchJob>& jobs);
+
+    // Both retire the other slots, or grow their ring, when it has no room for the image
+    StagingRange _stage(const DecodedImage& image, const std::vector<BatchJob>& jobs);
+    ReadbackTicket _recordReadback(vk::CommandBuffer buffer, const TextureImage& image, const std::vector<BatchJob>& jobs);
+
+    void _waitForEncodes(size_t maxPending);
+
+    static DecodedImage _decode(const std::filesystem::path& path, size_t alignment);
+    // Encodes the linear texels of a retired readback to an sRGB file
+    static void _encode(const std::filesystem::path& path, const ReadbackTicket& ticket, const std::vector<uint8_t>& texels);
+
+    HeadlessRenderer& mRenderer;
+    const EffectChain& mChain;
+
+    ThreadPool mPool;
+
+    // Slots are never moved once created, their images are referenced by descriptor sets
+    std::vector<Slot> mSlots;
+
+    // Of decoded pixels, the import alignment when the device can import host memory
+    size_t mDecodeAlignment;
+
+    // Created for the first image, sized for every slot
+    std::optional<StagingArena> mStagingArena;
+    std::optional<ReadbackRing> mReadbackRing;
+
+    std::deque<std::future<void>> mEncodes;
+    BatchStats mStats;
+};
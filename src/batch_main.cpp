@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <frontend.hpp>
+#include <batch/batch_processor.hpp>
+#include <effect/chain.hpp>
+#include <effect/registry.hpp>
+#include <effect/spec.hpp>
+#include <trace/trace.hpp>
+#include <vulkan/headless_renderer.hpp>
+
+static const uint32_t gDefaultImagesInFlight = 3U;
+
+static const std::vector<std::string_view> gInputExtensions = { ".png", ".jpg", ".jpeg", ".bmp", ".tga" };
+
+struct BatchArgs
+{
+    std::string_view chain;
+    std::filesystem::path inputDir;
+    std::filesystem::path outputDir;
+
+    std::string format = "png";
+    bool useLut = false;
+
+    WorkingFormat workingFormat = WorkingFormat::Rgba16f;
+
+    uint32_t imagesInFlight = gDefaultImagesInFlight;
+    uint32_t workerCount = std::max(1U, std::thread::hardware_concurrency());
+
+    // Chrome trace JSON of the run, only written when built with VKIMG2D_TRACE
+    std::filesystem::path tracePath;
+};
+
+static void _printUsage()
+{
+    std::cerr
+        << "Usage: vkimg2d-batch [options] <chain> <input-dir> <output-dir>\n"
+        << "  <chain>            effects separated by '|', e.g. \"exposure:eexposure=0.5|sharpen\"\n"
+        << "  --format <ext>     output format: png, jpg, bmp or tga (default png)\n"
+        << "  --lut              bake runs of color effects into a 3D LUT, rgba8 only\n"
+        << "  --working <fmt>    chain image format: rgba8, rgba16f or rgba32f (default rgba16f)\n"
+        << "  --in-flight <n>    images on the GPU at once (default 3)\n"
+        << "  --jobs <n>         decode and encode threads (default: hardware threads)\n"
+        << "  --trace <file>     write a CPU trace of the run (builds with VKIMG2D_TRACE only)\n";
+}
+
+static BatchArgs _parseArgs(const std::vector<std::string_view>& args)
+{
+    BatchArgs result;
+    std::vector<std::string_view> positional;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const auto arg = args[i];
+        const bool hasValue = i + 1U < args.size();
+
+        if (arg == "--lut") {
+            result.useLut = true;
+        }
+        else if (arg == "--format" && hasValue) {
+            result.format = std::string{ args[++i] };
+        }
+        else if (arg == "--working" && hasValue) {
+            const auto name = args[++i];
+            const auto format = parseWorkingFormat(name);
+
+            if (!format.has_value()) {
+                throw std::runtime_error("Unknown working format " + std::string{ name } + ".");
+            }
+
+            result.workingFormat = format.value();
+        }
+        else if (arg == "--in-flight" && hasValue) {
+            result.imagesInFlight = parseCount(args[++i]);
+        }
+        else if (arg == "--jobs" && hasValue) {
+            result.workerCount = parseCount(args[++i]);
+        }
+        else if (arg == "--trace" && hasValue) {
+            result.tracePath = args[++i];
+        }
+        else if (arg.starts_with("--")) {
+            throw std::runtime_error("Unknown option " + std::string{ arg } + ".");
+        }
+        else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 3U) {
+        throw std::runtime_error("Expected a chain, an input directory and an output directory.");
+    }
+
+    if (result.useLut && !canBakeLut(result.workingFormat)) {
+        throw std::runtime_error("--lut requires --working rgba8, LUTs clamp every effect to [0, 1].");
+    }
+
+    result.chain = positional[0];
+    result.inputDir = positional[1];
+    result.outputDir = positional[2];
+
+    return result;
+}
+
+static std::vector<BatchJob> _collectJobs(const BatchArgs& args)
+{
+    if (!std::filesystem::is_directory(args.inputDir)) {
+        throw std::runtime_error("Input directory " + args.inputDir.string() + " does not exist.");
+    }
+
+    std::vector<BatchJob> jobs;
+
+    for (const auto& entry : std::filesystem::directory_iterator{ args.inputDir }) {
+        if (!entry.is_regular_file()) continue;
+
+        auto extension = entry.path().extension().string();
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (std::ranges::find(gInputExtensions, extension) == gInputExtensions.end()) continue;
+
+        auto output = args.outputDir / entry.path().stem();
+        output += "." + args.format;
+
+        jobs.push_back(BatchJob{ .input = entry.path(), .output = output });
+    }
+
+    // Deterministic order, directory iteration order is unspecified
+    std::ranges::sort(jobs, {}, &BatchJob::input);
+
+    // Inputs differing only by extension would be encoded to the same file concurrently
+    std::map<std::filesystem::path, std::filesystem::path> inputsByOutput;
+
+    for (const auto& job : jobs) {
+        const auto [existing, inserted] = inputsByOutput.emplace(job.output, job.input);
+
+        if (!inserted) {
+            throw std::runtime_error(
+                existing->second.filename().string() + " and " + job.input.filename().string() +
+                " would both be written to " + job.output.string() + "."
+            );
+        }
+    }
+
+    return jobs;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    try {
+        BatchArgs batchArgs;
+
+        try {
+            batchArgs = _parseArgs(args);
+        }
+        catch (const std::exception&) {
+            _printUsage();
+            throw;
+        }
+
+        EffectRegistry registry;
+        auto effects = parseChainSpec(registry, { batchArgs.chain });
+        EffectChain chain{ effects, EffectChainOptions{ .useLut = batchArgs.useLut } };
+
+        auto jobs = _collectJobs(batchArgs);
+        std::filesystem::create_directories(batchArgs.outputDir);
+
+        std::vector<const char*> exts{ VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME };
+        if (gEnableValidationLayers) {
+            exts.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        HeadlessRendererConfig rendererConfig{
+            .registry = registry,
+
+            .requiredExtensions = exts,
+
+            .enableValidationLayers = gEnableValidationLayers,
+            .validationLayers = gValidationLayers,
+            .deviceExtensions = gHeadlessDeviceExtensions,
+
+            .lutSize = gLutSize,
+            .maxImagesInFlight = batchArgs.imagesInFlight,
+            .workingFormat = batchArgs.workingFormat,
+        };
+
+        HeadlessRenderer renderer{ rendererConfig };
+
+        BatchProcessorConfig processorConfig{
+            .renderer = renderer,
+            .chain = chain,
+            .imagesInFlight = batchArgs.imagesInFlight,
+            .workerCount = batchArgs.workerCount,
+        };
+
+        BatchProcessor processor{ processorConfig };
+        auto stats = processor.run(jobs);
+
+        std::cout << "Processed " << stats.processed << " of " << jobs.size() << " images";
+        if (stats.failed > 0U) std::cout << " (" << stats.failed << " failed)";
+        std::cout << " in " << stats.seconds << " s, " << stats.imagesPerSecond << " images/sec\n";
+
+        if (!batchArgs.tracePath.empty()) {
+#if VKIMG2D_TRACE
+            Trace::exportChromeJson(batchArgs.tracePath);
+            std::cout << "Exported trace to " << batchArgs.tracePath.string() << "\n";
+#else
+            std::cerr << "Built without VKIMG2D_TRACE, no trace was recorded.\n";
+#endif
+        }
+
+        return stats.failed > 0U ? EXIT_FAILURE : EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << "[[EXCEPTION OCCURRED]]\n";
+        std::cerr << e.what() << "\n";
+
+        return EXIT_FAILURE;
+    }
+}
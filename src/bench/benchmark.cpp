@@ -0,0 +1,354 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+#include <vulkan/device.hpp>
+#include <vulkan/buffer/commandbuffer.hpp>
+
+static std::string _escapeJson(std::string_view text)
+{
+    std::string escaped;
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+Benchmark::Benchmark(const BenchmarkConfig& config)
+    : mRegistry{ config.registry }
+    , mRenderer{ config.renderer }
+    , mResolutions{ config.resolutions }
+    , mChainLengths{ config.chainLengths }
+    , mWarmupIterations{ config.warmupIterations }
+    , mIterations{ std::max(config.iterations, 1U) }
+{
+    const auto& device = mRenderer.getDevice();
+    const auto physicalDevice = device.getPhysicalDevice();
+
+    const auto family = mRenderer.getCommandPool().getQueueFamilyIndex();
+    const auto validBits = physicalDevice.getQueueFamilyProperties().at(family).timestampValidBits;
+
+    if (validBits == 0U) {
+        throw std::runtime_error("The compute queue does not support timestamps.");
+    }
+
+    mTimestampPeriodNs = physicalDevice.getProperties().limits.timestampPeriod;
+    mTimestampMask = validBits >= 64U ? ~uint64_t{ 0U } : (uint64_t{ 1U } << validBits) - 1U;
+
+    vk::QueryPoolCreateInfo poolInfo{};
+    poolInfo.setQueryType(vk::QueryType::eTimestamp);
+    poolInfo.setQueryCount(2U);
+
+    mQueryPool = device.getVkHandle().createQueryPoolUnique(poolInfo);
+
+    auto& chainContext = mRenderer.getChainContext();
+    mFusedOpBuffer.emplace(chainContext.createFusedOpBuffer());
+
+    // Built up front, an effect whose pipeline is still pending would run through the fused kernel
+    std::vector<std::string> ids;
+    for (const auto& effect : mRegistry.getEffects()) {
+        if (effect.hasOwnPipeline()) ids.push_back(effect.getId());
+    }
+
+    auto& pipelines = chainContext.getEffectPipelines();
+    pipelines.prewarm(ids);
+
+    for (const auto& id : ids) {
+        static_cast<void>(pipelines.get(id));
+    }
+}
+
+std::vector<BenchmarkResult> Benchmark::run()
+{
+    std::vector<BenchmarkResult> results;
+
+    const auto formatName = getWorkingFormatName(mRenderer.getWorkingFormat());
+
+    for (const auto& resolution : mResolutions) {
+        std::cout << "Benchmarking " << resolution.name << " (" << resolution.width << "x" << resolution.height << ") in " << formatName << "\n";
+        _runResolution(resolution, results);
+    }
+
+    return results;
+}
+
+void Benchmark::writeJson(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results) const
+{
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream file{ path, std::ios::trunc };
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path.string() + ".");
+    }
+
+    const auto properties = mRenderer.getDevice().getPhysicalDevice().getProperties();
+
+    file << "{\n";
+    file << std::format("  \"device\": \"{}\",\n", _escapeJson(properties.deviceName.data()));
+    file << std::format("  \"driverVersion\": {},\n", properties.driverVersion);
+    // RGBA16F results of such devices come from the float16 arithmetic shader builds
+    file << std::format("  \"shaderFloat16\": {},\n", mRenderer.getDevice().isShaderFloat16Enabled());
+    file << std::format("  \"warmupIterations\": {},\n", mWarmupIterations);
+    file << std::format("  \"iterations\": {},\n", mIterations);
+    file << "  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+
+        // Bandwidth from the median, which a single slow submission doesn't skew
+        const double gigabytesPerSecond = result.bytes > 0U && result.p50Ms > 0.0
+            ? static_cast<double>(result.bytes) / (result.p50Ms * 1.0e6)
+            : 0.0;
+
+        file << (i == 0U ? "\n" : ",\n") << std::format(
+            "    {{ \"kind\": \"{}\", \"name\": \"{}\", \"resolution\": \"{}\", \"format\": \"{}\", \"width\": {}, \"height\": {}, "
+            "\"meanMs\": {:.4f}, \"minMs\": {:.4f}, \"p50Ms\": {:.4f}, \"p95Ms\": {:.4f}, \"bytes\": {}, \"gbPerSecond\": {:.3f} }}",
+            result.kind, _escapeJson(result.name), result.resolution, result.format, result.width, result.height,
+            result.meanMs, result.minMs, result.p50Ms, result.p95Ms, result.bytes, gigabytesPerSecond
+        );
+    }
+
+    file << "\n  ]\n}\n";
+
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path.string() + ".");
+    }
+}
+
+void Benchmark::_runResolution(const BenchmarkResolution& resolution, std::vector<BenchmarkResult>& results)
+{
+    const auto& device = mRenderer.getDevice();
+    const auto& commandPool = mRenderer.getCommandPool();
+
+    // The source is always sRGB RGBA8, readback copies a chain image of the working format
+    const vk::DeviceSize size = vk::DeviceSize{ resolution.width } * resolution.height * 4U;
+    const vk::DeviceSize readbackSize = vk::DeviceSize{ resolution.width } * resolution.height * getPixelSize(mRenderer.getWorkingFormat());
+
+    SampledImageConfig sourceConfig = {
+        .commandPool = commandPool,
+        .width = resolution.width,
+        .height = resolution.height,
+    };
+
+    TextureImage source{ device, sourceConfig };
+
+    BufferConfig stagingConfig = {
+        .size = size,
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = commandPool,
+        .persistentMap = true,
+    };
+
+    Buffer staging{ device, stagingConfig };
+
+    // Fixed-seed noise, so every run measures the same content
+    auto* words = static_cast<uint32_t*>(staging.getMappedData());
+    uint32_t state = 0x9E3779B9U;
+
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+        state ^= state << 13U;
+        state ^= state >> 17U;
+        state ^= state << 5U;
+        words[i] = state | 0xFF000000U;
+    }
+
+    BufferConfig readbackConfig = {
+        .size = readbackSize,
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = commandPool,
+        .persistentMap = true,
+    };
+
+    Buffer readback{ device, readbackConfig };
+
+    ComputeImageConfig pingPongConfig = {
+        .commandPool = commandPool,
+        .width = resolution.width,
+        .height = resolution.height,
+        .format = mRenderer.getWorkingFormat(),
+    };
+
+    RenderImageSet images{
+        source,
+        TextureImage{ device, pingPongConfig },
+        TextureImage{ device, pingPongConfig },
+    };
+
+    auto descriptors = mRenderer.getChainContext().createDescriptors(images, mRenderer.getSampler(), mFusedOpBuffer.value());
+
+    {
+        auto commandBuffer = SingleTimeCommandBuffer{ device, commandPool };
+        source.recordUpload(commandBuffer.getVkHandle(), staging.getVkHandle());
+    }
+
+    Target target{
+        .resolution = resolution,
+        .source = source,
+        .staging = staging,
+        .readback = readback,
+        .images = images,
+        .descriptors = descriptors,
+    };
+
+    _runEffects(target, results);
+    _runChains(target, results);
+    // Last, so the readback copies an image the chains wrote
+    _runTransfers(target, results);
+}
+
+void Benchmark::_runEffects(const Target& target, std::vector<BenchmarkResult>& results)
+{
+    for (const auto& effect : mRegistry.getEffects()) {
+        std::vector<EffectInstance> effects{ EffectInstance{ &effect } };
+
+        auto result = _measureChain(target, effects, EffectChainOptions{});
+        result.kind = "effect";
+        result.name = effect.getId();
+
+        results.push_back(result);
+    }
+}
+
+void Benchmark::_runChains(const Target& target, std::vector<BenchmarkResult>& results)
+{
+    auto sampler = _measureChain(target, {}, EffectChainOptions{});
+    sampler.kind = "chain";
+    sampler.name = "sampler";
+
+    results.push_back(sampler);
+
+    const auto& registryEffects = mRegistry.getEffects();
+
+    for (auto length : mChainLengths) {
+        // Cycling through the registry mixes color and spatial effects, so chains exercise fused, single and LUT steps
+        std::vector<EffectInstance> effects;
+        for (uint32_t i = 0; i < length; i++) {
+            effects.emplace_back(&registryEffects.at(i % registryEffects.size()));
+        }
+
+        for (bool useLut : { false, true }) {
+            // Float chains fuse their LUT runs, a LUT row would time the fused path again
+            if (useLut && !canBakeLut(mRenderer.getWorkingFormat())) continue;
+
+            auto result = _measureChain(target, effects, EffectChainOptions{ .useLut = useLut });
+            result.kind = "chain";
+            result.name = std::format("chain_{}{}", length, useLut ? "_lut" : "");
+
+            results.push_back(result);
+        }
+    }
+}
+
+void Benchmark::_runTransfers(const Target& target, std::vector<BenchmarkResult>& results)
+{
+    const uint64_t pixelCount = uint64_t{ target.resolution.width } * target.resolution.height;
+
+    auto upload = _measure(target, [&target](vk::CommandBuffer buffer) {
+        target.source.recordUpload(buffer, target.staging.getVkHandle());
+    });
+
+    upload.kind = "upload";
+    upload.name = "upload";
+    upload.bytes = pixelCount * 4U;
+
+    results.push_back(upload);
+
+    auto readback = _measure(target, [&target](vk::CommandBuffer buffer) {
+        target.images.ping.recordReadback(buffer, target.readback);
+    });
+
+    readback.kind = "readback";
+    readback.name = "readback";
+    readback.bytes = pixelCount * target.images.ping.getPixelSize();
+
+    results.push_back(readback);
+}
+
+BenchmarkResult Benchmark::_measureChain(const Target& target, const std::vector<EffectInstance>& effects, const EffectChainOptions& options)
+{
+    EffectChain chain{ effects, options };
+    auto& recorder = mRenderer.getChainContext().getChainRecorder();
+
+    return _measure(target, [&](vk::CommandBuffer buffer) {
+        // Every earlier iteration was waited on
+        const auto frame = mRenderer.nextFrame();
+        recorder.beginFrame(frame, frame - 1U);
+        static_cast<void>(recorder.record(buffer, chain, target.images, target.descriptors, mFusedOpBuffer.value()));
+    });
+}
+
+BenchmarkResult Benchmark::_measure(const Target& target, const std::function<void(vk::CommandBuffer)>& record)
+{
+    for (uint32_t i = 0; i < mWarmupIterations; i++) {
+        static_cast<void>(_timeOnce(record));
+    }
+
+    std::vector<double> samples;
+    samples.reserve(mIterations);
+
+    for (uint32_t i = 0; i < mIterations; i++) {
+        samples.push_back(_timeOnce(record));
+    }
+
+    std::ranges::sort(samples);
+
+    // Nearest-rank percentile
+    auto percentile = [&samples](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+        return samples.at(std::max<size_t>(rank, 1U) - 1U);
+    };
+
+    return BenchmarkResult{
+        .kind = {},
+        .name = {},
+        .resolution = target.resolution.name,
+        .format = std::string{ getWorkingFormatName(mRenderer.getWorkingFormat()) },
+        .width = target.resolution.width,
+        .height = target.resolution.height,
+        .meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()),
+        .minMs = samples.front(),
+        .p50Ms = percentile(0.50),
+        .p95Ms = percentile(0.95),
+        .bytes = 0U,
+    };
+}
+
+double Benchmark::_timeOnce(const std::function<void(vk::CommandBuffer)>& record)
+{
+    const auto& device = mRenderer.getDevice();
+
+    {
+        auto commandBuffer = SingleTimeCommandBuffer{ device, mRenderer.getCommandPool() };
+        auto buffer = commandBuffer.getVkHandle();
+
+        buffer.resetQueryPool(mQueryPool.get(), 0U, 2U);
+        buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, mQueryPool.get(), 0U);
+
+        record(buffer);
+
+        buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, mQueryPool.get(), 1U);
+    }
+
+    // The submission was waited on, so the results are already available
+    auto timestamps = device.getVkHandle().getQueryPoolResults<uint64_t>(
+        mQueryPool.get(), 0U, 2U, 2U * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait
+    );
+
+    const auto ticks = (timestamps.value.at(1) - timestamps.value.at(0)) & mTimestampMask;
+
+    return static_cast<double>(ticks) * mTimestampPeriodNs / 1.0e6;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <effect/chain.hpp>
+#include <effect/instance.hpp>
+#include <effect/registry.hpp>
+#include <vulkan/include.hpp>
+#include <vulkan/headless_renderer.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/chain_recorder.hpp>
+#include <vulkan/buffer/texture.hpp>
+
+struct BenchmarkResolution
+{
+    std::string name;
+
+    uint32_t width;
+    uint32_t height;
+};
+
+struct BenchmarkConfig
+{
+    const EffectRegistry& registry;
+    HeadlessRenderer& renderer;
+
+    std::vector<BenchmarkResolution> resolutions;
+    // Lengths of the representative chains, built by cycling through the registry
+    std::vector<uint32_t> chainLengths;
+
+    // Untimed submissions before the timed ones, so pipelines and caches are warm
+    uint32_t warmupIterations;
+    uint32_t iterations;
+};
+
+struct BenchmarkResult
+{
+    // "effect", "chain", "upload" or "readback"
+    std::string kind;
+    std::string name;
+    std::string resolution;
+    // Working format of the chain images, see WorkingFormat
+    std::string format;
+
+    uint32_t width;
+    uint32_t height;
+
+    double meanMs;
+    double minMs;
+    double p50Ms;
+    double p95Ms;
+
+    // Bytes moved per iteration, zero for compute cases
+    uint64_t bytes;
+};
+
+// Times effect kernels, chains and transfers on the GPU with timestamp queries, each
+// iteration submitted and waited on its own. Effect cases evaluate a one-effect chain, so they
+// include the sampler pass, which is also reported alone as the "sampler" chain.
+class Benchmark
+{
+public:
+    explicit Benchmark(const BenchmarkConfig& config);
+
+    [[nodiscard]] std::vector<BenchmarkResult> run();
+
+    // Results of different commits are matched by kind, name, resolution and format
+    void writeJson(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results) const;
+private:
+    // Resources of the resolution being measured
+    struct Target
+    {
+        const BenchmarkResolution& resolution;
+
+        const TextureImage& source;
+        const Buffer& staging;
+        const Buffer& readback;
+
+        RenderImageSet& images;
+        const ComputeDescriptorSet& descriptors;
+    };
+
+    void _runResolution(const BenchmarkResolution& resolution, std::vector<BenchmarkResult>& results);
+    void _runEffects(const Target& target, std::vector<BenchmarkResult>& results);
+    void _runChains(const Target& target, std::vector<BenchmarkResult>& results);
+    void _runTransfers(const Target& target, std::vector<BenchmarkResult>& results);
+
+    [[nodiscard]] BenchmarkResult _measureChain(const Target& target, const std::vector<EffectInstance>& effects, const EffectChainOptions& options);
+    // Times the commands of `record` over every timed iteration
+    [[nodiscard]] BenchmarkResult _measure(const Target& target, const std::function<void(vk::CommandBuffer)>& record);
+    [[nodiscard]] double _timeOnce(const std::function<void(vk::CommandBuffer)>& record);
+
+    const EffectRegistry& mRegistry;
+    HeadlessRenderer& mRenderer;
+
+    std::vector<BenchmarkResolution> mResolutions;
+    std::vector<uint32_t> mChainLengths;
+    uint32_t mWarmupIterations;
+    uint32_t mIterations;
+
+    vk::UniqueQueryPool mQueryPool;
+    double mTimestampPeriodNs = 0.0;
+    uint64_t mTimestampMask = 0U;
+
+    std::optional<Buffer> mFusedOpBuffer;
+};
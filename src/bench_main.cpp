@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <frontend.hpp>
+#include <bench/benchmark.hpp>
+#include <effect/registry.hpp>
+#include <vulkan/headless_renderer.hpp>
+
+// 4:3 frames of about 1, 12 and 48 megapixels
+static const std::vector<BenchmarkResolution> gResolutions = {
+    BenchmarkResolution{ .name = "1MP", .width = 1152U, .height = 864U },
+    BenchmarkResolution{ .name = "12MP", .width = 4000U, .height = 3000U },
+    BenchmarkResolution{ .name = "48MP", .width = 8000U, .height = 6000U },
+};
+
+static const std::vector<uint32_t> gChainLengths = { 5U, 10U, 20U };
+
+static const std::vector<WorkingFormat> gFormats = { WorkingFormat::Rgba8, WorkingFormat::Rgba16f, WorkingFormat::Rgba32f };
+
+struct BenchArgs
+{
+    std::filesystem::path output = "bench.json";
+
+    // Names from gResolutions, all of them when empty
+    std::vector<std::string> resolutions;
+    // Every working format when empty
+    std::vector<WorkingFormat> formats;
+
+    uint32_t warmupIterations = 3U;
+    uint32_t iterations = 20U;
+};
+
+static void _printUsage()
+{
+    std::cerr
+        << "Usage: vkimg2d_bench [options]\n"
+        << "  --output <file>        JSON results (default bench.json)\n"
+        << "  --resolutions <list>   comma-separated subset of 1MP,12MP,48MP (default all)\n"
+        << "  --formats <list>       comma-separated subset of rgba8,rgba16f,rgba32f (default all)\n"
+        << "  --warmup <n>           untimed iterations per case (default 3)\n"
+        << "  --iterations <n>       timed iterations per case (default 20)\n";
+}
+
+static std::vector<std::string_view> _splitList(std::string_view list)
+{
+    std::vector<std::string_view> items;
+
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        items.push_back(list.substr(0U, comma));
+
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1U);
+    }
+
+    return items;
+}
+
+static BenchArgs _parseArgs(const std::vector<std::string_view>& args)
+{
+    BenchArgs result;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const auto arg = args[i];
+        const bool hasValue = i + 1U < args.size();
+
+        if (arg == "--output" && hasValue) {
+            result.output = args[++i];
+        }
+        else if (arg == "--resolutions" && hasValue) {
+            for (auto name : _splitList(args[++i])) {
+                result.resolutions.emplace_back(name);
+            }
+        }
+        else if (arg == "--formats" && hasValue) {
+            for (auto name : _splitList(args[++i])) {
+                const auto format = parseWorkingFormat(name);
+
+                if (!format.has_value()) {
+                    throw std::runtime_error("Unknown working format " + std::string{ name } + ".");
+                }
+
+                result.formats.push_back(format.value());
+            }
+        }
+        else if (arg == "--warmup" && hasValue) {
+            result.warmupIterations = parseCount(args[++i], 0U);
+        }
+        else if (arg == "--iterations" && hasValue) {
+            result.iterations = parseCount(args[++i]);
+        }
+        else {
+            throw std::runtime_error("Unknown option " + std::string{ arg } + ".");
+        }
+    }
+
+    return result;
+}
+
+static std::vector<BenchmarkResolution> _selectResolutions(const std::vector<std::string>& names)
+{
+    if (names.empty()) {
+        return gResolutions;
+    }
+
+    std::vector<BenchmarkResolution> selected;
+
+    for (const auto& name : names) {
+        auto resolution = std::ranges::find(gResolutions, name, &BenchmarkResolution::name);
+
+        if (resolution == gResolutions.end()) {
+            throw std::runtime_error("Unknown resolution " + name + ".");
+        }
+
+        selected.push_back(*resolution);
+    }
+
+    return selected;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+
+    try {
+        BenchArgs benchArgs;
+
+        try {
+            benchArgs = _parseArgs(args);
+        }
+        catch (const std::exception&) {
+            _printUsage();
+            throw;
+        }
+
+        std::vector<const char*> exts{ VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME };
+        if (gEnableValidationLayers) {
+            exts.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        EffectRegistry registry;
+
+        const auto resolutions = _selectResolutions(benchArgs.resolutions);
+        const auto formats = benchArgs.formats.empty() ? gFormats : benchArgs.formats;
+
+        std::vector<BenchmarkResult> results;
+
+        // Shaders and image formats are fixed per renderer, so every format gets its own
+        for (size_t i = 0; i < formats.size(); i++) {
+            HeadlessRendererConfig rendererConfig{
+                .registry = registry,
+
+                .requiredExtensions = exts,
+
+                .enableValidationLayers = gEnableValidationLayers,
+                .validationLayers = gValidationLayers,
+                .deviceExtensions = gHeadlessDeviceExtensions,
+
+                .lutSize = gLutSize,
+                .workingFormat = formats[i],
+            };
+
+            HeadlessRenderer renderer{ rendererConfig };
+
+            BenchmarkConfig benchmarkConfig{
+                .registry = registry,
+                .renderer = renderer,
+
+                .resolutions = resolutions,
+                .chainLengths = gChainLengths,
+
+                .warmupIterations = benchArgs.warmupIterations,
+                .iterations = benchArgs.iterations,
+            };
+
+            Benchmark benchmark{ benchmarkConfig };
+            auto formatResults = benchmark.run();
+
+            results.insert(results.end(), formatResults.begin(), formatResults.end());
+
+            if (i + 1U == formats.size()) {
+                benchmark.writeJson(benchArgs.output, results);
+            }
+        }
+
+        std::cout << "Wrote " << results.size() << " results to " << benchArgs.output.string() << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "[[EXCEPTION OCCURRED]]\n";
+        std::cerr << e.what() << "\n";
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
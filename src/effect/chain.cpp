@@ -0,0 +1,142 @@
+#include "chain.hpp"
+
+#include <algorithm>
+
+#include <effect/hash.hpp>
+
+EffectChain::EffectChain(const std::vector<EffectInstance>& effects, const EffectChainOptions& options)
+    : mOptions{ options }
+{
+    mStages.reserve(effects.size());
+    mPrefixHashes.reserve(effects.size() + 1U);
+
+    size_t hash = 0U;
+    mPrefixHashes.push_back(hash);
+
+    // LUT evaluation is approximate, so its results must not be mistaken for exact ones
+    hashCombine(hash, options.useLut);
+
+    for (const auto& effect : effects) {
+        if (!effect.enabled) continue;
+        if (options.isAvailable && !options.isAvailable(*effect.effect)) continue;
+
+        mStages.push_back(&effect);
+
+        hashCombine(hash, effect.getHash());
+        mPrefixHashes.push_back(hash);
+    }
+}
+
+const std::vector<const EffectInstance*>& EffectChain::getStages() const noexcept
+{
+    return mStages;
+}
+
+size_t EffectChain::getHash() const noexcept
+{
+    return mPrefixHashes.back();
+}
+
+size_t EffectChain::getPrefixHash(size_t stageCount) const
+{
+    return mPrefixHashes.at(stageCount);
+}
+
+const std::vector<size_t>& EffectChain::getPrefixHashes() const noexcept
+{
+    return mPrefixHashes;
+}
+
+size_t EffectChain::getRunHash(size_t begin, size_t end) const
+{
+    size_t hash = 0U;
+
+    for (size_t i = begin; i < end; i++) {
+        hashCombine(hash, mStages.at(i)->getHash());
+    }
+
+    return hash;
+}
+
+bool EffectChain::isColorOnly() const noexcept
+{
+    for (size_t i = 0; i < mStages.size(); i++) {
+        if (!_isColorStage(i)) return false;
+    }
+
+    return true;
+}
+
+std::vector<ChainStep> EffectChain::plan(size_t begin, size_t boundary) const
+{
+    std::vector<ChainStep> steps;
+
+    size_t stage = begin;
+    while (stage < mStages.size()) {
+        // A single color stage is cheaper to run directly than through a LUT
+        if (mOptions.useLut && _colorRunEnd(stage, boundary) - stage > 1U) {
+            auto end = _colorRunEnd(stage, boundary);
+            steps.push_back(ChainStep{ .type = ChainStepType::Lut, .begin = stage, .end = end });
+
+            stage = end;
+            continue;
+        }
+
+        size_t end = stage + 1U;
+
+        if (mStages.at(stage)->effect->isFusable()) {
+            while (end < mStages.size() && end != boundary && mStages.at(end)->effect->isFusable()) {
+                if (mOptions.useLut && _colorRunEnd(end, boundary) - end > 1U) break;
+
+                end++;
+            }
+        }
+
+        auto type = end - stage > 1U ? ChainStepType::Fused : ChainStepType::Single;
+        steps.push_back(ChainStep{ .type = type, .begin = stage, .end = end });
+
+        stage = end;
+    }
+
+    return steps;
+}
+
+FusedOp EffectChain::getFusedOp(size_t stage) const
+{
+    const auto& instance = *mStages.at(stage);
+
+    FusedOp op{ .op = instance.effect->getFusedOp().value(), .params = {} };
+
+    auto values = instance.getParamValues();
+    std::copy_n(values.begin(), std::min(values.size(), op.params.size()), op.params.begin());
+
+    return op;
+}
+
+std::vector<FusedOp> EffectChain::getFusedOps(size_t begin, size_t end) const
+{
+    std::vector<FusedOp> ops;
+    ops.reserve(end - begin);
+
+    for (size_t i = begin; i < end; i++) {
+        ops.push_back(getFusedOp(i));
+    }
+
+    return ops;
+}
+
+bool EffectChain::_isColorStage(size_t stage) const
+{
+    return mStages.at(stage)->effect->isLutBakeable();
+}
+
+size_t EffectChain::_colorRunEnd(size_t begin, size_t boundary) const
+{
+    size_t end = begin;
+
+    while (end < mStages.size() && (end == begin || end != boundary) && _isColorStage(end)) {
+        end++;
+    }
+
+    return end;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include <effect/instance.hpp>
+
+enum class ChainStepType
+{
+    Single,
+    Fused,
+    Lut,
+};
+
+// One dispatch covering the stages [begin, end)
+struct ChainStep
+{
+    ChainStepType type;
+    size_t begin, end;
+};
+
+// std430 layout of FusedOp in shaders/include/ops.glsl
+struct FusedOp
+{
+    uint32_t op;
+    std::array<float, 3> params;
+};
+
+static_assert(sizeof(FusedOp) == 16U);
+
+struct EffectChainOptions
+{
+    // Evaluate runs of color-only effects through a baked 3D LUT
+    bool useLut = false;
+
+    // Enabled effects failing this are left out as if disabled, every effect is kept when empty
+    std::function<bool(const Effect&)> isAvailable;
+};
+
+// Snapshot of the enabled effects of a chain, in evaluation order,
+// together with hashes describing the image after each of its stages.
+class EffectChain
+{
+public:
+    explicit EffectChain(const std::vector<EffectInstance>& effects, const EffectChainOptions& options = {});
+
+    [[nodiscard]] const std::vector<const EffectInstance*>& getStages() const noexcept;
+    [[nodiscard]] size_t getHash() const noexcept;
+
+    // Hash of the image after the first `stageCount` stages were applied
+    [[nodiscard]] size_t getPrefixHash(size_t stageCount) const;
+    [[nodiscard]] const std::vector<size_t>& getPrefixHashes() const noexcept;
+
+    // Hash of the stages [begin, end) alone, regardless of what precedes them
+    [[nodiscard]] size_t getRunHash(size_t begin, size_t end) const;
+
+    // Whether every stage maps colors to colors, so the chain fits in a single LUT
+    [[nodiscard]] bool isColorOnly() const noexcept;
+
+    // Splits the stages from `begin` into dispatches, merging runs of fusable stages
+    // and, with `useLut`, baking runs of color-only stages into a LUT. Recorders without a LUT
+    // cache, such as those of float working formats, fuse LUT steps instead.
+    // No step spans across `boundary`, so the image after that many stages is materialized.
+    [[nodiscard]] std::vector<ChainStep> plan(size_t begin, size_t boundary) const;
+
+    [[nodiscard]] FusedOp getFusedOp(size_t stage) const;
+    [[nodiscard]] std::vector<FusedOp> getFusedOps(size_t begin, size_t end) const;
+private:
+    bool _isColorStage(size_t stage) const;
+    size_t _colorRunEnd(size_t begin, size_t boundary) const;
+
+    EffectChainOptions mOptions;
+
+    std::vector<const EffectInstance*> mStages;
+    std::vector<size_t> mPrefixHashes;
+};
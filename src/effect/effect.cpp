@@ -2,10 +2,11 @@
 
 #include <ranges>
 
-Effect::Effect(std::string_view id, std::string_view displayName, const std::filesystem::path& shaderPath)
+Effect::Effect(std::string_view id, std::string_view displayName, const std::filesystem::path& shaderPath, EffectKind kind)
     : mId{ id }
     , mDisplayName{ displayName }
     , mShaderPath{ shaderPath }
+    , mKind{ kind }
 {
 }
 
@@ -29,6 +30,41 @@ const std::vector<FloatParam>& Effect::getParams() const noexcept
     return mParams;
 }
 
+EffectKind Effect::getKind() const noexcept
+{
+    return mKind;
+}
+
+std::optional<uint32_t> Effect::getFusedOp() const noexcept
+{
+    return mFusedOp;
+}
+
+std::optional<uint32_t> Effect::getBlurMode() const noexcept
+{
+    return mBlurMode;
+}
+
+bool Effect::isFusable() const noexcept
+{
+    return mKind != EffectKind::Neighborhood && mFusedOp.has_value();
+}
+
+bool Effect::isLutBakeable() const noexcept
+{
+    return mKind == EffectKind::Color && isFusable();
+}
+
+bool Effect::hasOwnPipeline() const noexcept
+{
+    return !mBlurMode.has_value();
+}
+
+bool Effect::readsImageStats() const noexcept
+{
+    return mReadsImageStats;
+}
+
 const FloatParam* Effect::getParamById(std::string_view id) const
 {
     auto it = std::ranges::find_if(mParams, [id](const FloatParam& e) {
@@ -42,3 +78,18 @@ void Effect::addParam(FloatParam param)
 {
     mParams.push_back(param);
 }
+
+void Effect::setFusedOp(uint32_t op)
+{
+    mFusedOp = op;
+}
+
+void Effect::setBlurMode(uint32_t mode)
+{
+    mBlurMode = mode;
+}
+
+void Effect::setReadsImageStats(bool reads)
+{
+    mReadsImageStats = reads;
+}
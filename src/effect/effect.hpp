@@ -1,29 +1,56 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
 #include <effect/param.hpp>
 
+enum class EffectKind
+{
+    Color, // depends only on the color of the pixel
+    Pixel, // depends on the color and the position of the pixel
+    Neighborhood, // reads surrounding pixels
+};
+
 class Effect
 {
 public:
-    Effect(std::string_view id, std::string_view displayName, const std::filesystem::path& shaderPath);
+    Effect(std::string_view id, std::string_view displayName, const std::filesystem::path& shaderPath, EffectKind kind = EffectKind::Color);
 
     [[nodiscard]] const std::string& getId() const noexcept;
     [[nodiscard]] const std::string& getDisplayName() const noexcept;
     [[nodiscard]] const std::filesystem::path& getShaderPath() const noexcept;
     [[nodiscard]] const std::vector<FloatParam>& getParams() const noexcept;
+    [[nodiscard]] EffectKind getKind() const noexcept;
+    [[nodiscard]] std::optional<uint32_t> getFusedOp() const noexcept;
+    [[nodiscard]] std::optional<uint32_t> getBlurMode() const noexcept;
+
+    // Per-pixel effects with an op in shaders/include/ops.glsl can be merged into one dispatch
+    [[nodiscard]] bool isFusable() const noexcept;
+    // Fusable color effects, runs of them can be baked into a LUT
+    [[nodiscard]] bool isLutBakeable() const noexcept;
+    // Blur effects run through the shared blur passes instead of a shader of their own
+    [[nodiscard]] bool hasOwnPipeline() const noexcept;
+    // Reads the statistics of its input image, bound as set 1, see shaders/include/stats.glsl
+    [[nodiscard]] bool readsImageStats() const noexcept;
 
     const FloatParam* getParamById(std::string_view id) const;
 
     void addParam(FloatParam param);
+    void setFusedOp(uint32_t op);
+    void setBlurMode(uint32_t mode);
+    void setReadsImageStats(bool reads);
 private:
     std::string mId;
     std::string mDisplayName;
     std::filesystem::path mShaderPath;
+    EffectKind mKind;
+    std::optional<uint32_t> mFusedOp;
+    std::optional<uint32_t> mBlurMode;
+    bool mReadsImageStats = false;
 
     std::vector<FloatParam> mParams;
 };
@@ -1,5 +1,7 @@
 #include "instance.hpp"
 
+#include <effect/hash.hpp>
+
 EffectInstance::EffectInstance(const Effect* effect)
 : effect{ effect }
 {
@@ -11,13 +13,26 @@ std::vector<float> EffectInstance::getParamValues() const
     std::vector<float> result{};
     result.reserve(params.size());
 
-    for (const auto& pair : params) {
-        result.push_back(pair.second);
+    // Declaration order matches the push constant layout of the shader
+    for (const auto& param : effect->getParams()) {
+        result.push_back(params.at(param.id));
     }
 
     return result;
 }
 
+size_t EffectInstance::getHash() const
+{
+    size_t hash = 0U;
+    hashCombine(hash, effect->getId());
+
+    for (float value : getParamValues()) {
+        hashCombine(hash, value);
+    }
+
+    return hash;
+}
+
 void EffectInstance::_loadDefaultParams()
 {
     params.clear();
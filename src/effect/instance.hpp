@@ -15,6 +15,7 @@ public:
     std::unordered_map<std::string, float> params{};
 
     std::vector<float> getParamValues() const;
+    size_t getHash() const;
 private:
     void _loadDefaultParams();
 };
@@ -7,10 +7,14 @@ EffectRegistry::EffectRegistry()
     mEffects.reserve(16U); // this is intentionally ugly and random
 
     Effect grayscale{ EffectIds::Grayscale, "Grayscale", BinaryReader::toShaderBinPath("grayscale.spv") };
+    grayscale.setFusedOp(EffectOps::Grayscale);
     Effect invert{ EffectIds::Invert, "Invert", BinaryReader::toShaderBinPath("invert.spv") };
+    invert.setFusedOp(EffectOps::Invert);
     Effect sepia{ EffectIds::Sepia, "Sepia", BinaryReader::toShaderBinPath("sepia.spv") };
+    sepia.setFusedOp(EffectOps::Sepia);
 
     Effect posterize{ EffectIds::Posterize, "Posterize", BinaryReader::toShaderBinPath("posterize.spv")};
+    posterize.setFusedOp(EffectOps::Posterize);
     posterize.addParam(FloatParam{
         .id = "level",
         .displayName = "Level",
@@ -19,6 +23,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect solarize{ EffectIds::Solarize, "Solarize", BinaryReader::toShaderBinPath("solarize.spv") };
+    solarize.setFusedOp(EffectOps::Solarize);
     solarize.addParam(FloatParam{
         .id = "threshold",
         .displayName = "Threshold",
@@ -27,6 +32,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect threshold{ EffectIds::Threshold, "Threshold", BinaryReader::toShaderBinPath("threshold.spv") };
+    threshold.setFusedOp(EffectOps::Threshold);
     threshold.addParam(FloatParam{
         .id = "threshold",
         .displayName = "Threshold",
@@ -35,6 +41,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect exposure{ EffectIds::Exposure, "Exposure", BinaryReader::toShaderBinPath("exposure.spv") };
+    exposure.setFusedOp(EffectOps::Exposure);
     exposure.addParam(FloatParam{
         .id = "eexposure",
         .displayName = "Exposure",
@@ -43,6 +50,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect gamma{ EffectIds::Gamma, "Gamma", BinaryReader::toShaderBinPath("gamma.spv") };
+    gamma.setFusedOp(EffectOps::Gamma);
     gamma.addParam(FloatParam{
         .id = "gamma",
         .displayName = "Gamma",
@@ -51,6 +59,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect temperature{ EffectIds::Temperature, "Temperature", BinaryReader::toShaderBinPath("temperature.spv") };
+    temperature.setFusedOp(EffectOps::Temperature);
     temperature.addParam(FloatParam{
         .id = "temperature",
         .displayName = "Temperature",
@@ -59,6 +68,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect vibrance{ EffectIds::Vibrance, "Vibrance", BinaryReader::toShaderBinPath("vibrance.spv") };
+    vibrance.setFusedOp(EffectOps::Vibrance);
     vibrance.addParam(FloatParam{
         .id = "vibrance",
         .displayName = "Vibrance",
@@ -66,7 +76,7 @@ EffectRegistry::EffectRegistry()
         .min = -1.0f, .max = 8.0f,
     });
 
-    Effect sharpen{ EffectIds::Sharpen, "Sharpen", BinaryReader::toShaderBinPath("sharpen.spv") };
+    Effect sharpen{ EffectIds::Sharpen, "Sharpen", BinaryReader::toShaderBinPath("sharpen.spv"), EffectKind::Neighborhood };
     sharpen.addParam(FloatParam{
         .id = "sharpen",
         .displayName = "Sharpen",
@@ -75,6 +85,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect briCon{ EffectIds::BriCon, "Brightness/Contrast", BinaryReader::toShaderBinPath("bricon.spv") };
+    briCon.setFusedOp(EffectOps::BriCon);
     briCon.addParam(FloatParam{
         .id = "brightness",
         .displayName = "Brightness",
@@ -89,6 +100,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect levels{ EffectIds::Levels, "Levels", BinaryReader::toShaderBinPath("levels.spv") };
+    levels.setFusedOp(EffectOps::Levels);
     levels.addParam(FloatParam{
         .id = "lows",
         .displayName = "Lows",
@@ -109,6 +121,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect hueSat{ EffectIds::HueSat, "Hue/Saturation", BinaryReader::toShaderBinPath("huesat.spv") };
+    hueSat.setFusedOp(EffectOps::HueSat);
     hueSat.addParam(FloatParam{
         .id = "hue",
         .displayName = "Hue",
@@ -129,6 +142,7 @@ EffectRegistry::EffectRegistry()
     });
 
     Effect colOffset{ EffectIds::ColOffset, "Color Offset", BinaryReader::toShaderBinPath("coloffset.spv") };
+    colOffset.setFusedOp(EffectOps::ColOffset);
     colOffset.addParam(FloatParam{
         .id = "red_offset",
         .displayName = "Red Offset",
@@ -148,7 +162,8 @@ EffectRegistry::EffectRegistry()
         .min = -1.0f, .max = 1.0f,
     });
 
-    Effect vignette{ EffectIds::Vignette, "Vignette", BinaryReader::toShaderBinPath("vignette.spv") };
+    Effect vignette{ EffectIds::Vignette, "Vignette", BinaryReader::toShaderBinPath("vignette.spv"), EffectKind::Pixel };
+    vignette.setFusedOp(EffectOps::Vignette);
     vignette.addParam(FloatParam{
         .id = "radius",
         .displayName = "Radius",
@@ -168,6 +183,89 @@ EffectRegistry::EffectRegistry()
         .min = -1.0f, .max = 1.0f,
     });
 
+    // Blur effects share the passes recorded by ChainRecorder, the radius is always their first param
+    Effect gaussianBlur{ EffectIds::GaussianBlur, "Gaussian Blur", {}, EffectKind::Neighborhood };
+    gaussianBlur.setBlurMode(EffectBlurModes::Gaussian);
+    gaussianBlur.addParam(FloatParam{
+        .id = "radius",
+        .displayName = "Radius",
+        .defaultValue = 4.0f,
+        .min = 0.0f, .max = 256.0f,
+    });
+
+    Effect unsharpMask{ EffectIds::UnsharpMask, "Unsharp Mask", {}, EffectKind::Neighborhood };
+    unsharpMask.setBlurMode(EffectBlurModes::Unsharp);
+    unsharpMask.addParam(FloatParam{
+        .id = "radius",
+        .displayName = "Radius",
+        .defaultValue = 2.0f,
+        .min = 0.0f, .max = 256.0f,
+    });
+    unsharpMask.addParam(FloatParam{
+        .id = "amount",
+        .displayName = "Amount",
+        .defaultValue = 1.0f,
+        .min = 0.0f, .max = 4.0f,
+    });
+    unsharpMask.addParam(FloatParam{
+        .id = "threshold",
+        .displayName = "Threshold",
+        .defaultValue = 0.0f,
+        .min = 0.0f, .max = 1.0f,
+    });
+
+    Effect glow{ EffectIds::Glow, "Glow", {}, EffectKind::Neighborhood };
+    glow.setBlurMode(EffectBlurModes::Glow);
+    glow.addParam(FloatParam{
+        .id = "radius",
+        .displayName = "Radius",
+        .defaultValue = 32.0f,
+        .min = 0.0f, .max = 256.0f,
+    });
+    glow.addParam(FloatParam{
+        .id = "intensity",
+        .displayName = "Intensity",
+        .defaultValue = 1.0f,
+        .min = 0.0f, .max = 4.0f,
+    });
+    glow.addParam(FloatParam{
+        .id = "threshold",
+        .displayName = "Threshold",
+        .defaultValue = 0.8f,
+        .min = 0.0f, .max = 1.0f,
+    });
+
+    // Statistics of the whole input image feed these on the GPU, so they can't be fused or baked
+    Effect autoLevels{ EffectIds::AutoLevels, "Auto Levels", BinaryReader::toShaderBinPath("auto_levels.spv"), EffectKind::Neighborhood };
+    autoLevels.setReadsImageStats(true);
+    autoLevels.addParam(FloatParam{
+        .id = "clip",
+        .displayName = "Clip %",
+        .defaultValue = 0.1f,
+        .min = 0.0f, .max = 5.0f,
+    });
+    autoLevels.addParam(FloatParam{
+        .id = "amount",
+        .displayName = "Amount",
+        .defaultValue = 1.0f,
+        .min = 0.0f, .max = 1.0f,
+    });
+
+    Effect autoExposure{ EffectIds::AutoExposure, "Auto Exposure", BinaryReader::toShaderBinPath("auto_exposure.spv"), EffectKind::Neighborhood };
+    autoExposure.setReadsImageStats(true);
+    autoExposure.addParam(FloatParam{
+        .id = "target",
+        .displayName = "Target",
+        .defaultValue = 0.18f,
+        .min = 0.01f, .max = 1.0f,
+    });
+    autoExposure.addParam(FloatParam{
+        .id = "strength",
+        .displayName = "Strength",
+        .defaultValue = 1.0f,
+        .min = 0.0f, .max = 1.0f,
+    });
+
     mEffects.push_back(grayscale);
     mEffects.push_back(invert);
     mEffects.push_back(sepia);
@@ -186,6 +284,13 @@ EffectRegistry::EffectRegistry()
     mEffects.push_back(hueSat);
     mEffects.push_back(colOffset);
     mEffects.push_back(vignette);
+
+    mEffects.push_back(gaussianBlur);
+    mEffects.push_back(unsharpMask);
+    mEffects.push_back(glow);
+
+    mEffects.push_back(autoLevels);
+    mEffects.push_back(autoExposure);
 }
 
 const std::vector<Effect>& EffectRegistry::getEffects() const noexcept
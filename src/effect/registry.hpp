@@ -25,6 +25,43 @@ namespace EffectIds
     inline constexpr std::string_view HueSat = "hue_sat";
     inline constexpr std::string_view ColOffset = "color_offset";
     inline constexpr std::string_view Vignette = "vignette";
+
+    inline constexpr std::string_view GaussianBlur = "gaussian_blur";
+    inline constexpr std::string_view UnsharpMask = "unsharp_mask";
+    inline constexpr std::string_view Glow = "glow";
+
+    inline constexpr std::string_view AutoLevels = "auto_levels";
+    inline constexpr std::string_view AutoExposure = "auto_exposure";
+}
+
+// Must match the OP_ defines in shaders/include/ops.glsl
+namespace EffectOps
+{
+    inline constexpr uint32_t Grayscale = 1U;
+    inline constexpr uint32_t Invert = 2U;
+    inline constexpr uint32_t Sepia = 3U;
+
+    inline constexpr uint32_t Posterize = 4U;
+    inline constexpr uint32_t Solarize = 5U;
+    inline constexpr uint32_t Threshold = 6U;
+    inline constexpr uint32_t Exposure = 7U;
+    inline constexpr uint32_t Gamma = 8U;
+    inline constexpr uint32_t Temperature = 9U;
+    inline constexpr uint32_t Vibrance = 10U;
+
+    inline constexpr uint32_t BriCon = 11U;
+    inline constexpr uint32_t Levels = 12U;
+    inline constexpr uint32_t HueSat = 13U;
+    inline constexpr uint32_t ColOffset = 14U;
+    inline constexpr uint32_t Vignette = 15U;
+}
+
+// Must match the BLUR_ defines in shaders/include/blur.glsl
+namespace EffectBlurModes
+{
+    inline constexpr uint32_t Gaussian = 1U;
+    inline constexpr uint32_t Unsharp = 2U;
+    inline constexpr uint32_t Glow = 3U;
 }
 
 class EffectRegistry
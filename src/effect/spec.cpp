@@ -0,0 +1,99 @@
+#include "spec.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+static std::string_view _trim(std::string_view text)
+{
+    const auto first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+
+    const auto last = text.find_last_not_of(" \t");
+
+    return text.substr(first, last - first + 1U);
+}
+
+static float _parseValue(std::string_view text, std::string_view spec)
+{
+    float value = 0.0f;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::runtime_error("Invalid parameter value in effect \"" + std::string{ spec } + "\".");
+    }
+
+    return value;
+}
+
+EffectInstance parseEffectSpec(const EffectRegistry& registry, std::string_view spec)
+{
+    spec = _trim(spec);
+
+    const auto colon = spec.find(':');
+    const auto id = _trim(spec.substr(0U, colon));
+
+    const auto* effect = registry.getById(id);
+    if (effect == nullptr) {
+        throw std::runtime_error("Unknown effect \"" + std::string{ id } + "\".");
+    }
+
+    EffectInstance instance{ effect };
+
+    if (colon == std::string_view::npos) {
+        return instance;
+    }
+
+    auto rest = spec.substr(colon + 1U);
+
+    while (!rest.empty()) {
+        const auto comma = rest.find(',');
+        const auto assignment = _trim(rest.substr(0U, comma));
+        rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1U);
+
+        if (assignment.empty()) continue;
+
+        const auto equals = assignment.find('=');
+        if (equals == std::string_view::npos) {
+            throw std::runtime_error("Expected param=value in effect \"" + std::string{ spec } + "\".");
+        }
+
+        const auto paramId = _trim(assignment.substr(0U, equals));
+
+        const auto* param = effect->getParamById(paramId);
+        if (param == nullptr) {
+            throw std::runtime_error("Effect \"" + std::string{ id } + "\" has no parameter \"" + std::string{ paramId } + "\".");
+        }
+
+        float value = _parseValue(_trim(assignment.substr(equals + 1U)), spec);
+
+        // Same range the UI sliders allow
+        if (value < param->min) value = param->min;
+        if (value > param->max) value = param->max;
+
+        instance.params[param->id] = value;
+    }
+
+    return instance;
+}
+
+std::vector<EffectInstance> parseChainSpec(const EffectRegistry& registry, const std::vector<std::string_view>& specs)
+{
+    std::vector<EffectInstance> effects;
+
+    for (auto spec : specs) {
+        while (!spec.empty()) {
+            const auto pipe = spec.find('|');
+            const auto part = _trim(spec.substr(0U, pipe));
+            spec = pipe == std::string_view::npos ? std::string_view{} : spec.substr(pipe + 1U);
+
+            if (!part.empty()) {
+                effects.push_back(parseEffectSpec(registry, part));
+            }
+        }
+    }
+
+    return effects;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include <effect/instance.hpp>
+#include <effect/registry.hpp>
+
+// Parses one effect of a chain description, written as `id` or `id:param=value,param=value`.
+// Parameters that aren't listed keep their defaults.
+[[nodiscard]] EffectInstance parseEffectSpec(const EffectRegistry& registry, std::string_view spec);
+
+// Parses a whole chain, with effects separated by `|` or given as separate specs
+[[nodiscard]] std::vector<EffectInstance> parseChainSpec(const EffectRegistry& registry, const std::vector<std::string_view>& specs);
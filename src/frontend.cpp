@@ -0,0 +1,17 @@
+#include "frontend.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+uint32_t parseCount(std::string_view text, uint32_t minimum)
+{
+    uint32_t value = 0U;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (error != std::errc{} || end != text.data() + text.size() || value < minimum) {
+        throw std::runtime_error("Expected a count of at least " + std::to_string(minimum) + ", got \"" + std::string{ text } + "\".");
+    }
+
+    return value;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/include.hpp>
+
+// Vulkan setup and argument parsing shared by the window, headless, batch and benchmark entry points
+
+#if DEBUG
+    inline const bool gEnableValidationLayers = true;
+#else
+    inline const bool gEnableValidationLayers = false;
+#endif
+
+inline const std::vector<const char*> gValidationLayers = {
+    "VK_LAYER_KHRONOS_validation",
+};
+
+// No VK_KHR_swapchain, nothing is presented
+inline const std::vector<const char*> gHeadlessDeviceExtensions = {
+#ifdef __APPLE__
+    "VK_KHR_portability_subset",
+#endif
+};
+
+inline const std::vector<const char*> gWindowDeviceExtensions = {
+#ifdef __APPLE__
+    "VK_KHR_portability_subset",
+#endif
+
+    VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+};
+
+// Lattice points per axis of baked LUTs
+inline const uint32_t gLutSize = 33U;
+
+// Rejects anything but a whole number of at least `minimum`
+[[nodiscard]] uint32_t parseCount(std::string_view text, uint32_t minimum = 1U);
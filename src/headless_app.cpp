@@ -0,0 +1,67 @@
+#include "headless_app.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+#include <frontend.hpp>
+#include <effect/spec.hpp>
+#include <io/image.hpp>
+
+HeadlessApp::HeadlessApp(const HeadlessAppConfig& config)
+    : mConfig{ config }
+{
+    _initVulkan();
+}
+
+void HeadlessApp::run()
+{
+    auto effects = parseChainSpec(mRegistry, mConfig.chain);
+
+    auto image = Image{ mConfig.input };
+    auto loadedImage = image.load();
+
+    if (loadedImage.pixels == nullptr) {
+        throw std::runtime_error("Failed to load image " + mConfig.input.string() + ".");
+    }
+
+    auto result = mRenderer->process(loadedImage, effects, EffectChainOptions{ .useLut = mConfig.useLut });
+
+    if (mConfig.output.has_parent_path()) {
+        std::filesystem::create_directories(mConfig.output.parent_path());
+    }
+
+    Image::save(mConfig.output, result.width, result.height, result.pixels);
+
+    std::cout << "Wrote " << mConfig.output.string() << " (" << result.width << "x" << result.height << ")\n";
+}
+
+std::vector<const char*> HeadlessApp::_getExtensionNames() const
+{
+    std::vector<const char*> exts{ VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME };
+
+    if (gEnableValidationLayers) {
+        exts.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    }
+
+    return exts;
+}
+
+void HeadlessApp::_initVulkan()
+{
+    auto exts = _getExtensionNames();
+
+    HeadlessRendererConfig config{
+        .registry = mRegistry,
+
+        .requiredExtensions = exts,
+
+        .enableValidationLayers = gEnableValidationLayers,
+        .validationLayers = gValidationLayers,
+        .deviceExtensions = gHeadlessDeviceExtensions,
+
+        .lutSize = gLutSize,
+        .workingFormat = mConfig.workingFormat,
+    };
+
+    mRenderer.emplace(config);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include <effect/registry.hpp>
+#include <vulkan/headless_renderer.hpp>
+
+struct HeadlessAppConfig
+{
+    std::filesystem::path input;
+    std::filesystem::path output;
+
+    // Effect specs as accepted by parseChainSpec
+    std::vector<std::string_view> chain;
+
+    WorkingFormat workingFormat = WorkingFormat::Rgba16f;
+    // Only with canBakeLut(workingFormat)
+    bool useLut = false;
+};
+
+// Applies a chain to a single image file without opening a window
+class HeadlessApp
+{
+public:
+    explicit HeadlessApp(const HeadlessAppConfig& config);
+
+    void run();
+private:
+    std::vector<const char*> _getExtensionNames() const;
+    void _initVulkan();
+
+    HeadlessAppConfig mConfig;
+
+    EffectRegistry mRegistry;
+    std::optional<HeadlessRenderer> mRenderer;
+};
@@ -1,10 +1,16 @@
 #include "imgui_renderer.hpp"
 
+#include <algorithm>
 #include <format>
+#include <iostream>
 #include <ranges>
 #include <string>
 #include <optional>
 
+#include <effect/instance.hpp>
+#include <io/path.hpp>
+#include <trace/trace.hpp>
+
 ImGuiRenderer::ImGuiRenderer(AppData& appData)
     : mAppData{ appData }
 {
@@ -19,6 +25,8 @@ ImGuiRenderer::~ImGuiRenderer()
 
 void ImGuiRenderer::draw()
 {
+    TRACE_SCOPE("ImGuiRenderer::draw");
+
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -68,6 +76,11 @@ void ImGuiRenderer::draw()
         auto checkboxText = _toUniqueId("Enabled", i);
         ImGui::Checkbox(checkboxText.c_str(), &effect.enabled);
 
+        if (mAppData.pendingEffects.contains(effect.effect->getId())) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("Compiling...");
+        }
+
         for (auto& param : effect.params) {
             const auto& id = param.first;
             auto* value = &param.second;
@@ -110,6 +123,111 @@ void ImGuiRenderer::draw()
     ImGui::SliderFloat("Master Mix", &mixValue, 0.0f, 100.0f, "%.2f");
     mAppData.mix = mixValue / 100.0f;
 
+    ImGui::Separator();
+
+    // Float chains would clamp through the LUT, so they always fuse their color runs
+    if (canBakeLut(mAppData.workingFormat)) {
+        ImGui::Checkbox("Bake Color Runs into LUT", &mAppData.useLut);
+    }
+
+    // Spatial effects can't be expressed as a color lookup. Disabled effects are skipped, as EffectChain does.
+    const bool colorOnly = std::ranges::all_of(effects, [](const EffectInstance& instance) {
+        return !instance.enabled || instance.effect->isLutBakeable();
+    });
+    ImGui::BeginDisabled(!colorOnly);
+
+    if (ImGui::Button("Export LUT (.cube)")) {
+        mAppData.pendingLutExport = Paths::Luts / "chain.cube";
+    }
+
+    ImGui::EndDisabled();
+
+    ImGui::Separator();
+
+    if (ImGui::Button("Export Image (.png)")) {
+        mAppData.pendingImageExport = Paths::Exports / "image.png";
+    }
+
+#if VKIMG2D_TRACE
+    if (ImGui::Button("Export Trace (.json)")) {
+        const auto path = Paths::Exports / "trace.json";
+
+        try {
+            Trace::exportChromeJson(path);
+            std::cout << "Exported trace to " << path.string() << "\n";
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to export trace: " << e.what() << "\n";
+        }
+    }
+#endif
+
+    ImGui::Separator();
+
+    const auto& memory = mAppData.memoryStats;
+    constexpr double mebibyte = 1024.0 * 1024.0;
+
+    ImGui::Text("GPU memory: %.1f / %.1f MiB", static_cast<double>(memory.usedBytes) / mebibyte, static_cast<double>(memory.reservedBytes) / mebibyte);
+    ImGui::Text("%u allocations in %u blocks", memory.allocationCount, memory.blockCount);
+
+    ImGui::End();
+
+    ImGui::Begin("GPU Timings");
+
+    if (mAppData.gpuTimings.empty()) {
+        ImGui::TextDisabled("No timestamps available");
+    }
+    else if (ImGui::BeginTable("gpu_timings", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Pass", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Last");
+        ImGui::TableSetupColumn("Avg");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableHeadersRow();
+
+        for (const auto& timing : mAppData.gpuTimings) {
+            ImGui::TableNextRow();
+
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(timing.name.c_str());
+
+            for (double ms : { timing.lastMs, timing.averageMs, timing.p50Ms, timing.p95Ms, timing.p99Ms }) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f ms", ms);
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+
+    ImGui::Begin("Histogram");
+
+    if (!mAppData.imageStats.has_value()) {
+        ImGui::TextDisabled("No statistics yet");
+    }
+    else {
+        const auto& stats = mAppData.imageStats.value();
+
+        static int channel = static_cast<int>(ImageStatsLayout::Luminance);
+        const char* channelNames[] = { "Red", "Green", "Blue", "Luminance" };
+
+        for (int i = 0; i < static_cast<int>(ImageStatsLayout::ChannelCount); i++) {
+            if (i > 0) ImGui::SameLine();
+            ImGui::RadioButton(channelNames[i], &channel, i);
+        }
+
+        const auto& histogram = stats.histogram.at(channel);
+        const float peak = *std::ranges::max_element(histogram);
+
+        ImGui::PlotHistogram("##histogram", histogram.data(), static_cast<int>(histogram.size()), 0, nullptr, 0.0f, peak, ImVec2{ -1.0f, 120.0f });
+
+        ImGui::Text("Min %.3f  Max %.3f  Mean %.3f", stats.min.at(channel), stats.max.at(channel), stats.mean.at(channel));
+        ImGui::Text("%u pixels", stats.pixelCount);
+    }
+
     ImGui::End();
 
     if (queueMoveUp.has_value()) {
@@ -1,8 +1,18 @@
 #include "image.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <string>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+static const int gJpegQuality = 95;
+
 Image::Image(const std::filesystem::path& path)
     : mPath{ path }
 {
@@ -23,6 +33,38 @@ ImageLoadResult Image::load()
     return result;
 }
 
+void Image::save(const std::filesystem::path& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels)
+{
+    auto extension = path.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    const auto file = path.string();
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+
+    int written = 0;
+
+    if (extension == ".png") {
+        written = stbi_write_png(file.c_str(), w, h, STBI_rgb_alpha, pixels.data(), w * STBI_rgb_alpha);
+    }
+    else if (extension == ".jpg" || extension == ".jpeg") {
+        written = stbi_write_jpg(file.c_str(), w, h, STBI_rgb_alpha, pixels.data(), gJpegQuality);
+    }
+    else if (extension == ".bmp") {
+        written = stbi_write_bmp(file.c_str(), w, h, STBI_rgb_alpha, pixels.data());
+    }
+    else if (extension == ".tga") {
+        written = stbi_write_tga(file.c_str(), w, h, STBI_rgb_alpha, pixels.data());
+    }
+    else {
+        throw std::runtime_error("Unsupported output image format \"" + extension + "\".");
+    }
+
+    if (written == 0) {
+        throw std::runtime_error("Failed to write image " + file + ".");
+    }
+}
+
 ImageLoadResult Image::_loadFromPath(const std::filesystem::path& path)
 {
     int texWidth, texHeight, texChannels;
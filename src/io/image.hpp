@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
 
 #include <stb_image.h>
 
@@ -23,6 +25,9 @@ public:
 	~Image();
 
 	ImageLoadResult load();
+
+	// Encodes tightly packed RGBA8 pixels, picking PNG, JPEG, BMP or TGA by the file extension
+	static void save(const std::filesystem::path& path, uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels);
 private:
 	static ImageLoadResult _loadFromPath(const std::filesystem::path& path);
 
@@ -7,5 +7,11 @@ namespace Paths
     inline const std::filesystem::path Samples{ "samples" };
     inline const std::filesystem::path Shaders{ "shaders" };
     inline const std::filesystem::path ShadersBin{ Shaders / "bin" };
+    inline const std::filesystem::path ShaderArchive{ ShadersBin / "shaders.pak" };
     inline const std::filesystem::path Presets{ "presets" };
+    inline const std::filesystem::path Luts{ "luts" };
+    inline const std::filesystem::path Exports{ "exports" };
+    inline const std::filesystem::path Cache{ "cache" };
+    inline const std::filesystem::path PipelineCache{ Cache / "pipelines.bin" };
+    inline const std::filesystem::path RecentEffects{ Cache / "recent_effects.txt" };
 }
@@ -0,0 +1,172 @@
+#include "shader_archive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+ShaderArchive::ShaderArchive(const std::filesystem::path& path)
+{
+    _map(path);
+
+    try {
+        _readIndex(path);
+    }
+    catch (...) {
+        _unmap();
+        throw;
+    }
+}
+
+ShaderArchive::~ShaderArchive()
+{
+    _unmap();
+}
+
+std::optional<std::span<const uint32_t>> ShaderArchive::find(std::string_view name) const
+{
+    auto entry = mEntries.find(name);
+
+    if (entry == mEntries.end()) {
+        return std::nullopt;
+    }
+
+    return entry->second;
+}
+
+#ifdef _WIN32
+
+void ShaderArchive::_map(const std::filesystem::path& path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open shader archive " + path.string() + ".");
+    }
+
+    mFile = file;
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    mSize = static_cast<size_t>(size.QuadPart);
+
+    mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping != nullptr) {
+        mData = static_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    if (mData == nullptr) {
+        _unmap();
+        throw std::runtime_error("Failed to map shader archive " + path.string() + ".");
+    }
+}
+
+void ShaderArchive::_unmap() noexcept
+{
+    if (mData != nullptr) UnmapViewOfFile(mData);
+    if (mMapping != nullptr) CloseHandle(mMapping);
+    if (mFile != nullptr) CloseHandle(mFile);
+
+    mData = nullptr;
+    mMapping = nullptr;
+    mFile = nullptr;
+}
+
+#else
+
+void ShaderArchive::_map(const std::filesystem::path& path)
+{
+    int file = open(path.c_str(), O_RDONLY);
+
+    if (file < 0) {
+        throw std::runtime_error("Failed to open shader archive " + path.string() + ".");
+    }
+
+    struct stat info{};
+    void* data = MAP_FAILED;
+
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        mSize = static_cast<size_t>(info.st_size);
+        data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+
+    // The mapping stays valid once the descriptor is closed
+    close(file);
+
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map shader archive " + path.string() + ".");
+    }
+
+    mData = static_cast<const uint8_t*>(data);
+}
+
+void ShaderArchive::_unmap() noexcept
+{
+    if (mData != nullptr) {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+
+    mData = nullptr;
+}
+
+#endif
+
+void ShaderArchive::_readIndex(const std::filesystem::path& path)
+{
+    using namespace ShaderArchiveFormat;
+
+    const auto invalid = [&path]() {
+        return std::runtime_error("Invalid shader archive " + path.string() + ".");
+    };
+
+    Header header{};
+
+    if (mSize < sizeof(header)) {
+        throw invalid();
+    }
+
+    std::memcpy(&header, mData, sizeof(header));
+
+    if (header.magic != Magic || header.version != Version) {
+        throw invalid();
+    }
+
+    const uint64_t indexEnd = sizeof(Header) + uint64_t{ header.entryCount } * sizeof(Entry);
+
+    if (indexEnd > mSize) {
+        throw invalid();
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        Entry entry{};
+        std::memcpy(&entry, mData + sizeof(Header) + size_t{ i } * sizeof(Entry), sizeof(entry));
+
+        // SPIR-V is read as 32-bit words, which the mapping's page alignment preserves at aligned offsets.
+        // The offset is checked against the size first, so the remaining length can't wrap around.
+        if (
+            entry.offset < indexEnd || entry.offset > mSize || entry.offset % Alignment != 0U ||
+            entry.size % sizeof(uint32_t) != 0U || entry.size > mSize - entry.offset
+            ) {
+            throw invalid();
+        }
+
+        const auto* name = reinterpret_cast<const char*>(mData + sizeof(Header) + size_t{ i } * sizeof(Entry));
+        const auto* code = reinterpret_cast<const uint32_t*>(mData + entry.offset);
+
+        mEntries.emplace(
+            std::string_view{ name, static_cast<size_t>(std::find(name, name + NameSize, '\0') - name) },
+            std::span<const uint32_t>{ code, static_cast<size_t>(entry.size / sizeof(uint32_t)) }
+        );
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+
+// Layout of the archive written by vkimg2d-pack-shaders: a header, `entryCount` entries
+// sorted by name, then the SPIR-V of every entry at an offset aligned to `Alignment`
+namespace ShaderArchiveFormat
+{
+    inline constexpr std::array<char, 4> Magic{ 'V', 'K', 'S', 'A' };
+    inline constexpr uint32_t Version = 1U;
+    inline constexpr uint64_t Alignment = 16U;
+    inline constexpr size_t NameSize = 48U;
+
+    struct Header
+    {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    // File name of the shader, zero-padded
+    struct Entry
+    {
+        std::array<char, NameSize> name;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(Header) == 16U);
+    static_assert(sizeof(Entry) == 64U);
+}
+
+// Read-only memory mapping of a shader archive. SPIR-V is handed out as views into the
+// mapping, so shader modules are created from it without reading or copying the file.
+class ShaderArchive
+{
+public:
+    explicit ShaderArchive(const std::filesystem::path& path);
+    ~ShaderArchive();
+
+    ShaderArchive(const ShaderArchive&) = delete;
+    ShaderArchive& operator=(const ShaderArchive&) = delete;
+
+    // Code of the shader packed from the file `name`, valid for the lifetime of the archive
+    [[nodiscard]] std::optional<std::span<const uint32_t>> find(std::string_view name) const;
+private:
+    void _map(const std::filesystem::path& path);
+    void _unmap() noexcept;
+    void _readIndex(const std::filesystem::path& path);
+
+    const uint8_t* mData = nullptr;
+    size_t mSize = 0U;
+
+#ifdef _WIN32
+    void* mFile = nullptr;
+    void* mMapping = nullptr;
+#endif
+
+    // Names point into the mapping
+    std::unordered_map<std::string_view, std::span<const uint32_t>> mEntries;
+};
@@ -1,13 +1,99 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <app.hpp>
+#include <headless_app.hpp>
+
+static void _printUsage()
+{
+    std::cerr
+        << "Usage: VkImg2D [--working <fmt>] [--headless <input> <output> [--lut] [effect[:param=value,...]]...]\n"
+        << "  --working <fmt>    chain image format: rgba8, rgba16f or rgba32f (default rgba16f)\n"
+        << "  --lut              bake runs of color effects into a 3D LUT, rgba8 only\n";
+}
+
+// Removes `--working <fmt>` from `args`, wherever it appears
+static WorkingFormat _takeWorkingFormat(std::vector<std::string_view>& args)
+{
+    auto format = WorkingFormat::Rgba16f;
+
+    size_t i = 0;
+    while (i < args.size()) {
+        if (args[i] != "--working") {
+            i++;
+            continue;
+        }
+
+        if (i + 1U == args.size()) {
+            throw std::runtime_error("--working requires a format.");
+        }
+
+        const auto name = args[i + 1U];
+        const auto parsed = parseWorkingFormat(name);
+
+        if (!parsed.has_value()) {
+            throw std::runtime_error("Unknown working format " + std::string{ name } + ".");
+        }
+
+        format = parsed.value();
+        args.erase(args.begin() + i, args.begin() + i + 2U);
+    }
+
+    return format;
+}
+
+// `--headless <input> <output> [--lut] [effects...]`
+static HeadlessAppConfig _parseHeadlessArgs(const std::vector<std::string_view>& args, WorkingFormat workingFormat)
+{
+    if (args.size() < 3U) {
+        throw std::runtime_error("--headless requires an input and an output image.");
+    }
+
+    HeadlessAppConfig config{
+        .input = args[1],
+        .output = args[2],
+        .workingFormat = workingFormat,
+    };
+
+    for (size_t i = 3; i < args.size(); i++) {
+        if (args[i] == "--lut") {
+            config.useLut = true;
+        }
+        else {
+            config.chain.push_back(args[i]);
+        }
+    }
+
+    if (config.useLut && !canBakeLut(workingFormat)) {
+        throw std::runtime_error("--lut requires --working rgba8, LUTs clamp every effect to [0, 1].");
+    }
+
+    return config;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args(argv + 1, argv + argc);
 
-int main() {
     try {
-        App app;
-        app.run();
+        const auto workingFormat = _takeWorkingFormat(args);
+
+        if (!args.empty() && args[0] == "--headless") {
+            HeadlessApp app{ _parseHeadlessArgs(args, workingFormat) };
+            app.run();
+        }
+        else if (!args.empty()) {
+            _printUsage();
+
+            return EXIT_FAILURE;
+        }
+        else {
+            App app{ AppConfig{ .workingFormat = workingFormat } };
+            app.run();
+        }
     } catch (const std::exception& e) {
         std::cerr << "[[EXCEPTION OCCURRED]]\n";
         std::cerr << e.what() << "\n";
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <io/shader_archive.hpp>
+
+// Packs every .spv file of a directory into one archive read by ShaderArchive
+
+static std::vector<char> _readFile(const std::filesystem::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path.string() + ".");
+    }
+
+    return std::vector<char>(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+}
+
+static void _pack(const std::filesystem::path& inputDir, const std::filesystem::path& output)
+{
+    using namespace ShaderArchiveFormat;
+
+    std::vector<std::filesystem::path> inputs;
+
+    for (const auto& entry : std::filesystem::directory_iterator{ inputDir }) {
+        if (entry.is_regular_file() && entry.path().extension() == ".spv") {
+            inputs.push_back(entry.path());
+        }
+    }
+
+    // Deterministic output, directory iteration order is unspecified
+    std::ranges::sort(inputs);
+
+    Header header{
+        .magic = Magic,
+        .version = Version,
+        .entryCount = static_cast<uint32_t>(inputs.size()),
+        .reserved = 0U,
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<char>> blobs;
+
+    uint64_t offset = sizeof(Header) + inputs.size() * sizeof(Entry);
+
+    for (const auto& input : inputs) {
+        const auto name = input.filename().string();
+
+        if (name.size() >= NameSize) {
+            throw std::runtime_error("Shader name " + name + " is too long for the archive.");
+        }
+
+        auto& blob = blobs.emplace_back(_readFile(input));
+        offset = (offset + Alignment - 1U) / Alignment * Alignment;
+
+        Entry entry{ .name = {}, .offset = offset, .size = blob.size() };
+        std::memcpy(entry.name.data(), name.data(), name.size());
+
+        entries.push_back(entry);
+        offset += blob.size();
+    }
+
+    // Written next to the output and renamed over it, so a running app never maps a partial archive
+    auto tempOutput = output;
+    tempOutput += ".tmp";
+
+    {
+        std::ofstream file{ tempOutput, std::ios::binary | std::ios::trunc };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+
+        for (size_t i = 0; i < blobs.size(); i++) {
+            const auto position = static_cast<uint64_t>(file.tellp());
+            const std::vector<char> padding(entries[i].offset - position, '\0');
+
+            file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+            file.write(blobs[i].data(), static_cast<std::streamsize>(blobs[i].size()));
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write " + tempOutput.string() + ".");
+        }
+    }
+
+    std::filesystem::rename(tempOutput, output);
+
+    std::cout << "Packed " << entries.size() << " shaders into " << output.string() << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: vkimg2d-pack-shaders <spv-dir> <archive>\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        _pack(argv[1], argv[2]);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
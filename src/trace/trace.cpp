@@ -0,0 +1,161 @@
+#include "trace.hpp"
+
+#if VKIMG2D_TRACE
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct TraceEvent
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+static const size_t gChunkEventCount = 16384U;
+
+// Written by its thread only. `count` publishes the events before it and `next` publishes the
+// following chunk, so readers never see a partially written event.
+struct TraceChunk
+{
+    std::array<TraceEvent, gChunkEventCount> events;
+    std::atomic<size_t> count{ 0U };
+    std::atomic<TraceChunk*> next{ nullptr };
+};
+
+struct TraceThreadBuffer
+{
+    uint32_t threadId;
+
+    TraceChunk head;
+    TraceChunk* tail = &head;
+
+    ~TraceThreadBuffer()
+    {
+        for (auto* chunk = head.next.load(); chunk != nullptr;) {
+            auto* next = chunk->next.load();
+            delete chunk;
+            chunk = next;
+        }
+    }
+};
+
+// Buffers outlive their threads so events of finished workers are still exported
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> buffers;
+};
+
+static TraceRegistry& _getRegistry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+static const auto gEpoch = std::chrono::steady_clock::now();
+
+// Only taken once per thread, by its first event
+static TraceThreadBuffer* _registerThread()
+{
+    auto& registry = _getRegistry();
+    std::lock_guard lock{ registry.mutex };
+
+    auto& buffer = registry.buffers.emplace_back(std::make_unique<TraceThreadBuffer>());
+    buffer->threadId = static_cast<uint32_t>(registry.buffers.size());
+
+    return buffer.get();
+}
+
+static std::string _escape(const char* text)
+{
+    std::string escaped;
+
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') escaped += '\\';
+        escaped += *c;
+    }
+
+    return escaped;
+}
+
+uint64_t Trace::now() noexcept
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gEpoch).count());
+}
+
+void Trace::record(const char* name, uint64_t begin, uint64_t end)
+{
+    thread_local TraceThreadBuffer* buffer = _registerThread();
+
+    auto* chunk = buffer->tail;
+    auto count = chunk->count.load(std::memory_order_relaxed);
+
+    if (count == gChunkEventCount) {
+        auto* next = new TraceChunk{};
+        chunk->next.store(next, std::memory_order_release);
+
+        buffer->tail = next;
+        chunk = next;
+        count = 0U;
+    }
+
+    chunk->events[count] = TraceEvent{ .name = name, .begin = begin, .end = end };
+    chunk->count.store(count + 1U, std::memory_order_release);
+}
+
+void Trace::exportChromeJson(const std::filesystem::path& path)
+{
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream file{ path, std::ios::trunc };
+
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path.string() + ".");
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto& registry = _getRegistry();
+    std::lock_guard lock{ registry.mutex };
+
+    // Complete events, with timestamps and durations in microseconds
+    for (const auto& buffer : registry.buffers) {
+        for (const auto* chunk = &buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+            const auto count = chunk->count.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i < count; i++) {
+                const auto& event = chunk->events[i];
+
+                file << (first ? "" : ",") << std::format(
+                    "\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    _escape(event.name),
+                    buffer->threadId,
+                    static_cast<double>(event.begin) / 1000.0,
+                    static_cast<double>(event.end - event.begin) / 1000.0
+                );
+
+                first = false;
+            }
+        }
+    }
+
+    file << "\n]}\n";
+
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path.string() + ".");
+    }
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+// CPU trace scopes, compiled in with the VKIMG2D_TRACE CMake option and expanding to nothing otherwise.
+// Every thread appends to its own event buffer without taking a lock, and exports read
+// all buffers while threads keep recording.
+#if VKIMG2D_TRACE
+
+#include <cstdint>
+#include <filesystem>
+
+namespace Trace
+{
+    // Nanoseconds since the process started
+    [[nodiscard]] uint64_t now() noexcept;
+
+    // `name` must outlive the trace, scopes pass string literals
+    void record(const char* name, uint64_t begin, uint64_t end);
+
+    // Writes every event recorded so far as Chrome trace-event JSON, which Perfetto loads
+    void exportChromeJson(const std::filesystem::path& path);
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name) noexcept
+            : mName{ name }
+            , mBegin{ now() }
+        {
+        }
+
+        ~Scope()
+        {
+            record(mName, mBegin, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const char* mName;
+        uint64_t mBegin;
+    };
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+#define TRACE_SCOPE(name) ::Trace::Scope TRACE_CONCAT(traceScope, __LINE__){ name }
+
+#else
+
+#define TRACE_SCOPE(name) static_cast<void>(0)
+
+#endif
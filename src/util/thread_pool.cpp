@@ -0,0 +1,51 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    mThreads.reserve(threadCount);
+
+    for (uint32_t i = 0; i < threadCount; i++) {
+        mThreads.emplace_back(&ThreadPool::_work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{ mMutex };
+        mStopping = true;
+    }
+
+    mCondition.notify_all();
+
+    // Workers drain the queue before exiting, so no future is left without a result
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+uint32_t ThreadPool::getThreadCount() const noexcept
+{
+    return static_cast<uint32_t>(mThreads.size());
+}
+
+void ThreadPool::_work()
+{
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock{ mMutex };
+            mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+            if (mTasks.empty()) {
+                return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of workers running tasks in submission order
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Exceptions thrown by the task are rethrown from the future
+    template<typename Task>
+    [[nodiscard]] std::future<std::invoke_result_t<Task>> submit(Task&& task)
+    {
+        using Result = std::invoke_result_t<Task>;
+
+        // std::function needs a copyable target, packaged_task is move-only
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        auto future = packaged->get_future();
+
+        {
+            std::lock_guard lock{ mMutex };
+            mTasks.emplace([packaged] { (*packaged)(); });
+        }
+
+        mCondition.notify_one();
+
+        return future;
+    }
+
+    [[nodiscard]] uint32_t getThreadCount() const noexcept;
+private:
+    void _work();
+
+    std::vector<std::thread> mThreads;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::queue<std::function<void()>> mTasks;
+    bool mStopping = false;
+};
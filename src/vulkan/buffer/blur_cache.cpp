@@ -0,0 +1,140 @@
+#include "blur_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <vulkan/device.hpp>
+
+BlurCache::BlurCache(const Device& device, const BlurCacheConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+    , mDescriptorPool{ config.descriptorPool }
+    , mLevelLayout{ config.levelLayout }
+    , mSampleLayout{ config.sampleLayout }
+    , mSampler{ config.sampler }
+    , mFormat{ config.format }
+    , mCapacity{ config.capacity }
+    , mMaxLevels{ config.maxLevels }
+{
+}
+
+void BlurCache::beginFrame(uint64_t frame, uint64_t completedFrame)
+{
+    mFrame = frame;
+    mCompletedFrame = completedFrame;
+}
+
+const std::vector<BlurLevel>* BlurCache::acquire(vk::Extent2D extent, uint32_t levelCount)
+{
+    const auto key = _toKey(extent);
+    levelCount = std::min(levelCount, mMaxLevels);
+
+    EntryList::iterator entry;
+
+    if (auto it = mLookup.find(key); it != mLookup.end()) {
+        entry = it->second;
+    }
+    else if (mEntries.size() < mCapacity) {
+        mEntries.emplace_front(Entry{ .extent = extent, .levels = {}, .lastUsedFrame = mFrame });
+        entry = mEntries.begin();
+        entry->levels.reserve(mMaxLevels);
+    }
+    else {
+        // Images of another resolution can't be reused, so the least recently used pyramid is rebuilt
+        if (mEntries.empty() || !_isEvictable(mEntries.back())) {
+            return nullptr;
+        }
+
+        entry = std::prev(mEntries.end());
+        mLookup.erase(_toKey(entry->extent));
+
+        entry->extent = extent;
+        entry->levels.clear();
+    }
+
+    mLookup[key] = entry;
+    _touch(entry);
+
+    // Levels in use by earlier frames stay as they are, deeper ones are appended
+    while (entry->levels.size() < levelCount) {
+        const auto previous = entry->levels.empty() ? extent : entry->levels.back().image.getExtent();
+        entry->levels.push_back(_createLevel(vk::Extent2D{ (previous.width + 1U) / 2U, (previous.height + 1U) / 2U }));
+    }
+
+    return &entry->levels;
+}
+
+BlurLevel BlurCache::_createLevel(vk::Extent2D extent) const
+{
+    ComputeImageConfig imageConfig = {
+        .commandPool = mCommandPool,
+        .width = extent.width,
+        .height = extent.height,
+        .format = mFormat,
+    };
+
+    TextureImage image{ mDevice, imageConfig };
+    TextureImage temp{ mDevice, imageConfig };
+
+    auto createPassSet = [this](const TextureImage& input, const TextureImage& output) {
+        std::vector<DescriptorSetImage> images{
+            DescriptorSetImage{
+                .binding = 0U,
+                .texture = input,
+                .layout = vk::ImageLayout::eGeneral,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+            },
+            DescriptorSetImage{
+                .binding = 1U,
+                .texture = output,
+                .layout = vk::ImageLayout::eGeneral,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+            },
+        };
+
+        DescriptorSet set{ mDevice, DescriptorSetConfig{ .descriptorLayout = mLevelLayout, .descriptorPool = mDescriptorPool } };
+        set.update(DescriptorUpdateConfig{ .images = images });
+
+        return set;
+    };
+
+    auto forwardSet = createPassSet(image, temp);
+    auto backwardSet = createPassSet(temp, image);
+
+    std::vector<DescriptorSetImage> sampleImages{
+        DescriptorSetImage{
+            .binding = 0U,
+            .texture = image,
+            .sampler = &mSampler,
+            .layout = vk::ImageLayout::eGeneral,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        },
+    };
+
+    DescriptorSet sampleSet{ mDevice, DescriptorSetConfig{ .descriptorLayout = mSampleLayout, .descriptorPool = mDescriptorPool } };
+    sampleSet.update(DescriptorUpdateConfig{ .images = sampleImages });
+
+    return BlurLevel{
+        .image = std::move(image),
+        .temp = std::move(temp),
+        .forwardSet = std::move(forwardSet),
+        .backwardSet = std::move(backwardSet),
+        .sampleSet = std::move(sampleSet),
+    };
+}
+
+bool BlurCache::_isEvictable(const Entry& entry) const noexcept
+{
+    return entry.lastUsedFrame <= mCompletedFrame;
+}
+
+void BlurCache::_touch(EntryList::iterator it)
+{
+    it->lastUsedFrame = mFrame;
+    mEntries.splice(mEntries.begin(), mEntries, it);
+}
+
+uint64_t BlurCache::_toKey(vk::Extent2D extent) noexcept
+{
+    return (uint64_t{ extent.width } << 32U) | extent.height;
+}
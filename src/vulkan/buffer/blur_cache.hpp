@@ -0,0 +1,97 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/include.hpp>
+#include <vulkan/sampler.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/texture.hpp>
+#include <vulkan/descriptor/descriptor_layout.hpp>
+#include <vulkan/descriptor/descriptor_pool.hpp>
+#include <vulkan/descriptor/descriptor_set.hpp>
+
+class Device;
+
+struct BlurCacheConfig
+{
+    const CommandPool& commandPool;
+    const DescriptorPool& descriptorPool;
+
+    const DescriptorLayout& levelLayout;
+    const DescriptorLayout& sampleLayout;
+    const Sampler& sampler;
+
+    WorkingFormat format;
+
+    // Number of pyramids, one per image resolution, kept alive at once
+    uint32_t capacity;
+
+    // Halvings a single pyramid can hold
+    uint32_t maxLevels;
+};
+
+// One level of a blur pyramid, half the size of the previous one
+struct BlurLevel
+{
+    TextureImage image;
+    TextureImage temp;
+
+    // {image, temp} and {temp, image} for the separable passes
+    DescriptorSet forwardSet;
+    DescriptorSet backwardSet;
+    // Samples the image bilinearly for the upsample pass
+    DescriptorSet sampleSet;
+};
+
+// Downsampled images for large blur radii, keyed by the resolution they were halved from.
+// Levels are only allocated once a radius needs them.
+class BlurCache
+{
+public:
+    BlurCache(const Device& device, const BlurCacheConfig& config);
+
+    // Entries last used by `completedFrame` or an earlier frame are no longer read by the GPU
+    void beginFrame(uint64_t frame, uint64_t completedFrame);
+
+    // Returns at least `levelCount` levels of the pyramid for images of `extent`,
+    // or nullptr when every pyramid of another resolution may still be in use
+    [[nodiscard]] const std::vector<BlurLevel>* acquire(vk::Extent2D extent, uint32_t levelCount);
+private:
+    struct Entry
+    {
+        vk::Extent2D extent;
+        std::vector<BlurLevel> levels;
+        uint64_t lastUsedFrame;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    BlurLevel _createLevel(vk::Extent2D extent) const;
+
+    bool _isEvictable(const Entry& entry) const noexcept;
+    void _touch(EntryList::iterator it);
+
+    static uint64_t _toKey(vk::Extent2D extent) noexcept;
+
+    const Device& mDevice;
+    const CommandPool& mCommandPool;
+    const DescriptorPool& mDescriptorPool;
+
+    const DescriptorLayout& mLevelLayout;
+    const DescriptorLayout& mSampleLayout;
+    const Sampler& mSampler;
+
+    WorkingFormat mFormat;
+    uint32_t mCapacity;
+    uint32_t mMaxLevels;
+
+    uint64_t mFrame = 0U;
+    uint64_t mCompletedFrame = 0U;
+
+    // Front is the most recently used entry
+    EntryList mEntries;
+    std::unordered_map<uint64_t, EntryList::iterator> mLookup;
+};
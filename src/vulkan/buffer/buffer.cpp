@@ -1,14 +1,13 @@
 #include "buffer.hpp"
 
 #include <vulkan/device.hpp>
-#include <vulkan/buffer/commandbuffer.hpp>
+#include <vulkan/buffer/uploader.hpp>
 
 Buffer::Buffer(const Device& device, const BufferConfig& config)
     : mDevice{ device }
     , mCommandPool{ config.commandPool }
 {
     const auto deviceHandle = device.getVkHandle();
-    const auto physicalDevice = device.getPhysicalDevice();
 
     vk::BufferCreateInfo bufferInfo{};
     bufferInfo.setSize(config.size);
@@ -17,46 +16,19 @@ Buffer::Buffer(const Device& device, const BufferConfig& config)
 
     mBuffer = deviceHandle.createBufferUnique(bufferInfo);
 
-    vk::MemoryRequirements memoryRequirements = deviceHandle.getBufferMemoryRequirements(mBuffer.get());
-
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.setAllocationSize(memoryRequirements.size);
-    allocInfo.setMemoryTypeIndex(findMemoryType(physicalDevice, memoryRequirements.memoryTypeBits, config.properties));
-
-    mMemory = deviceHandle.allocateMemoryUnique(allocInfo);
-    deviceHandle.bindBufferMemory(mBuffer.get(), mMemory.get(), 0U);
-}
-
-void Buffer::copy(const Buffer& dstBuffer, vk::DeviceSize size) const
-{
-    auto commandBuffer = SingleTimeCommandBuffer{ mDevice, mCommandPool };
-
-    vk::BufferCopy region{};
-    region.setSrcOffset(0U);
-    region.setDstOffset(0U);
-    region.setSize(size);
-    
-    commandBuffer.getVkHandle().copyBuffer(mBuffer.get(), dstBuffer.getVkHandle(), region);
-}
-
-void Buffer::copyToImage(vk::Image image, uint32_t width, uint32_t height) const
-{
-    auto commandBuffer = SingleTimeCommandBuffer{ mDevice, mCommandPool };
-
-    vk::BufferImageCopy region{};
-    region.setBufferOffset(0U);
-    region.setBufferRowLength(0U);
-    region.setBufferImageHeight(0U);
-
-    region.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
-    region.imageSubresource.setMipLevel(0U);
-    region.imageSubresource.setBaseArrayLayer(0U);
-    region.imageSubresource.setLayerCount(1U);
+    MemoryRequest request = {
+        .requirements = deviceHandle.getBufferMemoryRequirements(mBuffer.get()),
+        .properties = config.properties,
+        .linear = true,
+    };
 
-    region.setImageOffset(vk::Offset3D{ 0, 0, 0 });
-    region.setImageExtent(vk::Extent3D{ width, height, 1U });
+    mMemory = device.getAllocator().allocate(request);
+    deviceHandle.bindBufferMemory(mBuffer.get(), mMemory.getMemory(), mMemory.getOffset());
 
-    commandBuffer.getVkHandle().copyBufferToImage(mBuffer.get(), image, vk::ImageLayout::eTransferDstOptimal, region);
+    // Host-visible blocks are mapped once by the allocator
+    if (config.persistentMap) {
+        mMappedData = mMemory.getMappedData();
+    }
 }
 
 const vk::Buffer Buffer::getVkHandle() const
@@ -66,40 +38,21 @@ const vk::Buffer Buffer::getVkHandle() const
 
 const vk::DeviceMemory Buffer::getMemory() const
 {
-    return mMemory.get();
+    return mMemory.getMemory();
 }
 
-uint32_t Buffer::findMemoryType(vk::PhysicalDevice physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties)
+vk::DeviceSize Buffer::getMemoryOffset() const noexcept
 {
-    auto memProperties = physicalDevice.getMemoryProperties();
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if (typeFilter & (1 << i)
-            && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-        {
-            return i;
-        }
-    }
+    return mMemory.getOffset();
+}
 
-    throw std::runtime_error("Failed to find suitable memory type.");
+void* Buffer::getMappedData() const noexcept
+{
+    return mMappedData;
 }
 
 Buffer Buffer::createTransitioned(const Device& device, const TransitionedBufferConfig& config)
 {
-    BufferConfig stagingBufferConfig = {
-        .size = config.size,
-        .usage = vk::BufferUsageFlagBits::eTransferSrc,
-        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-
-        .commandPool = config.commandPool,
-    };
-
-    Buffer stagingBuffer{ device, stagingBufferConfig };
-
-    void* data = device.getVkHandle().mapMemory(stagingBuffer.getMemory(), 0U, config.size, vk::MemoryMapFlags());
-    memcpy(data, config.data, static_cast<size_t>(config.size));
-    device.getVkHandle().unmapMemory(stagingBuffer.getMemory());
-
     BufferConfig bufferConfig = {
         .size = config.size,
         .usage = vk::BufferUsageFlagBits::eTransferDst | config.usage,
@@ -110,17 +63,30 @@ Buffer Buffer::createTransitioned(const Device& device, const TransitionedBuffer
 
     Buffer buffer{ device, bufferConfig };
 
-    stagingBuffer.copy(buffer, config.size);
+    auto dstStage = vk::PipelineStageFlags2{ vk::PipelineStageFlagBits2::eAllCommands };
+    auto dstAccess = vk::AccessFlags2{ vk::AccessFlagBits2::eMemoryRead };
+
+    if (config.usage == vk::BufferUsageFlagBits::eVertexBuffer) {
+        dstStage = vk::PipelineStageFlagBits2::eVertexAttributeInput;
+        dstAccess = vk::AccessFlagBits2::eVertexAttributeRead;
+    }
+    else if (config.usage == vk::BufferUsageFlagBits::eIndexBuffer) {
+        dstStage = vk::PipelineStageFlagBits2::eIndexInput;
+        dstAccess = vk::AccessFlagBits2::eIndexRead;
+    }
+
+    config.uploader.uploadBuffer(buffer, config.data, config.size, dstStage, dstAccess);
 
     return buffer;
 }
 
-Buffer Buffer::createVertex(const Device& device, const CommandPool& commandPool, const std::vector<Vertex>& vertices)
+Buffer Buffer::createVertex(const Device& device, const CommandPool& commandPool, Uploader& uploader, const std::vector<Vertex>& vertices)
 {
     vk::DeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
 
     TransitionedBufferConfig config = {
         .commandPool = commandPool,
+        .uploader = uploader,
 
         .size = bufferSize,
         .data = vertices.data(),
@@ -131,12 +97,13 @@ Buffer Buffer::createVertex(const Device& device, const CommandPool& commandPool
     return createTransitioned(device, config);
 }
 
-Buffer Buffer::createIndex(const Device& device, const CommandPool& commandPool, const std::vector<uint32_t>& indices)
+Buffer Buffer::createIndex(const Device& device, const CommandPool& commandPool, Uploader& uploader, const std::vector<uint32_t>& indices)
 {
     vk::DeviceSize bufferSize = sizeof(indices[0]) * indices.size();
 
     TransitionedBufferConfig config = {
         .commandPool = commandPool,
+        .uploader = uploader,
 
         .size = bufferSize,
         .data = indices.data(),
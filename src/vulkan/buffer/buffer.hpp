@@ -3,6 +3,7 @@
 #include <vulkan/include.hpp>
 #include <vulkan/vertex.hpp>
 #include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/memory/allocator.hpp>
 
 struct BufferConfig
 {
@@ -11,11 +12,17 @@ struct BufferConfig
     vk::MemoryPropertyFlags properties;
 
     const CommandPool& commandPool;
+
+    // Keeps host-visible memory mapped for the lifetime of the buffer
+    bool persistentMap = false;
 };
 
+class Uploader;
+
 struct TransitionedBufferConfig
 {
     const CommandPool& commandPool;
+    Uploader& uploader;
 
     vk::DeviceSize size;
     const void* data;
@@ -30,21 +37,22 @@ class Buffer
 public:
     Buffer(const Device& device, const BufferConfig& config);
 
-    void copy(const Buffer& dstBuffer, vk::DeviceSize size) const;
-    void copyToImage(vk::Image image, uint32_t width, uint32_t height) const;
-
     const vk::Buffer getVkHandle() const;
     const vk::DeviceMemory getMemory() const;
+    // Buffers are sub-allocated, so the memory is shared with other resources from this offset on
+    [[nodiscard]] vk::DeviceSize getMemoryOffset() const noexcept;
+    void* getMappedData() const noexcept;
 
-    static uint32_t findMemoryType(vk::PhysicalDevice physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties);
-
+    // Device-local buffer filled through the uploader, usable once its next flush is waited on
     static Buffer createTransitioned(const Device& device, const TransitionedBufferConfig& config);
-    static Buffer createVertex(const Device& device, const CommandPool& commandPool, const std::vector<Vertex>& vertices);
-    static Buffer createIndex(const Device& device, const CommandPool& commandPool, const std::vector<uint32_t>& indices);
+    static Buffer createVertex(const Device& device, const CommandPool& commandPool, Uploader& uploader, const std::vector<Vertex>& vertices);
+    static Buffer createIndex(const Device& device, const CommandPool& commandPool, Uploader& uploader, const std::vector<uint32_t>& indices);
 private:
     const Device& mDevice;
     const CommandPool& mCommandPool;
 
+    MemoryAllocation mMemory;
     vk::UniqueBuffer mBuffer;
-    vk::UniqueDeviceMemory mMemory;
+
+    void* mMappedData = nullptr;
 };
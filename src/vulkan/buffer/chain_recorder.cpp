@@ -0,0 +1,634 @@
+#include "chain_recorder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#include <effect/chain.hpp>
+#include <effect/registry.hpp>
+#include <vulkan/buffer/blur_cache.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/lut_cache.hpp>
+#include <vulkan/buffer/stage_cache.hpp>
+#include <vulkan/query/gpu_profiler.hpp>
+
+// Pixels per axis each workgroup of shaders/stats_reduce.glsl covers
+static const uint32_t gStatsGroupExtent = 64U;
+
+// Pixels per axis each workgroup of shaders/mip_downsample.glsl reduces to a single pixel
+static const uint32_t gMipGroupExtent = 64U;
+
+// Taps per side of a separable blur pass, larger radii blur a downsampled pyramid level instead
+static const float gMaxBlurTapRadius = 16.0F;
+
+static void _recordImageBarriers(vk::CommandBuffer buffer, const std::vector<vk::ImageMemoryBarrier2>& barriers)
+{
+    vk::DependencyInfo dependency{};
+    dependency.setImageMemoryBarriers(barriers);
+
+    buffer.pipelineBarrier2(dependency);
+}
+
+ChainRecorder::ChainRecorder(const ChainRecorderConfig& config)
+    : mConfig{ config }
+{
+}
+
+void ChainRecorder::beginFrame(uint64_t frame, uint64_t completedFrame)
+{
+    if (mConfig.stageCache != nullptr) mConfig.stageCache->beginFrame(frame, completedFrame);
+    if (mConfig.lutCache != nullptr) mConfig.lutCache->beginFrame(frame, completedFrame);
+    if (mConfig.blurCache != nullptr) mConfig.blurCache->beginFrame(frame, completedFrame);
+}
+
+bool ChainRecorder::isAvailable(const Effect& effect) const
+{
+    return effect.isFusable() || !effect.hasOwnPipeline() || mConfig.pipelineSet.effectPipelines.find(effect.getId()) != nullptr;
+}
+
+bool ChainRecorder::record(vk::CommandBuffer buffer, const EffectChain& chain, RenderImageSet& renderImages, const ComputeDescriptorSet& renderDescriptors, const Buffer& fusedOpBuffer, const ImageStatsTarget* resultStats)
+{
+    const auto& stages = chain.getStages();
+
+    // Restart from the longest chain prefix that is still cached
+    size_t startStage = 0U;
+    const TextureImage* cachedImage = nullptr;
+
+    if (mConfig.stageCache != nullptr) {
+        for (size_t i = stages.size(); i-- > 1U;) {
+            cachedImage = mConfig.stageCache->find(chain.getPrefixHash(i));
+
+            if (cachedImage != nullptr) {
+                startStage = i;
+                break;
+            }
+        }
+    }
+
+    // Retain the input of the first stage that differs from the previous evaluation,
+    // so that further edits of that stage only recompute from there
+    size_t storeStage = _findFirstChangedStage(chain) - 1U;
+    if (storeStage >= stages.size() || mConfig.stageCache == nullptr) storeStage = 0U;
+
+    mLastPrefixHashes = chain.getPrefixHashes();
+
+    uint32_t groupsX = (renderImages.original.getWidth() + 15U) / 16U;
+    uint32_t groupsY = (renderImages.original.getHeight() + 15U) / 16U;
+
+    if (cachedImage != nullptr) {
+        std::array copyBarriers{ cachedImage->createComputeToTransfer(), renderImages.ping.createComputeToTransfer() };
+
+        vk::DependencyInfo copyBarrier{};
+        copyBarrier.setImageMemoryBarriers(copyBarriers);
+        buffer.pipelineBarrier2(copyBarrier);
+
+        auto timing = _beginTiming(buffer, "Stage cache restore");
+        cachedImage->recordCopy(buffer, renderImages.ping);
+        _endTiming(buffer, timing);
+
+        auto pingBarrier = renderImages.ping.createTransferToCompute();
+        vk::DependencyInfo prepBarrier{};
+        prepBarrier.setImageMemoryBarriers(pingBarrier);
+
+        buffer.pipelineBarrier2(prepBarrier);
+    }
+    else {
+        // Sampler pipeline
+        auto timing = _beginTiming(buffer, "Sampler");
+
+        buffer.bindPipeline(vk::PipelineBindPoint::eCompute, mConfig.samplerPipeline.getVkHandle());
+
+        auto samplerDescSet = renderDescriptors.sampler.getVkHandle();
+        vk::BindDescriptorSetsInfo samplerBindInfo{};
+        samplerBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        samplerBindInfo.setLayout(mConfig.samplerPipeline.getLayout());
+        samplerBindInfo.setDescriptorSets(samplerDescSet);
+        samplerBindInfo.setFirstSet(0U);
+        samplerBindInfo.setDynamicOffsets(nullptr);
+        buffer.bindDescriptorSets2(samplerBindInfo);
+
+        buffer.dispatch(groupsX, groupsY, 1U);
+
+        _endTiming(buffer, timing);
+
+        auto pingBarrier = renderImages.ping.createWriteToRead();
+        vk::DependencyInfo prepBarrier{};
+        prepBarrier.setImageMemoryBarriers(pingBarrier);
+
+        buffer.pipelineBarrier2(prepBarrier);
+    }
+
+    // Effects pipeline
+    auto* readImage = &renderImages.ping;
+    auto* writeImage = &renderImages.pong;
+    bool pingToPong = true;
+
+    auto* fusedOps = static_cast<FusedOp*>(fusedOpBuffer.getMappedData());
+    uint32_t fusedOpCount = 0U;
+
+    for (const auto& step : chain.plan(startStage, storeStage)) {
+        const auto stepCount = static_cast<uint32_t>(step.end - step.begin);
+
+        const DescriptorSet* lutDescriptor = nullptr;
+        if (step.type == ChainStepType::Lut && mConfig.lutCache != nullptr) {
+            lutDescriptor = mConfig.lutCache->acquire(buffer, chain.getRunHash(step.begin, step.end), chain.getFusedOps(step.begin, step.end));
+        }
+
+        // LUT runs fall back to fusion while every LUT is in use, and fusion
+        // falls back to separate dispatches once the op buffer of this frame is full
+        if (lutDescriptor != nullptr) {
+            const auto& descriptor = pingToPong ? renderDescriptors.computeAtoB : renderDescriptors.computeBtoA;
+
+            auto timing = _beginTiming(buffer, std::format("{}-{}. LUT", step.begin + 1U, step.end));
+            _recordLut(buffer, descriptor, *lutDescriptor, groupsX, groupsY);
+            _endTiming(buffer, timing);
+        }
+        else if (step.type != ChainStepType::Single && fusedOpCount + stepCount <= mConfig.fusedOpCapacity) {
+            for (size_t i = step.begin; i < step.end; i++) {
+                fusedOps[fusedOpCount + i - step.begin] = chain.getFusedOp(i);
+            }
+
+            const auto& descriptor = pingToPong ? renderDescriptors.fusedAtoB : renderDescriptors.fusedBtoA;
+
+            auto timing = _beginTiming(buffer, std::format("{}-{}. Fused", step.begin + 1U, step.end));
+            _recordFused(buffer, fusedOpCount, stepCount, descriptor, groupsX, groupsY);
+            _endTiming(buffer, timing);
+
+            fusedOpCount += stepCount;
+        }
+        else if (step.type == ChainStepType::Single && _isPendingFusable(*stages.at(step.begin)) && fusedOpCount < mConfig.fusedOpCapacity) {
+            // A lone fusable stage doesn't wait for its own pipeline, the fused kernel computes the same result
+            fusedOps[fusedOpCount] = chain.getFusedOp(step.begin);
+
+            const auto& descriptor = pingToPong ? renderDescriptors.fusedAtoB : renderDescriptors.fusedBtoA;
+
+            auto timing = _beginTiming(buffer, std::format("{}. {}", step.begin + 1U, stages.at(step.begin)->effect->getDisplayName()));
+            _recordFused(buffer, fusedOpCount, 1U, descriptor, groupsX, groupsY);
+            _endTiming(buffer, timing);
+
+            fusedOpCount++;
+        }
+        else {
+            for (size_t i = step.begin; i < step.end; i++) {
+                const auto& descriptor = pingToPong ? renderDescriptors.computeAtoB : renderDescriptors.computeBtoA;
+
+                auto timing = _beginTiming(buffer, std::format("{}. {}", i + 1U, stages.at(i)->effect->getDisplayName()));
+
+                if (!stages.at(i)->effect->hasOwnPipeline()) {
+                    const auto& backward = pingToPong ? renderDescriptors.computeBtoA : renderDescriptors.computeAtoB;
+                    _recordBlur(buffer, *stages.at(i), *readImage, *writeImage, descriptor, backward);
+
+                    // The blur composites into its input, so the barriers and the swap below must see the images exchanged
+                    std::swap(readImage, writeImage);
+                    pingToPong = !pingToPong;
+                }
+                else {
+                    if (stages.at(i)->effect->readsImageStats()) {
+                        recordStats(buffer, descriptor, readImage->getExtent(), mConfig.effectStats);
+                    }
+
+                    _recordEffect(buffer, *stages.at(i), descriptor, groupsX, groupsY);
+                }
+
+                _endTiming(buffer, timing);
+
+                if (i + 1U == step.end) break;
+
+                std::array barriers{ readImage->createReadToWrite(), writeImage->createWriteToRead() };
+
+                vk::DependencyInfo pingPongBarriers{};
+                pingPongBarriers.setImageMemoryBarriers(barriers);
+
+                buffer.pipelineBarrier2(pingPongBarriers);
+
+                std::swap(readImage, writeImage);
+                pingToPong = !pingToPong;
+            }
+        }
+
+        auto readBarrier = readImage->createReadToWrite();
+        auto writeBarrier = writeImage->createWriteToRead();
+        std::array barriers{ readBarrier, writeBarrier };
+
+        vk::DependencyInfo pingPongBarriers{};
+        pingPongBarriers.setImageMemoryBarriers(barriers);
+
+        buffer.pipelineBarrier2(pingPongBarriers);
+
+        std::swap(readImage, writeImage);
+        pingToPong = !pingToPong;
+
+        if (step.end == storeStage) {
+            _recordStore(buffer, *readImage, chain.getPrefixHash(storeStage));
+        }
+    }
+
+    if (resultStats != nullptr) {
+        const auto& descriptor = pingToPong ? renderDescriptors.computeAtoB : renderDescriptors.computeBtoA;
+
+        auto timing = _beginTiming(buffer, "Statistics");
+        recordStats(buffer, descriptor, readImage->getExtent(), *resultStats);
+        _endTiming(buffer, timing);
+    }
+
+    return readImage == &renderImages.pong;
+}
+
+void ChainRecorder::recordStats(vk::CommandBuffer buffer, const DescriptorSet& imageDescriptor, vk::Extent2D extent, const ImageStatsTarget& target) const
+{
+    const auto statsBuffer = target.buffer.getVkHandle();
+
+    // Earlier reductions into the buffer and their readers are done before it is cleared
+    vk::BufferMemoryBarrier2 clearBarrier{};
+    clearBarrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    clearBarrier.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    clearBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    clearBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    clearBarrier.setBuffer(statsBuffer);
+    clearBarrier.setOffset(0U);
+    clearBarrier.setSize(vk::WholeSize);
+
+    vk::DependencyInfo clearDependency{};
+    clearDependency.setBufferMemoryBarriers(clearBarrier);
+    buffer.pipelineBarrier2(clearDependency);
+
+    // Minimums start from the largest ordered value, everything else from zero. The ranges
+    // don't overlap, so the fills need no barrier between them.
+    const vk::DeviceSize minOffset = offsetof(GpuImageStats, minBits);
+    const vk::DeviceSize maxOffset = offsetof(GpuImageStats, maxBits);
+
+    buffer.fillBuffer(statsBuffer, 0U, minOffset, 0U);
+    buffer.fillBuffer(statsBuffer, minOffset, maxOffset - minOffset, 0xFFFFFFFFU);
+    buffer.fillBuffer(statsBuffer, maxOffset, vk::WholeSize, 0U);
+
+    vk::BufferMemoryBarrier2 reduceBarrier{};
+    reduceBarrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    reduceBarrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    reduceBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    reduceBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    reduceBarrier.setBuffer(statsBuffer);
+    reduceBarrier.setOffset(0U);
+    reduceBarrier.setSize(vk::WholeSize);
+
+    vk::DependencyInfo reduceDependency{};
+    reduceDependency.setBufferMemoryBarriers(reduceBarrier);
+    buffer.pipelineBarrier2(reduceDependency);
+
+    const auto& pipeline = mConfig.pipelineSet.statsReducePipeline;
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    std::array statsDescSets{ imageDescriptor.getVkHandle(), target.descriptorSet.getVkHandle() };
+    vk::BindDescriptorSetsInfo statsBindInfo{};
+    statsBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    statsBindInfo.setLayout(pipeline.getLayout());
+    statsBindInfo.setDescriptorSets(statsDescSets);
+    statsBindInfo.setFirstSet(0U);
+    statsBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(statsBindInfo);
+
+    buffer.dispatch((extent.width + gStatsGroupExtent - 1U) / gStatsGroupExtent, (extent.height + gStatsGroupExtent - 1U) / gStatsGroupExtent, 1U);
+
+    // Read by the following effect, or by the host after the submission's semaphore was waited on
+    vk::BufferMemoryBarrier2 readBarrier{};
+    readBarrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite);
+    readBarrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eHostRead);
+    readBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    readBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eHost);
+    readBarrier.setBuffer(statsBuffer);
+    readBarrier.setOffset(0U);
+    readBarrier.setSize(vk::WholeSize);
+
+    vk::DependencyInfo readDependency{};
+    readDependency.setBufferMemoryBarriers(readBarrier);
+    buffer.pipelineBarrier2(readDependency);
+}
+
+void ChainRecorder::recordMips(vk::CommandBuffer buffer, const RenderImageSet& renderImages, const MipChainDescriptorSet& mips, bool resultInPong) const
+{
+    const auto& image = resultInPong ? renderImages.pong : renderImages.ping;
+
+    if (image.getMipLevels() <= 1U) {
+        return;
+    }
+
+    auto timing = _beginTiming(buffer, "Mip chain");
+
+    const auto counterBuffer = mips.counter.getVkHandle();
+
+    // The previous downsample finished with the counter before it is zeroed
+    vk::BufferMemoryBarrier2 clearBarrier{};
+    clearBarrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    clearBarrier.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    clearBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    clearBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    clearBarrier.setBuffer(counterBuffer);
+    clearBarrier.setOffset(0U);
+    clearBarrier.setSize(vk::WholeSize);
+
+    vk::DependencyInfo clearDependency{};
+    clearDependency.setBufferMemoryBarriers(clearBarrier);
+    buffer.pipelineBarrier2(clearDependency);
+
+    buffer.fillBuffer(counterBuffer, 0U, vk::WholeSize, 0U);
+
+    vk::BufferMemoryBarrier2 countBarrier{};
+    countBarrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    countBarrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    countBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    countBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    countBarrier.setBuffer(counterBuffer);
+    countBarrier.setOffset(0U);
+    countBarrier.setSize(vk::WholeSize);
+
+    vk::DependencyInfo countDependency{};
+    countDependency.setBufferMemoryBarriers(countBarrier);
+    buffer.pipelineBarrier2(countDependency);
+
+    const auto& pipeline = mConfig.pipelineSet.mipDownsamplePipeline;
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    auto mipDescSet = (resultInPong ? mips.pong : mips.ping).getVkHandle();
+    vk::BindDescriptorSetsInfo mipBindInfo{};
+    mipBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    mipBindInfo.setLayout(pipeline.getLayout());
+    mipBindInfo.setDescriptorSets(mipDescSet);
+    mipBindInfo.setFirstSet(0U);
+    mipBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(mipBindInfo);
+
+    // Levels below the full resolution one
+    std::array pushValues = { static_cast<int32_t>(image.getMipLevels() - 1U) };
+
+    vk::PushConstantsInfo pushConstInfo{};
+    pushConstInfo.setLayout(pipeline.getLayout());
+    pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    pushConstInfo.setOffset(0U);
+    pushConstInfo.setValues<int32_t>(pushValues);
+
+    buffer.pushConstants2(pushConstInfo);
+
+    const auto extent = image.getExtent();
+    buffer.dispatch((extent.width + gMipGroupExtent - 1U) / gMipGroupExtent, (extent.height + gMipGroupExtent - 1U) / gMipGroupExtent, 1U);
+
+    _endTiming(buffer, timing);
+}
+
+void ChainRecorder::_recordEffect(vk::CommandBuffer buffer, const EffectInstance& effect, const DescriptorSet& descriptor, uint32_t groupsX, uint32_t groupsY) const
+{
+    const auto& id = effect.effect->getId();
+    // Only blocks for effects the caller didn't check with isAvailable, or once the op buffer is full
+    const auto& pipeline = mConfig.pipelineSet.effectPipelines.get(id);
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    // Effects reading statistics get the ones recordStats reduced from their input as set 1
+    std::vector<vk::DescriptorSet> computeDescSets{ descriptor.getVkHandle() };
+    if (effect.effect->readsImageStats()) {
+        computeDescSets.push_back(mConfig.effectStats.descriptorSet.getVkHandle());
+    }
+
+    vk::BindDescriptorSetsInfo computeBindInfo{};
+    computeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    computeBindInfo.setLayout(pipeline.getLayout());
+    computeBindInfo.setDescriptorSets(computeDescSets);
+    computeBindInfo.setFirstSet(0U);
+    computeBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(computeBindInfo);
+
+    if (effect.params.size() > 0U) {
+        auto pushValues = effect.getParamValues();
+
+        vk::PushConstantsInfo pushConstInfo{};
+        pushConstInfo.setLayout(pipeline.getLayout());
+        pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        pushConstInfo.setOffset(0U);
+        pushConstInfo.setValues<float>(pushValues);
+
+        buffer.pushConstants2(pushConstInfo);
+    }
+
+    buffer.dispatch(groupsX, groupsY, 1U);
+}
+
+void ChainRecorder::_recordFused(vk::CommandBuffer buffer, uint32_t opOffset, uint32_t opCount, const DescriptorSet& descriptor, uint32_t groupsX, uint32_t groupsY) const
+{
+    const auto& pipeline = mConfig.pipelineSet.fusedPipeline;
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    auto computeDescSet = descriptor.getVkHandle();
+    vk::BindDescriptorSetsInfo computeBindInfo{};
+    computeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    computeBindInfo.setLayout(pipeline.getLayout());
+    computeBindInfo.setDescriptorSets(computeDescSet);
+    computeBindInfo.setFirstSet(0U);
+    computeBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(computeBindInfo);
+
+    std::array pushValues = { opOffset, opCount };
+
+    vk::PushConstantsInfo pushConstInfo{};
+    pushConstInfo.setLayout(pipeline.getLayout());
+    pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    pushConstInfo.setOffset(0U);
+    pushConstInfo.setValues<uint32_t>(pushValues);
+
+    buffer.pushConstants2(pushConstInfo);
+
+    buffer.dispatch(groupsX, groupsY, 1U);
+}
+
+void ChainRecorder::_recordLut(vk::CommandBuffer buffer, const DescriptorSet& descriptor, const DescriptorSet& lutDescriptor, uint32_t groupsX, uint32_t groupsY) const
+{
+    const auto& pipeline = mConfig.pipelineSet.lutApplyPipeline;
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    std::array computeDescSets{ descriptor.getVkHandle(), lutDescriptor.getVkHandle() };
+    vk::BindDescriptorSetsInfo computeBindInfo{};
+    computeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    computeBindInfo.setLayout(pipeline.getLayout());
+    computeBindInfo.setDescriptorSets(computeDescSets);
+    computeBindInfo.setFirstSet(0U);
+    computeBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(computeBindInfo);
+
+    buffer.dispatch(groupsX, groupsY, 1U);
+}
+
+void ChainRecorder::_recordBlur(vk::CommandBuffer buffer, const EffectInstance& effect, const TextureImage& readImage, const TextureImage& writeImage, const DescriptorSet& forward, const DescriptorSet& backward) const
+{
+    const auto& pipelines = mConfig.pipelineSet;
+    const auto values = effect.getParamValues();
+    const auto extent = readImage.getExtent();
+
+    // The radius comes first, unsharp mask and glow follow it with an amount and a threshold
+    const float radius = std::max(values.at(0), 0.0F);
+
+    // Each halving keeps the taps per pass within the limit, so the cost per pixel stays flat as the radius grows
+    uint32_t levelCount = 0U;
+    while (levelCount < mConfig.blurMaxLevels && radius > gMaxBlurTapRadius * static_cast<float>(1U << levelCount)) {
+        levelCount++;
+    }
+
+    const std::vector<BlurLevel>* levels = nullptr;
+    if (levelCount > 0U && mConfig.blurCache != nullptr) {
+        levels = mConfig.blurCache->acquire(extent, levelCount);
+
+        // Blurring less than asked would make the result depend on what else is in flight
+        if (levels == nullptr) {
+            throw std::runtime_error("Every blur pyramid is still in use, the blur cache is smaller than the chains in flight.");
+        }
+    }
+
+    // Without a cache the radius is capped to what the direct passes cover
+    if (levels == nullptr) levelCount = 0U;
+
+    const float levelRadius = std::min(radius / static_cast<float>(1U << levelCount), gMaxBlurTapRadius);
+
+    // Three sigmas span the radius, beyond that the weights are negligible
+    BlurPassConstants horizontal{
+        .directionX = 1,
+        .directionY = 0,
+        .sigma = levelRadius / 3.0F,
+        .radius = static_cast<int32_t>(std::ceil(levelRadius)),
+    };
+
+    BlurApplyConstants apply{
+        .sigma = horizontal.sigma,
+        .radius = horizontal.radius,
+        .mode = effect.effect->getBlurMode().value_or(EffectBlurModes::Gaussian),
+        .amount = values.size() > 1U ? values.at(1) : 1.0F,
+        .threshold = values.size() > 2U ? values.at(2) : 0.0F,
+        .level = static_cast<int32_t>(levelCount),
+    };
+
+    if (levelCount == 0U) {
+        _recordBlurDispatch(buffer, pipelines.blurPassPipeline, { forward.getVkHandle() }, &horizontal, sizeof(horizontal), extent);
+        _recordImageBarriers(buffer, { writeImage.createWriteToRead(), readImage.createReadToWrite() });
+
+        // Blurs vertically out of the write image and composites over the read image in place
+        _recordBlurDispatch(buffer, pipelines.blurApplyPipeline, { backward.getVkHandle() }, &apply, sizeof(apply), extent);
+        return;
+    }
+
+    // Earlier blurs may still read or write the pyramid images
+    vk::MemoryBarrier2 reuseBarrier{};
+    reuseBarrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    reuseBarrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageWrite);
+    reuseBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    reuseBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+
+    vk::DependencyInfo reuseDependency{};
+    reuseDependency.setMemoryBarriers(reuseBarrier);
+    buffer.pipelineBarrier2(reuseDependency);
+
+    for (uint32_t i = 0; i < levelCount; i++) {
+        const auto& level = levels->at(i);
+        const auto& source = i == 0U ? forward : levels->at(i - 1U).forwardSet;
+
+        _recordBlurDispatch(buffer, pipelines.blurDownPipeline, { source.getVkHandle(), level.forwardSet.getVkHandle() }, nullptr, 0U, level.image.getExtent());
+        _recordImageBarriers(buffer, { level.image.createWriteToRead() });
+    }
+
+    const auto& last = levels->at(levelCount - 1U);
+    const auto levelExtent = last.image.getExtent();
+
+    _recordBlurDispatch(buffer, pipelines.blurPassPipeline, { last.forwardSet.getVkHandle() }, &horizontal, sizeof(horizontal), levelExtent);
+    _recordImageBarriers(buffer, { last.temp.createWriteToRead(), last.image.createReadToWrite() });
+
+    BlurPassConstants vertical = horizontal;
+    vertical.directionX = 0;
+    vertical.directionY = 1;
+
+    _recordBlurDispatch(buffer, pipelines.blurPassPipeline, { last.backwardSet.getVkHandle() }, &vertical, sizeof(vertical), levelExtent);
+    _recordImageBarriers(buffer, { last.image.createWriteToSample(), readImage.createReadToWrite() });
+
+    // Upsamples the blurred level and composites over the read image in place
+    _recordBlurDispatch(buffer, pipelines.blurUpsamplePipeline, { backward.getVkHandle(), last.sampleSet.getVkHandle() }, &apply, sizeof(apply), extent);
+}
+
+void ChainRecorder::_recordBlurDispatch(vk::CommandBuffer buffer, const ComputePipeline& pipeline, const std::vector<vk::DescriptorSet>& descriptors, const void* pushValues, uint32_t pushSize, vk::Extent2D extent) const
+{
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+
+    vk::BindDescriptorSetsInfo computeBindInfo{};
+    computeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    computeBindInfo.setLayout(pipeline.getLayout());
+    computeBindInfo.setDescriptorSets(descriptors);
+    computeBindInfo.setFirstSet(0U);
+    computeBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(computeBindInfo);
+
+    if (pushSize > 0U) {
+        vk::PushConstantsInfo pushConstInfo{};
+        pushConstInfo.setLayout(pipeline.getLayout());
+        pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+        pushConstInfo.setOffset(0U);
+        pushConstInfo.setSize(pushSize);
+        pushConstInfo.setPValues(pushValues);
+
+        buffer.pushConstants2(pushConstInfo);
+    }
+
+    buffer.dispatch((extent.width + 15U) / 16U, (extent.height + 15U) / 16U, 1U);
+}
+
+bool ChainRecorder::_isPendingFusable(const EffectInstance& instance) const
+{
+    return instance.effect->isFusable() && mConfig.pipelineSet.effectPipelines.find(instance.effect->getId()) == nullptr;
+}
+
+size_t ChainRecorder::_findFirstChangedStage(const EffectChain& chain) const
+{
+    const auto& prefixHashes = chain.getPrefixHashes();
+
+    size_t stage = 1U;
+    while (stage < prefixHashes.size()
+        && stage < mLastPrefixHashes.size()
+        && prefixHashes.at(stage) == mLastPrefixHashes.at(stage))
+    {
+        stage++;
+    }
+
+    return stage;
+}
+
+void ChainRecorder::_recordStore(vk::CommandBuffer buffer, const TextureImage& image, size_t prefixHash)
+{
+    const auto* cacheImage = mConfig.stageCache->store(buffer, prefixHash);
+    if (cacheImage == nullptr) return;
+
+    std::array copyBarriers{ image.createComputeToTransfer(), cacheImage->createComputeToTransfer() };
+
+    vk::DependencyInfo copyBarrier{};
+    copyBarrier.setImageMemoryBarriers(copyBarriers);
+    buffer.pipelineBarrier2(copyBarrier);
+
+    auto timing = _beginTiming(buffer, "Stage cache store");
+    image.recordCopy(buffer, *cacheImage);
+    _endTiming(buffer, timing);
+
+    auto imageBarrier = image.createTransferToCompute();
+    vk::DependencyInfo computeBarrier{};
+    computeBarrier.setImageMemoryBarriers(imageBarrier);
+    buffer.pipelineBarrier2(computeBarrier);
+}
+
+std::optional<uint32_t> ChainRecorder::_beginTiming(vk::CommandBuffer buffer, std::string name) const
+{
+    if (mConfig.profiler == nullptr) return std::nullopt;
+
+    return mConfig.profiler->begin(buffer, std::move(name));
+}
+
+void ChainRecorder::_endTiming(vk::CommandBuffer buffer, std::optional<uint32_t> scope) const
+{
+    if (mConfig.profiler != nullptr) mConfig.profiler->end(buffer, scope);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <effect/instance.hpp>
+
+#include <vulkan/include.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/texture.hpp>
+#include <vulkan/descriptor/descriptor_set.hpp>
+#include <vulkan/pipeline/compute_pipeline.hpp>
+#include <vulkan/pipeline/pipeline_set.hpp>
+#include <vulkan/query/image_stats.hpp>
+
+class BlurCache;
+class Effect;
+class EffectChain;
+class GpuProfiler;
+class LutCache;
+class StageCache;
+
+struct ComputeDescriptorSet
+{
+    DescriptorSet sampler;
+
+    DescriptorSet computeAtoB;
+    DescriptorSet computeBtoA;
+
+    DescriptorSet fusedAtoB;
+    DescriptorSet fusedBtoA;
+};
+
+// Downsample sets of a ping/pong pair whose images hold a mip chain, see ChainRecorder::recordMips
+struct MipChainDescriptorSet
+{
+    // Counts finished workgroups, so the last one can reduce the remaining levels
+    Buffer counter;
+
+    DescriptorSet ping;
+    DescriptorSet pong;
+};
+
+struct RenderImageSet
+{
+    const TextureImage& original;
+    TextureImage ping;
+    TextureImage pong;
+};
+
+// Push constants of shaders/blur_pass.glsl
+struct BlurPassConstants
+{
+    int32_t directionX;
+    int32_t directionY;
+    float sigma;
+    int32_t radius;
+};
+
+// Push constants of shaders/blur_apply.glsl and shaders/blur_upsample.glsl
+struct BlurApplyConstants
+{
+    float sigma;
+    int32_t radius;
+    uint32_t mode;
+    float amount;
+    float threshold;
+    int32_t level;
+};
+
+struct ChainRecorderConfig
+{
+    const ComputePipeline& samplerPipeline;
+    const PipelineSet& pipelineSet;
+
+    // Both optional, evaluation always starts from the original image without a stage cache
+    StageCache* stageCache;
+    LutCache* lutCache;
+    // Optional, large blur radii are capped to what the direct passes cover without it. Must hold a
+    // pyramid for every chain in flight, recording throws rather than blur less than asked.
+    BlurCache* blurCache;
+    // Statistics of the input of each effect that reads them
+    const ImageStatsTarget& effectStats;
+    // Optional, times the sampler pass and every chain step
+    GpuProfiler* profiler;
+
+    uint32_t fusedOpCapacity;
+    // Halvings the blur cache holds per pyramid
+    uint32_t blurMaxLevels;
+};
+
+// Records the compute passes evaluating an effect chain over a ping/pong image pair
+class ChainRecorder
+{
+public:
+    explicit ChainRecorder(const ChainRecorderConfig& config);
+
+    // Frames are numbered by the caller, cached results of completed frames may be recycled
+    void beginFrame(uint64_t frame, uint64_t completedFrame);
+
+    // Whether `effect` can be recorded without waiting for a pipeline, queueing its build otherwise.
+    // Fusable effects always can, they run through the fused kernel until their own pipeline exists.
+    [[nodiscard]] bool isAvailable(const Effect& effect) const;
+
+    // Returns whether the result ended up in the pong image. With `resultStats`, the statistics of the
+    // result are reduced into it and made visible to the host once the submission completes.
+    bool record(vk::CommandBuffer buffer, const EffectChain& chain, RenderImageSet& renderImages, const ComputeDescriptorSet& renderDescriptors, const Buffer& fusedOpBuffer, const ImageStatsTarget* resultStats = nullptr);
+
+    // Reduces the image bound to binding 0 of `imageDescriptor`, which must be readable by compute shaders
+    void recordStats(vk::CommandBuffer buffer, const DescriptorSet& imageDescriptor, vk::Extent2D extent, const ImageStatsTarget& target) const;
+
+    // Downsamples the result of `record` into the rest of its mip chain in a single dispatch. The levels
+    // are left for the same barriers as the first one, so nothing is recorded for single-level images.
+    void recordMips(vk::CommandBuffer buffer, const RenderImageSet& renderImages, const MipChainDescriptorSet& mips, bool resultInPong) const;
+private:
+    void _recordEffect(vk::CommandBuffer buffer, const EffectInstance& effect, const DescriptorSet& descriptor, uint32_t groupsX, uint32_t groupsY) const;
+    void _recordFused(vk::CommandBuffer buffer, uint32_t opOffset, uint32_t opCount, const DescriptorSet& descriptor, uint32_t groupsX, uint32_t groupsY) const;
+    void _recordLut(vk::CommandBuffer buffer, const DescriptorSet& descriptor, const DescriptorSet& lutDescriptor, uint32_t groupsX, uint32_t groupsY) const;
+    // Leaves the result in `readImage`, the caller swaps the pointers so it continues from `writeImage` as usual
+    void _recordBlur(vk::CommandBuffer buffer, const EffectInstance& effect, const TextureImage& readImage, const TextureImage& writeImage, const DescriptorSet& forward, const DescriptorSet& backward) const;
+    void _recordBlurDispatch(vk::CommandBuffer buffer, const ComputePipeline& pipeline, const std::vector<vk::DescriptorSet>& descriptors, const void* pushValues, uint32_t pushSize, vk::Extent2D extent) const;
+    bool _isPendingFusable(const EffectInstance& instance) const;
+    size_t _findFirstChangedStage(const EffectChain& chain) const;
+    void _recordStore(vk::CommandBuffer buffer, const TextureImage& image, size_t prefixHash);
+
+    [[nodiscard]] std::optional<uint32_t> _beginTiming(vk::CommandBuffer buffer, std::string name) const;
+    void _endTiming(vk::CommandBuffer buffer, std::optional<uint32_t> scope) const;
+
+    ChainRecorderConfig mConfig;
+
+    // Prefix hashes of the most recently recomputed chain
+    std::vector<size_t> mLastPrefixHashes;
+};
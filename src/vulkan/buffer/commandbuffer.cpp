@@ -1,5 +1,7 @@
 #include "commandbuffer.hpp"
 
+#include <effect/chain.hpp>
+#include <trace/trace.hpp>
 #include <vulkan/device.hpp>
 #include <vulkan/renderpass.hpp>
 #include <vulkan/buffer/buffer.hpp>
@@ -23,95 +25,81 @@ CommandBuffer::CommandBuffer(const Device& device, const CommandBufferConfig& co
     , mConfig{ config }
 {
     mCommandBuffers = createCommandBuffers(device.getVkHandle(), config.commandPool.getVkHandle(), config.createCount);
+    mChainRecorded.resize(config.createCount, false);
+    mStatsRecorded.resize(config.createCount, false);
+    mChainStates.resize(config.createCount);
+
+    if (config.computeCommandPool != nullptr) {
+        mChainCommandBuffers = createCommandBuffers(device.getVkHandle(), config.computeCommandPool->getVkHandle(), config.createCount);
+    }
 }
 
-void CommandBuffer::record(uint32_t currentFrame, uint32_t imageIndex)
+std::optional<ReadbackTicket> CommandBuffer::record(uint32_t currentFrame, uint32_t imageIndex, bool readback)
 {
+    TRACE_SCOPE("Record");
+
     const auto& buffer = mCommandBuffers.at(currentFrame);
     auto& renderImages = mConfig.renderImages.at(currentFrame);
     const auto& renderDescriptors = mConfig.renderDescriptors.at(currentFrame);
+    auto& chainState = mChainStates.at(currentFrame);
+
+    mConfig.chainRecorder.beginFrame(mConfig.scheduler.getFrame(), mConfig.scheduler.getCompletedFrame());
 
     vk::CommandBufferBeginInfo beginInfo{};
     beginInfo.setFlags(vk::CommandBufferUsageFlags{});
     beginInfo.setPInheritanceInfo(nullptr);
 
-    buffer->begin(beginInfo);
-
-    // Sampler pipeline
-    buffer->bindPipeline(vk::PipelineBindPoint::eCompute, mConfig.samplerPipeline.getVkHandle());
-
-    auto samplerDescSet = renderDescriptors.sampler.getVkHandle();
-    vk::BindDescriptorSetsInfo samplerBindInfo{};
-    samplerBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
-    samplerBindInfo.setLayout(mConfig.samplerPipeline.getLayout());
-    samplerBindInfo.setDescriptorSets(samplerDescSet);
-    samplerBindInfo.setFirstSet(0U);
-    samplerBindInfo.setDynamicOffsets(nullptr);
-    buffer->bindDescriptorSets2(samplerBindInfo);
+    // When the images of this frame still hold the result of an identical chain,
+    // only the graphics pass needs to be recorded
+    // Effects whose pipeline is still building are passed through instead of stalling the frame,
+    // and the chain hash changes once they are ready
+    EffectChainOptions chainOptions = {
+        .useLut = mConfig.appData.useLut,
+        .isAvailable = [this](const Effect& effect) { return mConfig.chainRecorder.isAvailable(effect); },
+    };
 
-    uint32_t groupsX = (renderImages.original.getWidth() + 15U) / 16U;
-    uint32_t groupsY = (renderImages.original.getHeight() + 15U) / 16U;
-    buffer->dispatch(groupsX, groupsY, 1U);
+    EffectChain chain{ mConfig.appData.effects, chainOptions };
 
-    // Effects pipeline
-    auto pingBarrier = renderImages.ping.createWriteToRead();
-    vk::DependencyInfo prepBarrier{};
-    prepBarrier.setImageMemoryBarriers(pingBarrier);
+    const bool recordChain = chainState.chainHash != chain.getHash();
+    const bool asyncChain = recordChain && mConfig.computeCommandPool != nullptr;
 
-    buffer->pipelineBarrier2(prepBarrier);
+    mChainRecorded.at(currentFrame) = asyncChain;
 
-    auto* readImage = &renderImages.ping;
-    auto* writeImage = &renderImages.pong;
-
-    const auto* currentDescriptor = &renderDescriptors.computeAtoB;
-    const auto* nextDescriptor = &renderDescriptors.computeBtoA;
-
-    const auto* graphicsDescriptor = &renderDescriptors.graphicsA;
-    const auto* graphicsNextDescriptor = &renderDescriptors.graphicsB;
-
-    for (const auto& effect : mConfig.appData.effects) {
-        if (!effect.enabled) continue;
-
-        const auto& id = effect.effect->getId();
-        const auto& pipeline = mConfig.pipelineSet.effectPipelines.at(id);
-
-        buffer->bindPipeline(vk::PipelineBindPoint::eCompute, pipeline.getVkHandle());
+    buffer->begin(beginInfo);
 
-        auto computeDescSet = currentDescriptor->getVkHandle();
-        vk::BindDescriptorSetsInfo computeBindInfo{};
-        computeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
-        computeBindInfo.setLayout(pipeline.getLayout());
-        computeBindInfo.setDescriptorSets(computeDescSet);
-        computeBindInfo.setFirstSet(0U);
-        computeBindInfo.setDynamicOffsets(nullptr);
-        buffer->bindDescriptorSets2(computeBindInfo);
+    if (asyncChain) {
+        mChainCommandBuffers.at(currentFrame)->begin(beginInfo);
+    }
 
-        if (effect.params.size() > 0U) {
-            auto pushValues = effect.getParamValues();
+    // Queries are reset by whichever command buffer of the frame is submitted first
+    mConfig.profiler.beginFrame(asyncChain ? mChainCommandBuffers.at(currentFrame).get() : buffer.get(), currentFrame);
 
-            vk::PushConstantsInfo pushConstInfo{};
-            pushConstInfo.setLayout(pipeline.getLayout());
-            pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
-            pushConstInfo.setOffset(0U);
-            pushConstInfo.setValues<float>(pushValues);
+    // Takes ownership of uploads made on a dedicated transfer queue, only the first frame has any
+    mConfig.uploader.recordAcquire(buffer.get());
 
-            buffer->pushConstants2(pushConstInfo);
-        }
+    if (asyncChain) {
+        chainState.resultInPong = _recordAsyncChain(currentFrame, chain);
+        chainState.chainHash = chain.getHash();
+    }
+    else if (recordChain) {
+        chainState.resultInPong = mConfig.chainRecorder.record(buffer.get(), chain, renderImages, renderDescriptors.compute, mConfig.fusedOpBuffers.at(currentFrame), &mConfig.statsTargets.at(currentFrame));
+        mConfig.chainRecorder.recordMips(buffer.get(), renderImages, renderDescriptors.mips, chainState.resultInPong);
+        chainState.chainHash = chain.getHash();
+    }
 
-        buffer->dispatch(groupsX, groupsY, 1U);
+    if (recordChain) {
+        mStatsRecorded.at(currentFrame) = true;
+    }
 
-        auto readBarrier = readImage->createReadToWrite();
-        auto writeBarrier = writeImage->createWriteToRead();
-        std::array barriers{ readBarrier, writeBarrier };
+    auto* readImage = chainState.resultInPong ? &renderImages.pong : &renderImages.ping;
+    auto* writeImage = chainState.resultInPong ? &renderImages.ping : &renderImages.pong;
 
-        vk::DependencyInfo pingPongBarriers{};
-        pingPongBarriers.setImageMemoryBarriers(barriers);
+    const auto* graphicsDescriptor = chainState.resultInPong ? &renderDescriptors.graphicsB : &renderDescriptors.graphicsA;
 
-        buffer->pipelineBarrier2(pingPongBarriers);
+    std::optional<ReadbackTicket> ticket;
 
-        std::swap(readImage, writeImage);
-        std::swap(currentDescriptor, nextDescriptor);
-        std::swap(graphicsDescriptor, graphicsNextDescriptor);
+    if (readback) {
+        ticket = mConfig.readbackRing.record(buffer.get(), *readImage);
     }
 
     readImage->transitionComputeToFragmentRead(buffer.get());
@@ -126,6 +114,8 @@ void CommandBuffer::record(uint32_t currentFrame, uint32_t imageIndex)
     vk::ClearValue clearValue{ { 0.0f, 0.0f, 0.0f, 1.0f } };
     renderPassInfo.setClearValues(clearValue);
 
+    auto renderTiming = mConfig.profiler.begin(buffer.get(), "Render pass");
+
     buffer->beginRenderPass2(renderPassInfo, vk::SubpassContents::eInline);
 
     buffer->bindPipeline(vk::PipelineBindPoint::eGraphics, mConfig.graphicsPipeline.getVkHandle());
@@ -169,10 +159,14 @@ void CommandBuffer::record(uint32_t currentFrame, uint32_t imageIndex)
 
     buffer->drawIndexed(mConfig.drawIndexCount, mConfig.drawInstanceCount, 0U, 0U, 0U);
 
+    auto imGuiTiming = mConfig.profiler.begin(buffer.get(), "ImGui");
     recordImGui(currentFrame, imageIndex);
+    mConfig.profiler.end(buffer.get(), imGuiTiming);
 
     buffer->endRenderPass2(vk::SubpassEndInfo{});
 
+    mConfig.profiler.end(buffer.get(), renderTiming);
+
     readImage->transitionRevertToCompute(buffer.get());
 
     if (readImage == &renderImages.ping)
@@ -187,13 +181,22 @@ void CommandBuffer::record(uint32_t currentFrame, uint32_t imageIndex)
         buffer->pipelineBarrier2(revertBarrier);
     }
 
+    mConfig.profiler.endFrame(buffer.get());
+
     buffer->end();
+
+    return ticket;
 }
 
 void CommandBuffer::reset(uint32_t bufferIndex)
 {
     const auto& buffer = mCommandBuffers[bufferIndex];
     buffer->reset();
+
+    if (mChainRecorded[bufferIndex]) {
+        mChainCommandBuffers[bufferIndex]->reset();
+        mChainRecorded[bufferIndex] = false;
+    }
 }
 
 void CommandBuffer::recordImGui(uint32_t currentFrame, uint32_t imageIndex)
@@ -221,8 +224,76 @@ const vk::CommandBuffer CommandBuffer::getVkHandle(size_t bufferIndex) const noe
     return mCommandBuffers[bufferIndex].get();
 }
 
+std::optional<ImageStats> CommandBuffer::takeStats(uint32_t currentFrame)
+{
+    if (!mStatsRecorded.at(currentFrame)) {
+        return std::nullopt;
+    }
+
+    mStatsRecorded.at(currentFrame) = false;
+
+    const auto* stats = static_cast<const GpuImageStats*>(mConfig.statsTargets.at(currentFrame).buffer.getMappedData());
+    return decodeImageStats(*stats);
+}
+
+std::optional<vk::CommandBuffer> CommandBuffer::getChainVkHandle(size_t bufferIndex) const noexcept
+{
+    if (!mChainRecorded[bufferIndex]) {
+        return std::nullopt;
+    }
+
+    return mChainCommandBuffers[bufferIndex].get();
+}
+
+bool CommandBuffer::_recordAsyncChain(uint32_t currentFrame, const EffectChain& chain)
+{
+    const auto& buffer = mCommandBuffers.at(currentFrame);
+    const auto& chainBuffer = mChainCommandBuffers.at(currentFrame);
+    auto& renderImages = mConfig.renderImages.at(currentFrame);
+    const auto& renderDescriptors = mConfig.renderDescriptors.at(currentFrame);
+
+    const auto computeFamily = mConfig.computeCommandPool->getQueueFamilyIndex();
+    const auto graphicsFamily = mConfig.commandPool.getQueueFamilyIndex();
+
+    // The graphics queue owned the images since the last chain, but the chain overwrites
+    // them before reading, so they are discarded instead of transferred back
+    std::array discardBarriers{ renderImages.ping.createDiscard(), renderImages.pong.createDiscard() };
+
+    vk::DependencyInfo discardInfo{};
+    discardInfo.setImageMemoryBarriers(discardBarriers);
+
+    chainBuffer->pipelineBarrier2(discardInfo);
+
+    bool resultInPong = mConfig.chainRecorder.record(chainBuffer.get(), chain, renderImages, renderDescriptors.compute, mConfig.fusedOpBuffers.at(currentFrame), &mConfig.statsTargets.at(currentFrame));
+    mConfig.chainRecorder.recordMips(chainBuffer.get(), renderImages, renderDescriptors.mips, resultInPong);
+
+    std::array releaseBarriers{
+        renderImages.ping.createRelease(computeFamily, graphicsFamily),
+        renderImages.pong.createRelease(computeFamily, graphicsFamily),
+    };
+
+    vk::DependencyInfo releaseInfo{};
+    releaseInfo.setImageMemoryBarriers(releaseBarriers);
+
+    chainBuffer->pipelineBarrier2(releaseInfo);
+    chainBuffer->end();
+
+    std::array acquireBarriers{
+        renderImages.ping.createAcquire(computeFamily, graphicsFamily),
+        renderImages.pong.createAcquire(computeFamily, graphicsFamily),
+    };
+
+    vk::DependencyInfo acquireInfo{};
+    acquireInfo.setImageMemoryBarriers(acquireBarriers);
+
+    buffer->pipelineBarrier2(acquireInfo);
+
+    return resultInPong;
+}
+
 SingleTimeCommandBuffer::SingleTimeCommandBuffer(const Device& device, const CommandPool& commandPool)
     : mDevice{ device }
+    , mQueue{ device.getVkHandle().getQueue(commandPool.getQueueFamilyIndex(), 0U) }
 {
     auto buffers = createCommandBuffers(device.getVkHandle(), commandPool.getVkHandle(), 1U);
     mCommandBuffer = std::move(buffers[0]);
@@ -240,9 +311,9 @@ SingleTimeCommandBuffer::~SingleTimeCommandBuffer()
     vk::SubmitInfo submitInfo{};
     submitInfo.setCommandBuffers(mCommandBuffer.get());
 
-    const auto graphicsQueue = mDevice.getGraphicsQueue();
-    graphicsQueue.submit(submitInfo);
-    graphicsQueue.waitIdle();
+    // Submit to the family the pool belongs to, which has no graphics queue when headless
+    mQueue.submit(submitInfo);
+    mQueue.waitIdle();
 }
 
 const vk::CommandBuffer SingleTimeCommandBuffer::getVkHandle() const
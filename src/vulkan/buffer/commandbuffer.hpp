@@ -1,38 +1,46 @@
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include <app_data.hpp>
 
 #include <vulkan/include.hpp>
+#include <vulkan/buffer/chain_recorder.hpp>
 #include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/readback_ring.hpp>
 #include <vulkan/buffer/texture.hpp>
+#include <vulkan/buffer/uploader.hpp>
 #include <vulkan/descriptor/descriptor_set.hpp>
 #include <vulkan/pipeline/compute_pipeline.hpp>
 #include <vulkan/pipeline/graphics_pipeline.hpp>
 #include <vulkan/pipeline/pipeline_set.hpp>
+#include <vulkan/query/gpu_profiler.hpp>
+#include <vulkan/query/image_stats.hpp>
+#include <vulkan/sync/frame_scheduler.hpp>
 
 class Buffer;
 class Device;
+class EffectChain;
 class Renderpass;
 class Framebuffer;
 
+std::vector<vk::UniqueCommandBuffer> createCommandBuffers(const vk::Device device, const vk::CommandPool pool, uint32_t createCount);
+
 struct RenderDescriptorSet
 {
-    DescriptorSet sampler;
-
-    DescriptorSet computeAtoB;
-    DescriptorSet computeBtoA;
+    ComputeDescriptorSet compute;
+    MipChainDescriptorSet mips;
 
     DescriptorSet graphicsA;
     DescriptorSet graphicsB;
 };
 
-struct RenderImageSet
+// What the ping/pong images of a frame currently hold
+struct RenderChainState
 {
-    const TextureImage& original;
-    TextureImage ping;
-    TextureImage pong;
+    std::optional<size_t> chainHash;
+    bool resultInPong = false;
 };
 
 struct CommandBufferConfig
@@ -40,14 +48,22 @@ struct CommandBufferConfig
     AppData& appData;
 
     const CommandPool& commandPool;
+    // Pool of the async compute family that chains are recorded on, null to record them with the graphics work
+    const CommandPool* computeCommandPool;
     const Renderpass& renderpass;
     const std::vector<Framebuffer>* framebuffers;
 
     const std::vector<RenderDescriptorSet>& renderDescriptors;
     std::vector<RenderImageSet>& renderImages;
-    const ComputePipeline& samplerPipeline;
     const GraphicsPipeline& graphicsPipeline;
-    const PipelineSet& pipelineSet;
+    ChainRecorder& chainRecorder;
+    const std::vector<Buffer>& fusedOpBuffers;
+    // Host-visible, one per frame, receive the statistics of every chain result
+    const std::vector<ImageStatsTarget>& statsTargets;
+    ReadbackRing& readbackRing;
+    Uploader& uploader;
+    GpuProfiler& profiler;
+    const FrameScheduler& scheduler;
 
     vk::Extent2D extent;
 
@@ -65,20 +81,34 @@ class CommandBuffer
 public:
     CommandBuffer(const Device& device, const CommandBufferConfig& config);
 
-    void record(uint32_t currentFrame, uint32_t imageIndex);
+    // With `readback`, also copies the chain result into the readback ring, nullopt when it is full
+    std::optional<ReadbackTicket> record(uint32_t currentFrame, uint32_t imageIndex, bool readback = false);
     void reset(uint32_t bufferIndex);
 
     void recordImGui(uint32_t currentFrame, uint32_t imageIndex);
 
+    // Statistics of the chain the frame last recorded, once per recording. Only call it after the
+    // frame's previous submission has completed.
+    [[nodiscard]] std::optional<ImageStats> takeStats(uint32_t currentFrame);
+
     void updateFramebuffers(const std::vector<Framebuffer>* framebuffers, vk::Extent2D extent);
 
     [[nodiscard]] const vk::CommandBuffer getVkHandle(size_t bufferIndex) const noexcept;
+    // Async compute work of the last record, submitted before and waited on by the graphics command buffer
+    [[nodiscard]] std::optional<vk::CommandBuffer> getChainVkHandle(size_t bufferIndex) const noexcept;
 private:
+    // Records the chain on the compute queue and hands the ping/pong images over to the graphics queue
+    bool _recordAsyncChain(uint32_t currentFrame, const EffectChain& chain);
+
     const Device& mDevice;
 
     CommandBufferConfig mConfig;
     
     std::vector<vk::UniqueCommandBuffer> mCommandBuffers;
+    std::vector<vk::UniqueCommandBuffer> mChainCommandBuffers;
+    std::vector<bool> mChainRecorded;
+    std::vector<bool> mStatsRecorded;
+    std::vector<RenderChainState> mChainStates;
 };
 
 class SingleTimeCommandBuffer
@@ -90,6 +120,7 @@ public:
     const vk::CommandBuffer getVkHandle() const;
 private:
     const Device& mDevice;
+    vk::Queue mQueue;
 
     vk::UniqueCommandBuffer mCommandBuffer;
 };
@@ -3,6 +3,7 @@
 #include <vulkan/device.hpp>
 
 CommandPool::CommandPool(const Device& device, const CommandPoolConfig& config)
+    : mQueueFamilyIndex{ config.queueFamilyIndex }
 {
     vk::CommandPoolCreateInfo poolInfo{};
     poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
@@ -15,3 +16,8 @@ const vk::CommandPool& CommandPool::getVkHandle() const
 {
     return mPool.get();
 }
+
+uint32_t CommandPool::getQueueFamilyIndex() const noexcept
+{
+    return mQueueFamilyIndex;
+}
@@ -15,6 +15,8 @@ public:
     CommandPool(const Device& device, const CommandPoolConfig& config);
 
     const vk::CommandPool& getVkHandle() const;
+    [[nodiscard]] uint32_t getQueueFamilyIndex() const noexcept;
 private:
     vk::UniqueCommandPool mPool;
+    uint32_t mQueueFamilyIndex;
 };
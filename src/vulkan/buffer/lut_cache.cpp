@@ -0,0 +1,263 @@
+#include "lut_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <stdexcept>
+
+#include <vulkan/device.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/buffer/commandbuffer.hpp>
+
+// Workgroup edge of shaders/lut_bake.glsl
+static const uint32_t gBakeGroupSize = 4U;
+
+LutCache::LutCache(const Device& device, const LutCacheConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+    , mDescriptorPool{ config.descriptorPool }
+    , mBakeLayout{ config.bakeLayout }
+    , mSampleLayout{ config.sampleLayout }
+    , mBakePipeline{ config.bakePipeline }
+    , mSampler{ config.sampler }
+    , mSize{ config.size }
+    , mCapacity{ config.capacity }
+    , mOpCapacity{ config.opCapacity }
+{
+}
+
+void LutCache::beginFrame(uint64_t frame, uint64_t completedFrame)
+{
+    mFrame = frame;
+    mCompletedFrame = completedFrame;
+}
+
+const DescriptorSet* LutCache::acquire(vk::CommandBuffer buffer, size_t hash, const std::vector<FusedOp>& ops)
+{
+    if (ops.size() > mOpCapacity) {
+        return nullptr;
+    }
+
+    auto it = mLookup.find(hash);
+    if (it != mLookup.end()) {
+        _touch(it->second);
+
+        return &it->second->sampleSet;
+    }
+
+    // Allocate up to the capacity, otherwise rebake the least recently used LUT
+    EntryList::iterator entry;
+
+    if (mEntries.size() < mCapacity) {
+        mEntries.emplace_front(_createEntry(buffer, hash));
+        entry = mEntries.begin();
+    }
+    else {
+        if (mEntries.empty() || !_isEvictable(mEntries.back())) {
+            return nullptr;
+        }
+
+        entry = std::prev(mEntries.end());
+        mLookup.erase(entry->hash);
+        entry->hash = hash;
+    }
+
+    mLookup[hash] = entry;
+    _touch(entry);
+
+    _recordBake(buffer, *entry, ops);
+
+    return &entry->sampleSet;
+}
+
+void LutCache::exportCube(const std::vector<FusedOp>& ops, const std::filesystem::path& path) const
+{
+    if (ops.size() > mOpCapacity) {
+        throw std::runtime_error("Too many effects to bake into a LUT.");
+    }
+
+    const size_t texelCount = size_t{ mSize } * mSize * mSize;
+
+    BufferConfig readbackConfig = {
+        .size = texelCount * 4U * sizeof(uint16_t),
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = mCommandPool,
+        .persistentMap = true,
+    };
+
+    Buffer readback{ mDevice, readbackConfig };
+
+    // Outlives the one-time submission, which waits for the GPU when it goes out of scope
+    std::optional<Entry> entry;
+
+    {
+        auto commandBuffer = SingleTimeCommandBuffer{ mDevice, mCommandPool };
+        auto buffer = commandBuffer.getVkHandle();
+
+        entry.emplace(_createEntry(buffer, 0U));
+        _recordBake(buffer, entry.value(), ops);
+
+        vk::BufferImageCopy region{};
+        region.setBufferOffset(0U);
+        region.setBufferRowLength(0U);
+        region.setBufferImageHeight(0U);
+
+        region.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+        region.imageSubresource.setMipLevel(0U);
+        region.imageSubresource.setBaseArrayLayer(0U);
+        region.imageSubresource.setLayerCount(1U);
+
+        region.setImageOffset(vk::Offset3D{ 0, 0, 0 });
+        region.setImageExtent(vk::Extent3D{ mSize, mSize, mSize });
+
+        buffer.copyImageToBuffer(entry->image.getVkHandle(), vk::ImageLayout::eGeneral, readback.getVkHandle(), region);
+
+        vk::MemoryBarrier2 hostBarrier{};
+        hostBarrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+        hostBarrier.setDstAccessMask(vk::AccessFlagBits2::eHostRead);
+        hostBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+        hostBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eHost);
+
+        vk::DependencyInfo depInfo{};
+        depInfo.setMemoryBarriers(hostBarrier);
+
+        buffer.pipelineBarrier2(depInfo);
+    }
+
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream file{ path };
+    if (!file) {
+        throw std::runtime_error("Failed to open LUT file for writing.");
+    }
+
+    file << "TITLE \"vkimg2d\"\n";
+    file << "LUT_3D_SIZE " << mSize << "\n";
+    file << "DOMAIN_MIN 0.0 0.0 0.0\n";
+    file << "DOMAIN_MAX 1.0 1.0 1.0\n";
+    file << std::fixed << std::setprecision(6);
+
+    // Image x/y/z are red/green/blue, so the tightly packed texels are already in .cube order
+    const auto* texels = static_cast<const uint16_t*>(readback.getMappedData());
+
+    for (size_t i = 0; i < texelCount; i++) {
+        const auto* texel = texels + i * 4U;
+
+        file << halfToFloat(texel[0]) << " " << halfToFloat(texel[1]) << " " << halfToFloat(texel[2]) << "\n";
+    }
+}
+
+LutCache::Entry LutCache::_createEntry(vk::CommandBuffer buffer, size_t hash) const
+{
+    LutImageConfig imageConfig = {
+        .commandPool = mCommandPool,
+        .size = mSize,
+        .recordingBuffer = buffer,
+    };
+
+    TextureImage image{ mDevice, imageConfig };
+
+    BufferConfig opConfig = {
+        .size = mOpCapacity * sizeof(FusedOp),
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = mCommandPool,
+        .persistentMap = true,
+    };
+
+    Buffer opBuffer{ mDevice, opConfig };
+
+    std::vector<DescriptorSetImage> bakeImages{
+        DescriptorSetImage{
+            .binding = 0U,
+            .texture = image,
+            .layout = vk::ImageLayout::eGeneral,
+            .descriptorType = vk::DescriptorType::eStorageImage,
+        },
+    };
+
+    std::vector<DescriptorSetBuffer> bakeBuffers{
+        DescriptorSetBuffer{
+            .binding = 1U,
+            .buffer = opBuffer,
+            .range = opConfig.size,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorSet bakeSet{ mDevice, DescriptorSetConfig{ .descriptorLayout = mBakeLayout, .descriptorPool = mDescriptorPool } };
+    bakeSet.update(DescriptorUpdateConfig{ .images = bakeImages, .buffers = &bakeBuffers });
+
+    std::vector<DescriptorSetImage> sampleImages{
+        DescriptorSetImage{
+            .binding = 0U,
+            .texture = image,
+            .sampler = &mSampler,
+            .layout = vk::ImageLayout::eGeneral,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        },
+    };
+
+    DescriptorSet sampleSet{ mDevice, DescriptorSetConfig{ .descriptorLayout = mSampleLayout, .descriptorPool = mDescriptorPool } };
+    sampleSet.update(DescriptorUpdateConfig{ .images = sampleImages });
+
+    return Entry{
+        .hash = hash,
+        .image = std::move(image),
+        .opBuffer = std::move(opBuffer),
+        .bakeSet = std::move(bakeSet),
+        .sampleSet = std::move(sampleSet),
+        .lastUsedFrame = mFrame,
+    };
+}
+
+void LutCache::_recordBake(vk::CommandBuffer buffer, const Entry& entry, const std::vector<FusedOp>& ops) const
+{
+    std::ranges::copy(ops, static_cast<FusedOp*>(entry.opBuffer.getMappedData()));
+
+    buffer.bindPipeline(vk::PipelineBindPoint::eCompute, mBakePipeline.getVkHandle());
+
+    auto bakeDescSet = entry.bakeSet.getVkHandle();
+    vk::BindDescriptorSetsInfo bakeBindInfo{};
+    bakeBindInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    bakeBindInfo.setLayout(mBakePipeline.getLayout());
+    bakeBindInfo.setDescriptorSets(bakeDescSet);
+    bakeBindInfo.setFirstSet(0U);
+    bakeBindInfo.setDynamicOffsets(nullptr);
+    buffer.bindDescriptorSets2(bakeBindInfo);
+
+    std::array pushValues = { static_cast<uint32_t>(ops.size()) };
+
+    vk::PushConstantsInfo pushConstInfo{};
+    pushConstInfo.setLayout(mBakePipeline.getLayout());
+    pushConstInfo.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+    pushConstInfo.setOffset(0U);
+    pushConstInfo.setValues<uint32_t>(pushValues);
+
+    buffer.pushConstants2(pushConstInfo);
+
+    uint32_t groups = (mSize + gBakeGroupSize - 1U) / gBakeGroupSize;
+    buffer.dispatch(groups, groups, groups);
+
+    vk::DependencyInfo bakeBarrier{};
+    auto barrier = entry.image.createWriteToSample();
+    bakeBarrier.setImageMemoryBarriers(barrier);
+
+    buffer.pipelineBarrier2(bakeBarrier);
+}
+
+bool LutCache::_isEvictable(const Entry& entry) const noexcept
+{
+    return entry.lastUsedFrame <= mCompletedFrame;
+}
+
+void LutCache::_touch(EntryList::iterator it)
+{
+    it->lastUsedFrame = mFrame;
+    mEntries.splice(mEntries.begin(), mEntries, it);
+}
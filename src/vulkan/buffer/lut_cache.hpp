@@ -0,0 +1,96 @@
+#pragma once
+
+#include <filesystem>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <effect/chain.hpp>
+#include <vulkan/include.hpp>
+#include <vulkan/sampler.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/texture.hpp>
+#include <vulkan/descriptor/descriptor_layout.hpp>
+#include <vulkan/descriptor/descriptor_pool.hpp>
+#include <vulkan/descriptor/descriptor_set.hpp>
+#include <vulkan/pipeline/compute_pipeline.hpp>
+
+class Device;
+
+struct LutCacheConfig
+{
+    const CommandPool& commandPool;
+    const DescriptorPool& descriptorPool;
+
+    const DescriptorLayout& bakeLayout;
+    const DescriptorLayout& sampleLayout;
+    const ComputePipeline& bakePipeline;
+    const Sampler& sampler;
+
+    // Lattice points per axis
+    uint32_t size;
+
+    // Number of LUTs kept alive at once
+    uint32_t capacity;
+
+    // Longest run a single LUT can be baked from
+    uint32_t opCapacity;
+};
+
+// Bakes runs of color-only effects into 3D LUTs keyed by the run hash,
+// so a LUT is only rebuilt when a parameter in its run changes.
+class LutCache
+{
+public:
+    LutCache(const Device& device, const LutCacheConfig& config);
+
+    // Entries last used by `completedFrame` or an earlier frame are no longer read by the GPU
+    void beginFrame(uint64_t frame, uint64_t completedFrame);
+
+    // Returns the set sampling the LUT of the run, recording its bake into `buffer` first
+    // when it isn't cached, or nullptr when every LUT may still be in use
+    [[nodiscard]] const DescriptorSet* acquire(vk::CommandBuffer buffer, size_t hash, const std::vector<FusedOp>& ops);
+
+    // Bakes the ops into a standalone LUT and writes it out as a .cube file
+    void exportCube(const std::vector<FusedOp>& ops, const std::filesystem::path& path) const;
+private:
+    struct Entry
+    {
+        size_t hash;
+        TextureImage image;
+        Buffer opBuffer;
+        DescriptorSet bakeSet;
+        DescriptorSet sampleSet;
+        uint64_t lastUsedFrame;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    // The LUT image transitions to General in `buffer`, ahead of the bake recorded there
+    Entry _createEntry(vk::CommandBuffer buffer, size_t hash) const;
+    void _recordBake(vk::CommandBuffer buffer, const Entry& entry, const std::vector<FusedOp>& ops) const;
+
+    bool _isEvictable(const Entry& entry) const noexcept;
+    void _touch(EntryList::iterator it);
+
+    const Device& mDevice;
+    const CommandPool& mCommandPool;
+    const DescriptorPool& mDescriptorPool;
+
+    const DescriptorLayout& mBakeLayout;
+    const DescriptorLayout& mSampleLayout;
+    const ComputePipeline& mBakePipeline;
+    const Sampler& mSampler;
+
+    uint32_t mSize;
+    uint32_t mCapacity;
+    uint32_t mOpCapacity;
+
+    uint64_t mFrame = 0U;
+    uint64_t mCompletedFrame = 0U;
+
+    // Front is the most recently used entry
+    EntryList mEntries;
+    std::unordered_map<size_t, EntryList::iterator> mLookup;
+};
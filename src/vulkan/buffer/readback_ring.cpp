@@ -0,0 +1,183 @@
+#include "readback_ring.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include <vulkan/device.hpp>
+
+// Texels are at most 16 bytes, a wider alignment keeps every copy on its own cache lines
+static const vk::DeviceSize gMinAlignment = 64U;
+
+static vk::DeviceSize _alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1U) / alignment * alignment;
+}
+
+ReadbackRing::ReadbackRing(const Device& device, const ReadbackRingConfig& config)
+    : mDevice{ device }
+    , mTimeline{ device }
+{
+    // Invalidated ranges of non-coherent memory must be multiples of the atom size, a power of two
+    const auto atomSize = device.getPhysicalDevice().getProperties().limits.nonCoherentAtomSize;
+
+    mAlignment = std::max(gMinAlignment, atomSize);
+    mSize = _alignUp(config.size, mAlignment);
+
+    _createBuffer(config);
+}
+
+std::optional<ReadbackTicket> ReadbackRing::record(vk::CommandBuffer buffer, const TextureImage& image)
+{
+    const vk::DeviceSize size = vk::DeviceSize{ image.getWidth() } * image.getHeight() * image.getPixelSize();
+    const vk::DeviceSize allocationSize = _alignUp(size, mAlignment);
+
+    if (allocationSize > mSize) {
+        return std::nullopt;
+    }
+
+    // A copy never wraps around the end of the buffer, the skipped tail is reclaimed with it
+    uint64_t start = mHead;
+    const vk::DeviceSize headOffset = start % mSize;
+
+    if (headOffset + allocationSize > mSize) {
+        start += mSize - headOffset;
+    }
+
+    if (start + allocationSize - mTail > mSize) {
+        return std::nullopt;
+    }
+
+    const uint64_t id = mNextId++;
+    const vk::DeviceSize offset = start % mSize;
+
+    mAllocations.push_back(Allocation{ .id = id, .end = start + allocationSize, .released = false });
+    mHead = start + allocationSize;
+
+    image.recordReadback(buffer, mBuffer.value(), offset);
+
+    // Later layout transitions of the image must not overtake the copy
+    vk::MemoryBarrier2 copyBarrier{};
+    copyBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    copyBarrier.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+    copyBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+    copyBarrier.setDstAccessMask(vk::AccessFlagBits2::eNone);
+
+    vk::DependencyInfo depInfo{};
+    depInfo.setMemoryBarriers(copyBarrier);
+
+    buffer.pipelineBarrier2(depInfo);
+
+    mUnsubmitted = true;
+
+    return ReadbackTicket{
+        .id = id,
+        .value = mSubmittedValue + 1U,
+
+        .offset = offset,
+        .size = size,
+
+        .width = image.getWidth(),
+        .height = image.getHeight(),
+        .format = image.getFormat(),
+    };
+}
+
+bool ReadbackRing::hasUnsubmitted() const noexcept
+{
+    return mUnsubmitted;
+}
+
+vk::SemaphoreSubmitInfo ReadbackRing::takeSignal()
+{
+    mSubmittedValue++;
+    mUnsubmitted = false;
+
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.setSemaphore(mTimeline.getVkHandle());
+    signalInfo.setValue(mSubmittedValue);
+    signalInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    return signalInfo;
+}
+
+bool ReadbackRing::isReady(const ReadbackTicket& ticket) const
+{
+    return ticket.value <= mSubmittedValue && mTimeline.getValue() >= ticket.value;
+}
+
+void ReadbackRing::wait(const ReadbackTicket& ticket) const
+{
+    if (ticket.value > mSubmittedValue) {
+        throw std::runtime_error("Waiting for a readback that was never submitted.");
+    }
+
+    mTimeline.wait(ticket.value);
+}
+
+const uint8_t* ReadbackRing::getData(const ReadbackTicket& ticket) const
+{
+    wait(ticket);
+
+    if (!mCoherent) {
+        vk::MappedMemoryRange range{};
+        range.setMemory(mBuffer->getMemory());
+        range.setOffset(mBuffer->getMemoryOffset() + ticket.offset);
+        range.setSize(_alignUp(ticket.size, mAlignment));
+
+        mDevice.getVkHandle().invalidateMappedMemoryRanges(range);
+    }
+
+    return static_cast<const uint8_t*>(mBuffer->getMappedData()) + ticket.offset;
+}
+
+void ReadbackRing::release(const ReadbackTicket& ticket)
+{
+    if (mAllocations.empty() || ticket.id < mAllocations.front().id) {
+        return;
+    }
+
+    mAllocations.at(ticket.id - mAllocations.front().id).released = true;
+
+    while (!mAllocations.empty() && mAllocations.front().released) {
+        mTail = mAllocations.front().end;
+        mAllocations.pop_front();
+    }
+}
+
+vk::DeviceSize ReadbackRing::getSize() const noexcept
+{
+    return mSize;
+}
+
+void ReadbackRing::_createBuffer(const ReadbackRingConfig& config)
+{
+    // Reading uncached memory from the CPU is slow, so cached types come first
+    const std::array candidates{
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached | vk::MemoryPropertyFlagBits::eHostCoherent,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    };
+
+    for (auto properties : candidates) {
+        try {
+            BufferConfig bufferConfig = {
+                .size = mSize,
+                .usage = vk::BufferUsageFlagBits::eTransferDst,
+                .properties = properties,
+                .commandPool = config.commandPool,
+                .persistentMap = true,
+            };
+
+            mBuffer.emplace(mDevice, bufferConfig);
+            mCoherent = static_cast<bool>(properties & vk::MemoryPropertyFlagBits::eHostCoherent);
+
+            return;
+        }
+        catch (const std::runtime_error&) {
+            // Memory type not available, try the next one
+        }
+    }
+
+    throw std::runtime_error("Failed to find host-visible memory for readback.");
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+
+#include <vulkan/include.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/texture.hpp>
+#include <vulkan/sync/semaphore.hpp>
+
+class Device;
+
+struct ReadbackRingConfig
+{
+    const CommandPool& commandPool;
+
+    // Bytes shared by every readback that hasn't been released yet
+    vk::DeviceSize size;
+};
+
+// Pending copy of an image in the ring, valid until released
+struct ReadbackTicket
+{
+    uint64_t id;
+
+    // Timeline value signaled by the submission holding the copy
+    uint64_t value;
+
+    vk::DeviceSize offset;
+    vk::DeviceSize size;
+
+    uint32_t width, height;
+    vk::Format format;
+};
+
+// Persistently mapped, preferably host-cached staging ring for image readback.
+// Copies are recorded into the caller's command buffer, and the submission holding them
+// signals a timeline semaphore, so the pixels can be polled without stalling the queue.
+class ReadbackRing
+{
+public:
+    ReadbackRing(const Device& device, const ReadbackRingConfig& config);
+
+    // Records a copy of a compute image, or returns nullopt when the ring has no room
+    // until older tickets are released
+    [[nodiscard]] std::optional<ReadbackTicket> record(vk::CommandBuffer buffer, const TextureImage& image);
+
+    // Whether copies were recorded since the last takeSignal
+    [[nodiscard]] bool hasUnsubmitted() const noexcept;
+
+    // Signal to add to the submission holding the copies recorded since the previous call
+    [[nodiscard]] vk::SemaphoreSubmitInfo takeSignal();
+
+    [[nodiscard]] bool isReady(const ReadbackTicket& ticket) const;
+    void wait(const ReadbackTicket& ticket) const;
+
+    // Waits for the copy and returns its tightly packed pixels, valid until the ticket is released
+    [[nodiscard]] const uint8_t* getData(const ReadbackTicket& ticket) const;
+
+    // Tickets may be released in any order, space is reclaimed in recording order
+    void release(const ReadbackTicket& ticket);
+
+    [[nodiscard]] vk::DeviceSize getSize() const noexcept;
+private:
+    struct Allocation
+    {
+        uint64_t id;
+        uint64_t end;
+        bool released;
+    };
+
+    void _createBuffer(const ReadbackRingConfig& config);
+
+    const Device& mDevice;
+
+    std::optional<Buffer> mBuffer;
+    vk::DeviceSize mSize;
+    vk::DeviceSize mAlignment;
+
+    // Host-cached memory may not be coherent, reads then need an invalidate
+    bool mCoherent = true;
+
+    TimelineSemaphore mTimeline;
+    uint64_t mSubmittedValue = 0U;
+    bool mUnsubmitted = false;
+
+    // Monotonic byte positions, the offset in the buffer is the position modulo the size
+    uint64_t mHead = 0U;
+    uint64_t mTail = 0U;
+
+    uint64_t mNextId = 0U;
+    std::deque<Allocation> mAllocations;
+};
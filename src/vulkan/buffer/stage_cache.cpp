@@ -0,0 +1,107 @@
+#include "stage_cache.hpp"
+
+#include <algorithm>
+
+#include <vulkan/device.hpp>
+
+StageCache::StageCache(const Device& device, const StageCacheConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+    , mWidth{ config.width }
+    , mHeight{ config.height }
+    , mFormat{ config.format }
+    , mEntrySize{ vk::DeviceSize{ config.width } * config.height * getPixelSize(config.format) }
+{
+    auto memProperties = device.getPhysicalDevice().getMemoryProperties();
+
+    vk::DeviceSize deviceLocalSize = 0U;
+    for (uint32_t i = 0; i < memProperties.memoryHeapCount; i++) {
+        const auto& heap = memProperties.memoryHeaps[i];
+
+        if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            deviceLocalSize = std::max(deviceLocalSize, heap.size);
+        }
+    }
+
+    // Never let the cache take more than a quarter of VRAM
+    mBudget = std::min(config.budget, deviceLocalSize / 4U);
+}
+
+void StageCache::beginFrame(uint64_t frame, uint64_t completedFrame)
+{
+    mFrame = frame;
+    mCompletedFrame = completedFrame;
+}
+
+const TextureImage* StageCache::find(size_t hash)
+{
+    auto it = mLookup.find(hash);
+    if (it == mLookup.end()) {
+        return nullptr;
+    }
+
+    _touch(it->second);
+
+    return &it->second->image;
+}
+
+const TextureImage* StageCache::store(vk::CommandBuffer buffer, size_t hash)
+{
+    if (auto* image = find(hash)) {
+        return image;
+    }
+
+    // Allocate while the budget allows it, otherwise recycle the least recently used image
+    if (mUsage + mEntrySize <= mBudget) {
+        ComputeImageConfig imageConfig = {
+            .commandPool = mCommandPool,
+            .width = mWidth,
+            .height = mHeight,
+            .format = mFormat,
+            .recordingBuffer = buffer,
+        };
+
+        TextureImage image{ mDevice, imageConfig };
+
+        mEntrySize = image.getMemorySize();
+        mUsage += mEntrySize;
+
+        mEntries.emplace_front(Entry{ .hash = hash, .image = std::move(image), .lastUsedFrame = mFrame });
+        mLookup[hash] = mEntries.begin();
+
+        return &mEntries.front().image;
+    }
+
+    if (mEntries.empty() || !_isEvictable(mEntries.back())) {
+        return nullptr;
+    }
+
+    auto last = std::prev(mEntries.end());
+    mLookup.erase(last->hash);
+
+    last->hash = hash;
+    mLookup[hash] = last;
+    _touch(last);
+
+    return &last->image;
+}
+
+StageCacheStats StageCache::getStats() const noexcept
+{
+    return StageCacheStats{
+        .entryCount = mEntries.size(),
+        .usage = mUsage,
+        .budget = mBudget,
+    };
+}
+
+bool StageCache::_isEvictable(const Entry& entry) const noexcept
+{
+    return entry.lastUsedFrame <= mCompletedFrame;
+}
+
+void StageCache::_touch(EntryList::iterator it)
+{
+    it->lastUsedFrame = mFrame;
+    mEntries.splice(mEntries.begin(), mEntries, it);
+}
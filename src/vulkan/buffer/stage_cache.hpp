@@ -0,0 +1,79 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include <vulkan/include.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/texture.hpp>
+
+class Device;
+
+struct StageCacheConfig
+{
+    const CommandPool& commandPool;
+
+    uint32_t width, height;
+    WorkingFormat format;
+
+    // Upper bound for retained images, further capped by the device-local heap size
+    vk::DeviceSize budget;
+};
+
+struct StageCacheStats
+{
+    size_t entryCount;
+    vk::DeviceSize usage;
+    vk::DeviceSize budget;
+};
+
+// Retains intermediate chain results keyed by their prefix hash,
+// evicting the least recently used ones once the memory budget is reached.
+class StageCache
+{
+public:
+    StageCache(const Device& device, const StageCacheConfig& config);
+
+    // Entries last used by `completedFrame` or an earlier frame are no longer read by the GPU
+    void beginFrame(uint64_t frame, uint64_t completedFrame);
+
+    [[nodiscard]] const TextureImage* find(size_t hash);
+
+    // Returns the image the stage result should be copied into,
+    // or nullptr when the budget can't fit another entry right now.
+    // New images transition to General in `buffer`, ahead of the copy recorded there.
+    [[nodiscard]] const TextureImage* store(vk::CommandBuffer buffer, size_t hash);
+
+    [[nodiscard]] StageCacheStats getStats() const noexcept;
+private:
+    struct Entry
+    {
+        size_t hash;
+        TextureImage image;
+        uint64_t lastUsedFrame;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    bool _isEvictable(const Entry& entry) const noexcept;
+    void _touch(EntryList::iterator it);
+
+    const Device& mDevice;
+    const CommandPool& mCommandPool;
+
+    uint32_t mWidth, mHeight;
+    WorkingFormat mFormat;
+    vk::DeviceSize mBudget;
+
+    // Size of one retained image, estimated until the first allocation
+    vk::DeviceSize mEntrySize;
+
+    uint64_t mFrame = 0U;
+    uint64_t mCompletedFrame = 0U;
+    vk::DeviceSize mUsage = 0U;
+
+    // Front is the most recently used entry
+    EntryList mEntries;
+    std::unordered_map<size_t, EntryList::iterator> mLookup;
+};
@@ -0,0 +1,105 @@
+#include "staging_arena.hpp"
+
+#include <vulkan/device.hpp>
+
+// The ring size is a multiple of every supported range alignment, so offsets stay aligned across laps
+static const vk::DeviceSize gMaxAlignment = 256U;
+
+static vk::DeviceSize _alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1U) / alignment * alignment;
+}
+
+StagingArena::StagingArena(const Device& device, const StagingArenaConfig& config)
+    : mSize{ _alignUp(config.size, gMaxAlignment) }
+    , mTimeline{ device }
+{
+    BufferConfig bufferConfig = {
+        .size = mSize,
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = config.commandPool,
+        .persistentMap = true,
+    };
+
+    mBuffer.emplace(device, bufferConfig);
+}
+
+std::optional<StagingRange> StagingArena::allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    if (size > mSize || alignment > gMaxAlignment) {
+        return std::nullopt;
+    }
+
+    _reclaim();
+
+    // A range never wraps around the end of the buffer, the skipped tail is reclaimed with it
+    uint64_t start = _alignUp(mHead, alignment);
+
+    if (start % mSize + size > mSize) {
+        start = _alignUp(mHead, mSize);
+    }
+
+    if (start + size - mTail > mSize) {
+        return std::nullopt;
+    }
+
+    mHead = start + size;
+    mAllocations.push_back(Allocation{ .end = mHead, .value = mSubmittedValue + 1U });
+    mUncommitted = true;
+
+    const vk::DeviceSize offset = start % mSize;
+
+    return StagingRange{
+        .offset = offset,
+        .data = static_cast<uint8_t*>(mBuffer->getMappedData()) + offset,
+    };
+}
+
+bool StagingArena::hasUncommitted() const noexcept
+{
+    return mUncommitted;
+}
+
+vk::SemaphoreSubmitInfo StagingArena::takeSignal()
+{
+    mSubmittedValue++;
+    mUncommitted = false;
+
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.setSemaphore(mTimeline.getVkHandle());
+    signalInfo.setValue(mSubmittedValue);
+    signalInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    return signalInfo;
+}
+
+void StagingArena::wait()
+{
+    mTimeline.wait(mSubmittedValue);
+    _reclaim();
+}
+
+const Buffer& StagingArena::getBuffer() const noexcept
+{
+    return mBuffer.value();
+}
+
+vk::DeviceSize StagingArena::getSize() const noexcept
+{
+    return mSize;
+}
+
+void StagingArena::_reclaim()
+{
+    if (mAllocations.empty() || mAllocations.front().value > mSubmittedValue) {
+        return;
+    }
+
+    const uint64_t completedValue = mTimeline.getValue();
+
+    while (!mAllocations.empty() && mAllocations.front().value <= completedValue) {
+        mTail = mAllocations.front().end;
+        mAllocations.pop_front();
+    }
+}
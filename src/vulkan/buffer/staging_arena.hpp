@@ -0,0 +1,71 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+
+#include <vulkan/include.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/sync/semaphore.hpp>
+
+class Device;
+
+struct StagingArenaConfig
+{
+    const CommandPool& commandPool;
+
+    // Bytes shared by every upload still in flight
+    vk::DeviceSize size;
+};
+
+struct StagingRange
+{
+    vk::DeviceSize offset;
+    void* data;
+};
+
+// Persistently mapped linear ring that uploads copy their source data into.
+// Ranges are reclaimed in order once the submission that read them signals the arena's
+// timeline semaphore, so steady-state uploads neither allocate nor map memory.
+class StagingArena
+{
+public:
+    StagingArena(const Device& device, const StagingArenaConfig& config);
+
+    // Reserves `size` bytes at a power-of-two alignment up to 256,
+    // or returns nullopt while the ring is full of ranges in flight
+    [[nodiscard]] std::optional<StagingRange> allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16U);
+
+    // Whether ranges were allocated since the last takeSignal
+    [[nodiscard]] bool hasUncommitted() const noexcept;
+
+    // Signal to add to the submission reading the ranges allocated since the previous call
+    [[nodiscard]] vk::SemaphoreSubmitInfo takeSignal();
+
+    // Blocks until every committed range can be reused
+    void wait();
+
+    [[nodiscard]] const Buffer& getBuffer() const noexcept;
+    [[nodiscard]] vk::DeviceSize getSize() const noexcept;
+private:
+    struct Allocation
+    {
+        uint64_t end;
+        uint64_t value;
+    };
+
+    void _reclaim();
+
+    std::optional<Buffer> mBuffer;
+    vk::DeviceSize mSize;
+
+    TimelineSemaphore mTimeline;
+    uint64_t mSubmittedValue = 0U;
+    bool mUncommitted = false;
+
+    // Monotonic byte positions, the offset in the buffer is the position modulo the size
+    uint64_t mHead = 0U;
+    uint64_t mTail = 0U;
+
+    std::deque<Allocation> mAllocations;
+};
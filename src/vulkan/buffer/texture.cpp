@@ -1,8 +1,12 @@
 #include "texture.hpp"
 
+#include <algorithm>
+#include <bit>
+
 #include <vulkan/device.hpp>
 #include <vulkan/buffer/buffer.hpp>
 #include <vulkan/buffer/commandbuffer.hpp>
+#include <vulkan/buffer/uploader.hpp>
 
 static vk::ImageUsageFlags _imageTypeToFlags(TextureImageType type)
 {
@@ -33,20 +37,6 @@ TextureImage::TextureImage(const Device& device, const TextureImageConfig& confi
     const auto deviceHandle = device.getVkHandle();
     vk::DeviceSize imageSize = image.texWidth * image.texHeight * 4;
 
-    BufferConfig stagingBufferConfig = {
-        .size = imageSize,
-        .usage = vk::BufferUsageFlagBits::eTransferSrc,
-        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-
-        .commandPool = config.commandPool,
-    };
-
-    Buffer stagingBuffer{ device, stagingBufferConfig };
-
-    void* data = deviceHandle.mapMemory(stagingBuffer.getMemory(), 0U, imageSize, vk::MemoryMapFlags());
-    memcpy(data, image.pixels, static_cast<size_t>(imageSize));
-    deviceHandle.unmapMemory(stagingBuffer.getMemory());
-
     vk::ImageCreateInfo imageInfo{};
     imageInfo.setImageType(vk::ImageType::e2D);
     imageInfo.extent.setWidth(static_cast<uint32_t>(image.texWidth));
@@ -62,33 +52,31 @@ TextureImage::TextureImage(const Device& device, const TextureImageConfig& confi
     imageInfo.setSamples(vk::SampleCountFlagBits::e1);
     imageInfo.setFlags(vk::ImageCreateFlags());
 
+    if (config.sharedQueueFamilies.size() > 1U) {
+        imageInfo.setSharingMode(vk::SharingMode::eConcurrent);
+        imageInfo.setQueueFamilyIndices(config.sharedQueueFamilies);
+        mConcurrent = true;
+    }
+
     mImage = deviceHandle.createImageUnique(imageInfo);
 
     mFormat = imageInfo.format;
+    mPixelSize = getPixelSize(WorkingFormat::Rgba8);
     mExtent = vk::Extent2D{ imageInfo.extent.width, imageInfo.extent.height };
 
-    auto memoryRequirements = deviceHandle.getImageMemoryRequirements(mImage.get());
-
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.setAllocationSize(memoryRequirements.size);
-    allocInfo.setMemoryTypeIndex(Buffer::findMemoryType(device.getPhysicalDevice(), memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    _allocateMemory();
 
-    mMemory = deviceHandle.allocateMemoryUnique(allocInfo);
-    deviceHandle.bindImageMemory(mImage.get(), mMemory.get(), 0U);
-
-    _transitionImageLayout(vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-    stagingBuffer.copyToImage(mImage.get(), static_cast<uint32_t>(image.texWidth), static_cast<uint32_t>(image.texHeight));
-    _transitionImageLayout(vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+    config.uploader.uploadImage(*this, image.pixels, imageSize);
 
     mImageView.emplace(mDevice, mImage.get(), imageInfo.format);
 }
 
-TextureImage::TextureImage(const Device& device, const ComputeImageConfig& config)
+TextureImage::TextureImage(const Device& device, const SampledImageConfig& config)
     : mDevice{ device }
     , mCommandPool{ config.commandPool }
 {
     const auto deviceHandle = device.getVkHandle();
-    auto imageType = TextureImageType::SampledCompute;
+    auto imageType = TextureImageType::Sampled;
 
     vk::ImageCreateInfo imageInfo{};
     imageInfo.setImageType(vk::ImageType::e2D);
@@ -100,7 +88,7 @@ TextureImage::TextureImage(const Device& device, const ComputeImageConfig& confi
     imageInfo.setFormat(_imageTypeToFormat(imageType));
     imageInfo.setTiling(vk::ImageTiling::eOptimal);
     imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
-    imageInfo.setUsage(_imageTypeToFlags(imageType));
+    imageInfo.setUsage(vk::ImageUsageFlagBits::eTransferDst | _imageTypeToFlags(imageType));
     imageInfo.setSharingMode(vk::SharingMode::eExclusive);
     imageInfo.setSamples(vk::SampleCountFlagBits::e1);
     imageInfo.setFlags(vk::ImageCreateFlags());
@@ -108,21 +96,95 @@ TextureImage::TextureImage(const Device& device, const ComputeImageConfig& confi
     mImage = deviceHandle.createImageUnique(imageInfo);
 
     mFormat = imageInfo.format;
+    mPixelSize = getPixelSize(WorkingFormat::Rgba8);
     mExtent = vk::Extent2D{ imageInfo.extent.width, imageInfo.extent.height };
 
-    auto memoryRequirements = deviceHandle.getImageMemoryRequirements(mImage.get());
+    _allocateMemory();
+
+    mImageView.emplace(mDevice, mImage.get(), imageInfo.format);
+}
+
+TextureImage::TextureImage(const Device& device, const ComputeImageConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+{
+    const auto deviceHandle = device.getVkHandle();
+    auto imageType = TextureImageType::SampledCompute;
+
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.setImageType(vk::ImageType::e2D);
+    imageInfo.extent.setWidth(config.width);
+    imageInfo.extent.setHeight(config.height);
+    imageInfo.extent.setDepth(1U);
+    imageInfo.setMipLevels(config.mipLevels);
+    imageInfo.setArrayLayers(1U);
+    imageInfo.setFormat(toVkFormat(config.format));
+    imageInfo.setTiling(vk::ImageTiling::eOptimal);
+    imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
+    imageInfo.setUsage(vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | _imageTypeToFlags(imageType));
+    imageInfo.setSharingMode(vk::SharingMode::eExclusive);
+    imageInfo.setSamples(vk::SampleCountFlagBits::e1);
+    imageInfo.setFlags(vk::ImageCreateFlags());
 
-    vk::MemoryAllocateInfo allocInfo{};
-    allocInfo.setAllocationSize(memoryRequirements.size);
-    allocInfo.setMemoryTypeIndex(Buffer::findMemoryType(device.getPhysicalDevice(), memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal));
+    mImage = deviceHandle.createImageUnique(imageInfo);
+
+    mFormat = imageInfo.format;
+    mPixelSize = getPixelSize(config.format);
+    mExtent = vk::Extent2D{ imageInfo.extent.width, imageInfo.extent.height };
+    mMipLevels = imageInfo.mipLevels;
 
-    mMemory = deviceHandle.allocateMemoryUnique(allocInfo);
-    deviceHandle.bindImageMemory(mImage.get(), mMemory.get(), 0U);
+    _allocateMemory();
 
-    _transitionImageLayout(vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+    _transitionToGeneral(config.recordingBuffer);
     mComputeFrameReady = true;
 
     mImageView.emplace(device, mImage.get(), imageInfo.format);
+
+    if (mMipLevels > 1U) {
+        mMipViews.reserve(mMipLevels - 1U);
+
+        for (uint32_t level = 1U; level < mMipLevels; level++) {
+            mMipViews.emplace_back(device, mImage.get(), imageInfo.format, vk::ImageViewType::e2D, level, 1U);
+        }
+
+        mMipChainView.emplace(device, mImage.get(), imageInfo.format, vk::ImageViewType::e2D, 0U, mMipLevels);
+    }
+}
+
+TextureImage::TextureImage(const Device& device, const LutImageConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+{
+    const auto deviceHandle = device.getVkHandle();
+
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.setImageType(vk::ImageType::e3D);
+    imageInfo.extent.setWidth(config.size);
+    imageInfo.extent.setHeight(config.size);
+    imageInfo.extent.setDepth(config.size);
+    imageInfo.setMipLevels(1U);
+    imageInfo.setArrayLayers(1U);
+    imageInfo.setFormat(vk::Format::eR16G16B16A16Sfloat);
+    imageInfo.setTiling(vk::ImageTiling::eOptimal);
+    imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
+    imageInfo.setUsage(vk::ImageUsageFlagBits::eTransferSrc | _imageTypeToFlags(TextureImageType::SampledCompute));
+    imageInfo.setSharingMode(vk::SharingMode::eExclusive);
+    imageInfo.setSamples(vk::SampleCountFlagBits::e1);
+    imageInfo.setFlags(vk::ImageCreateFlags());
+
+    mImage = deviceHandle.createImageUnique(imageInfo);
+
+    mFormat = imageInfo.format;
+    mPixelSize = getPixelSize(WorkingFormat::Rgba16f);
+    mExtent = vk::Extent2D{ imageInfo.extent.width, imageInfo.extent.height };
+    mDepth = imageInfo.extent.depth;
+
+    _allocateMemory();
+
+    // Stays in General: written by the bake, sampled by the apply pass
+    _transitionToGeneral(config.recordingBuffer);
+
+    mImageView.emplace(device, mImage.get(), imageInfo.format, vk::ImageViewType::e3D);
 }
 
 vk::Image TextureImage::getVkHandle() const noexcept
@@ -132,7 +194,12 @@ vk::Image TextureImage::getVkHandle() const noexcept
 
 vk::DeviceMemory TextureImage::getMemory() const noexcept
 {
-    return mMemory.get();
+    return mMemory.getMemory();
+}
+
+vk::DeviceSize TextureImage::getMemorySize() const noexcept
+{
+    return mMemory.getSize();
 }
 
 vk::Extent2D TextureImage::getExtent() const noexcept
@@ -150,21 +217,74 @@ uint32_t TextureImage::getHeight() const noexcept
     return getExtent().height;
 }
 
+uint32_t TextureImage::getDepth() const noexcept
+{
+    return mDepth;
+}
+
+uint32_t TextureImage::getMipLevels() const noexcept
+{
+    return mMipLevels;
+}
+
 vk::Format TextureImage::getFormat() const noexcept
 {
     return mFormat;
 }
 
+uint32_t TextureImage::getPixelSize() const noexcept
+{
+    return mPixelSize;
+}
+
 vk::ImageView TextureImage::getImageView() const noexcept
 {
     return mImageView.value().getVkHandle();
 }
 
+vk::ImageView TextureImage::getMipView(uint32_t level) const
+{
+    if (level == 0U) {
+        return getImageView();
+    }
+
+    return mMipViews.at(level - 1U).getVkHandle();
+}
+
+vk::ImageView TextureImage::getMipChainView() const noexcept
+{
+    return mMipChainView.has_value() ? mMipChainView->getVkHandle() : getImageView();
+}
+
 const Device& TextureImage::getDevice() const noexcept
 {
     return mDevice;
 }
 
+bool TextureImage::isConcurrent() const noexcept
+{
+    return mConcurrent;
+}
+
+uint32_t TextureImage::getFullMipLevels(uint32_t width, uint32_t height) noexcept
+{
+    return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+}
+
+void TextureImage::_allocateMemory()
+{
+    const auto deviceHandle = mDevice.getVkHandle();
+
+    MemoryRequest request = {
+        .requirements = deviceHandle.getImageMemoryRequirements(mImage.get()),
+        .properties = vk::MemoryPropertyFlagBits::eDeviceLocal,
+        .linear = false,
+    };
+
+    mMemory = mDevice.getAllocator().allocate(request);
+    deviceHandle.bindImageMemory(mImage.get(), mMemory.getMemory(), mMemory.getOffset());
+}
+
 vk::ImageMemoryBarrier2 TextureImage::_prepareBarrier(vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const
 {
     vk::ImageMemoryBarrier2 barrier{};
@@ -177,7 +297,8 @@ vk::ImageMemoryBarrier2 TextureImage::_prepareBarrier(vk::ImageLayout oldLayout,
     barrier.subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
     barrier.subresourceRange.setBaseMipLevel(0U);
     barrier.subresourceRange.setBaseArrayLayer(0U);
-    barrier.subresourceRange.setLevelCount(1U);
+    // Layouts and queue ownership always change for the whole mip chain
+    barrier.subresourceRange.setLevelCount(vk::RemainingMipLevels);
     barrier.subresourceRange.setLayerCount(1U);
 
     return barrier;
@@ -212,8 +333,12 @@ void TextureImage::_transitionImageLayout(vk::CommandBuffer buffer, vk::ImageLay
         barrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
         barrier.setDstAccessMask(vk::AccessFlagBits2::eShaderRead);
 
+        // Read by the sampler pass, and by the fragment pass unless the queue has no graphics support
+        auto dstStage = vk::PipelineStageFlags2{ vk::PipelineStageFlagBits2::eComputeShader };
+        if (!mDevice.isHeadless()) dstStage |= vk::PipelineStageFlagBits2::eFragmentShader;
+
         barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
-        barrier.setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader);
+        barrier.setDstStageMask(dstStage);
     }
     else if (
         oldLayout == vk::ImageLayout::eUndefined &&
@@ -258,6 +383,16 @@ void TextureImage::_transitionImageLayout(vk::ImageLayout oldLayout, vk::ImageLa
     _transitionImageLayout(commandBuffer.getVkHandle(), oldLayout, newLayout);
 }
 
+void TextureImage::_transitionToGeneral(vk::CommandBuffer recordingBuffer) const
+{
+    if (recordingBuffer) {
+        _transitionImageLayout(recordingBuffer, vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+    }
+    else {
+        _transitionImageLayout(vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+    }
+}
+
 vk::ImageMemoryBarrier2 TextureImage::createReadToWrite() const
 {
     auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
@@ -280,6 +415,152 @@ vk::ImageMemoryBarrier2 TextureImage::createWriteToRead() const
     return barrier;
 }
 
+vk::ImageMemoryBarrier2 TextureImage::createComputeToTransfer() const
+{
+    auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer);
+
+    return barrier;
+}
+
+vk::ImageMemoryBarrier2 TextureImage::createTransferToCompute() const
+{
+    auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+
+    return barrier;
+}
+
+vk::ImageMemoryBarrier2 TextureImage::createWriteToSample() const
+{
+    auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead | vk::AccessFlagBits2::eTransferRead);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer);
+
+    return barrier;
+}
+
+vk::ImageMemoryBarrier2 TextureImage::createRelease(uint32_t srcQueueFamily, uint32_t dstQueueFamily) const
+{
+    // The semaphore between the submissions makes the writes visible, so the release has no destination scope
+    auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+    barrier.setSrcQueueFamilyIndex(srcQueueFamily);
+    barrier.setDstQueueFamilyIndex(dstQueueFamily);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eNone);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eNone);
+
+    return barrier;
+}
+
+vk::ImageMemoryBarrier2 TextureImage::createAcquire(uint32_t srcQueueFamily, uint32_t dstQueueFamily) const
+{
+    // Covers the readback copy and the compute-to-fragment transition that follow it
+    auto barrier = _prepareBarrier(vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral);
+    barrier.setSrcQueueFamilyIndex(srcQueueFamily);
+    barrier.setDstQueueFamilyIndex(dstQueueFamily);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferRead);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer);
+
+    return barrier;
+}
+
+vk::ImageMemoryBarrier2 TextureImage::createDiscard() const
+{
+    auto barrier = _prepareBarrier(vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral);
+    barrier.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+    barrier.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite);
+    barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+    barrier.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eTransfer);
+
+    return barrier;
+}
+
+void TextureImage::recordCopy(vk::CommandBuffer buffer, const TextureImage& dstImage) const
+{
+    vk::ImageCopy region{};
+    region.srcSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+    region.srcSubresource.setMipLevel(0U);
+    region.srcSubresource.setBaseArrayLayer(0U);
+    region.srcSubresource.setLayerCount(1U);
+    region.setSrcOffset(vk::Offset3D{ 0, 0, 0 });
+
+    region.dstSubresource = region.srcSubresource;
+    region.setDstOffset(vk::Offset3D{ 0, 0, 0 });
+    region.setExtent(vk::Extent3D{ mExtent.width, mExtent.height, 1U });
+
+    buffer.copyImage(mImage.get(), vk::ImageLayout::eGeneral, dstImage.getVkHandle(), vk::ImageLayout::eGeneral, region);
+}
+
+void TextureImage::recordUpload(vk::CommandBuffer buffer, vk::Buffer staging, vk::DeviceSize srcOffset) const
+{
+    // Previous contents are discarded, so the image may only be reused once earlier reads completed
+    _transitionImageLayout(buffer, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+
+    vk::BufferImageCopy region{};
+    region.setBufferOffset(srcOffset);
+    region.setBufferRowLength(0U);
+    region.setBufferImageHeight(0U);
+
+    region.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+    region.imageSubresource.setMipLevel(0U);
+    region.imageSubresource.setBaseArrayLayer(0U);
+    region.imageSubresource.setLayerCount(1U);
+
+    region.setImageOffset(vk::Offset3D{ 0, 0, 0 });
+    region.setImageExtent(vk::Extent3D{ mExtent.width, mExtent.height, 1U });
+
+    buffer.copyBufferToImage(staging, mImage.get(), vk::ImageLayout::eTransferDstOptimal, region);
+
+    _transitionImageLayout(buffer, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
+void TextureImage::recordReadback(vk::CommandBuffer buffer, const Buffer& dst, vk::DeviceSize dstOffset) const
+{
+    vk::DependencyInfo copyBarrier{};
+    auto imageBarrier = createComputeToTransfer();
+    copyBarrier.setImageMemoryBarriers(imageBarrier);
+
+    buffer.pipelineBarrier2(copyBarrier);
+
+    vk::BufferImageCopy region{};
+    region.setBufferOffset(dstOffset);
+    region.setBufferRowLength(0U);
+    region.setBufferImageHeight(0U);
+
+    region.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+    region.imageSubresource.setMipLevel(0U);
+    region.imageSubresource.setBaseArrayLayer(0U);
+    region.imageSubresource.setLayerCount(1U);
+
+    region.setImageOffset(vk::Offset3D{ 0, 0, 0 });
+    region.setImageExtent(vk::Extent3D{ mExtent.width, mExtent.height, 1U });
+
+    buffer.copyImageToBuffer(mImage.get(), vk::ImageLayout::eGeneral, dst.getVkHandle(), region);
+
+    vk::MemoryBarrier2 hostBarrier{};
+    hostBarrier.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    hostBarrier.setDstAccessMask(vk::AccessFlagBits2::eHostRead);
+    hostBarrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    hostBarrier.setDstStageMask(vk::PipelineStageFlagBits2::eHost);
+
+    vk::DependencyInfo depInfo{};
+    depInfo.setMemoryBarriers(hostBarrier);
+
+    buffer.pipelineBarrier2(depInfo);
+}
+
 bool TextureImage::isComputeFrameReady() const
 {
     return mComputeFrameReady;
@@ -297,11 +578,11 @@ void TextureImage::transitionRevertToCompute(vk::CommandBuffer buffer)
     _transitionImageLayout(buffer, vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eGeneral);
 }
 
-TextureImageView::TextureImageView(const Device& device, const vk::Image image, vk::Format format)
+TextureImageView::TextureImageView(const Device& device, const vk::Image image, vk::Format format, vk::ImageViewType viewType, uint32_t baseMipLevel, uint32_t levelCount)
 {
     vk::ImageViewCreateInfo createInfo{};
     createInfo.setImage(image);
-    createInfo.setViewType(vk::ImageViewType::e2D);
+    createInfo.setViewType(viewType);
     createInfo.setFormat(format);
 
     createInfo.components.setR(vk::ComponentSwizzle::eIdentity);
@@ -310,9 +591,9 @@ TextureImageView::TextureImageView(const Device& device, const vk::Image image,
     createInfo.components.setA(vk::ComponentSwizzle::eIdentity);
 
     createInfo.subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
-    createInfo.subresourceRange.setBaseMipLevel(0U);
+    createInfo.subresourceRange.setBaseMipLevel(baseMipLevel);
     createInfo.subresourceRange.setBaseArrayLayer(0U);
-    createInfo.subresourceRange.setLevelCount(1U);
+    createInfo.subresourceRange.setLevelCount(levelCount);
     createInfo.subresourceRange.setLayerCount(1U);
 
     mView = device.getVkHandle().createImageViewUnique(createInfo);
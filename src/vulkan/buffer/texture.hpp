@@ -1,13 +1,18 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include <vulkan/include.hpp>
+#include <vulkan/working_format.hpp>
 #include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/memory/allocator.hpp>
 
 #include <io/image.hpp>
 
+class Buffer;
 class Device;
+class Uploader;
 
 enum class TextureImageType
 {
@@ -16,12 +21,25 @@ enum class TextureImageType
     SampledCompute,
 };
 
+// Sampled image filled through the uploader, usable once its next flush is waited on
 struct TextureImageConfig
 {
     const CommandPool& commandPool;
+    Uploader& uploader;
     const ImageLoadResult& image;
 
     TextureImageType type;
+
+    // Families reading the image without ownership transfers, exclusive to one family when fewer than two
+    std::vector<uint32_t> sharedQueueFamilies = {};
+};
+
+// Sampled sRGB image left undefined, filled later through recordUpload
+struct SampledImageConfig
+{
+    const CommandPool& commandPool;
+
+    uint32_t width, height;
 };
 
 struct ComputeImageConfig
@@ -29,12 +47,32 @@ struct ComputeImageConfig
     const CommandPool& commandPool;
 
     uint32_t width, height;
+
+    WorkingFormat format = WorkingFormat::Rgba8;
+
+    // Levels below the first are only written by ChainRecorder::recordMips
+    uint32_t mipLevels = 1U;
+
+    // Optional, images created while a frame records transition to General in its command buffer
+    // rather than in a blocking one-time submission
+    vk::CommandBuffer recordingBuffer = {};
+};
+
+// Cubic RGBA16F lattice used as a color lookup table
+struct LutImageConfig
+{
+    const CommandPool& commandPool;
+
+    uint32_t size;
+
+    // Optional, as for ComputeImageConfig
+    vk::CommandBuffer recordingBuffer = {};
 };
 
 class TextureImageView
 {
 public:
-    TextureImageView(const Device& device, const vk::Image image, vk::Format format);
+    TextureImageView(const Device& device, const vk::Image image, vk::Format format, vk::ImageViewType viewType = vk::ImageViewType::e2D, uint32_t baseMipLevel = 0U, uint32_t levelCount = 1U);
 
     const vk::ImageView getVkHandle() const;
 private:
@@ -45,7 +83,9 @@ class TextureImage
 {
 public:
     TextureImage(const Device& device, const TextureImageConfig& config);
+    TextureImage(const Device& device, const SampledImageConfig& config);
     TextureImage(const Device& device, const ComputeImageConfig& config);
+    TextureImage(const Device& device, const LutImageConfig& config);
 
     TextureImage(TextureImage&&) = default;
     TextureImage& operator=(TextureImage&&) = default;
@@ -55,40 +95,82 @@ public:
 
     [[nodiscard]] vk::Image getVkHandle() const noexcept;
     [[nodiscard]] vk::DeviceMemory getMemory() const noexcept;
+    [[nodiscard]] vk::DeviceSize getMemorySize() const noexcept;
 
     [[nodiscard]] vk::Extent2D getExtent() const noexcept;
     [[nodiscard]] uint32_t getWidth() const noexcept;
     [[nodiscard]] uint32_t getHeight() const noexcept;
+    [[nodiscard]] uint32_t getDepth() const noexcept;
+    [[nodiscard]] uint32_t getMipLevels() const noexcept;
 
     [[nodiscard]] vk::Format getFormat() const noexcept;
+    // Bytes per texel, as laid out by readback copies
+    [[nodiscard]] uint32_t getPixelSize() const noexcept;
 
+    // Covers the first mip level only, as storage image bindings require
     [[nodiscard]] vk::ImageView getImageView() const noexcept;
+    [[nodiscard]] vk::ImageView getMipView(uint32_t level) const;
+    // Covers every mip level, for sampling with a level of detail
+    [[nodiscard]] vk::ImageView getMipChainView() const noexcept;
 
     [[nodiscard]] const Device& getDevice() const noexcept;
 
+    [[nodiscard]] bool isConcurrent() const noexcept;
+
+    // Halvings down to a single pixel, plus the full resolution level
+    [[nodiscard]] static uint32_t getFullMipLevels(uint32_t width, uint32_t height) noexcept;
+
     vk::ImageMemoryBarrier2 createReadToWrite() const;
     vk::ImageMemoryBarrier2 createWriteToRead() const;
+    vk::ImageMemoryBarrier2 createComputeToTransfer() const;
+    vk::ImageMemoryBarrier2 createTransferToCompute() const;
+    vk::ImageMemoryBarrier2 createWriteToSample() const;
+
+    // Ownership transfer of a compute image, recorded on the releasing and then the acquiring queue
+    vk::ImageMemoryBarrier2 createRelease(uint32_t srcQueueFamily, uint32_t dstQueueFamily) const;
+    vk::ImageMemoryBarrier2 createAcquire(uint32_t srcQueueFamily, uint32_t dstQueueFamily) const;
+    // Drops the contents of a compute image, so a family that didn't own it can write it without a transfer
+    vk::ImageMemoryBarrier2 createDiscard() const;
+
+    void recordCopy(vk::CommandBuffer buffer, const TextureImage& dstImage) const;
+
+    // Copies tightly packed pixels from `staging` at `srcOffset` into a sampled image, leaving it ready to sample
+    void recordUpload(vk::CommandBuffer buffer, vk::Buffer staging, vk::DeviceSize srcOffset = 0U) const;
+    // Copies a compute image into `dst` at `dstOffset` and makes the result visible to the host
+    void recordReadback(vk::CommandBuffer buffer, const Buffer& dst, vk::DeviceSize dstOffset = 0U) const;
 
     bool isComputeFrameReady() const;
 
     void transitionComputeToFragmentRead(vk::CommandBuffer buffer);
     void transitionRevertToCompute(vk::CommandBuffer buffer);
 private:
+    void _allocateMemory();
+
     vk::ImageMemoryBarrier2 _prepareBarrier(vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
     void _commitBarrier(vk::CommandBuffer buffer, vk::ImageMemoryBarrier2 barrier) const;
     void _transitionImageLayout(vk::CommandBuffer buffer, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
     void _transitionImageLayout(vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
+    // Records into `recordingBuffer` when given, submits and waits otherwise
+    void _transitionToGeneral(vk::CommandBuffer recordingBuffer) const;
 
     const Device& mDevice;
     const CommandPool& mCommandPool;
 
     vk::Extent2D mExtent;
+    uint32_t mDepth = 1U;
+    uint32_t mMipLevels = 1U;
     vk::Format mFormat;
+    uint32_t mPixelSize;
 
+    MemoryAllocation mMemory;
     vk::UniqueImage mImage;
-    vk::UniqueDeviceMemory mMemory;
 
     std::optional<TextureImageView> mImageView;
+    // Only created for images with more than one mip level, the first level uses mImageView
+    std::vector<TextureImageView> mMipViews;
+    std::optional<TextureImageView> mMipChainView;
+
+    bool mConcurrent = false;
 
     bool mComputeFrameReady = false; // TODO: maybe it won't be needed; or implement better
 };
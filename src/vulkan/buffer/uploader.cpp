@@ -0,0 +1,294 @@
+#include "uploader.hpp"
+
+#include <cstring>
+
+#include <vulkan/device.hpp>
+#include <vulkan/buffer/commandbuffer.hpp>
+#include <vulkan/buffer/texture.hpp>
+
+Uploader::Uploader(const Device& device, const UploaderConfig& config)
+    : mDevice{ device }
+    , mDstQueueFamilyIndex{ config.dstQueueFamilyIndex }
+    , mCommandPool{ device, CommandPoolConfig{ .queueFamilyIndex = device.getQueueFamilies().transferFamily.value() } }
+    , mTimeline{ device }
+    , mStagingArena{ device, StagingArenaConfig{ .commandPool = mCommandPool, .size = config.stagingSize } }
+{
+}
+
+Uploader::~Uploader()
+{
+    // Staging buffers and command buffers may still be in use
+    mTimeline.wait(mSubmittedValue);
+}
+
+void Uploader::uploadImage(const TextureImage& image, const void* pixels, vk::DeviceSize size)
+{
+    const auto staging = _stage(pixels, size);
+    auto buffer = _getRecording();
+
+    vk::ImageMemoryBarrier2 barrier{};
+    barrier.setImage(image.getVkHandle());
+    barrier.setSrcQueueFamilyIndex(vk::QueueFamilyIgnored);
+    barrier.setDstQueueFamilyIndex(vk::QueueFamilyIgnored);
+    barrier.subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
+    barrier.subresourceRange.setBaseMipLevel(0U);
+    barrier.subresourceRange.setBaseArrayLayer(0U);
+    barrier.subresourceRange.setLevelCount(1U);
+    barrier.subresourceRange.setLayerCount(1U);
+
+    auto toTransfer = barrier;
+    toTransfer.setOldLayout(vk::ImageLayout::eUndefined);
+    toTransfer.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+    toTransfer.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+    toTransfer.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+    toTransfer.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    toTransfer.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+
+    vk::DependencyInfo toTransferInfo{};
+    toTransferInfo.setImageMemoryBarriers(toTransfer);
+
+    buffer.pipelineBarrier2(toTransferInfo);
+
+    vk::BufferImageCopy region{};
+    region.setBufferOffset(staging.offset);
+    region.setBufferRowLength(0U);
+    region.setBufferImageHeight(0U);
+
+    region.imageSubresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
+    region.imageSubresource.setMipLevel(0U);
+    region.imageSubresource.setBaseArrayLayer(0U);
+    region.imageSubresource.setLayerCount(1U);
+
+    region.setImageOffset(vk::Offset3D{ 0, 0, 0 });
+    region.setImageExtent(vk::Extent3D{ image.getWidth(), image.getHeight(), 1U });
+
+    buffer.copyBufferToImage(staging.buffer, image.getVkHandle(), vk::ImageLayout::eTransferDstOptimal, region);
+
+    // The semaphore wait makes the copy visible, so the release itself has no destination scope
+    auto release = barrier;
+    release.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+    release.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+    release.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    release.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    release.setDstStageMask(vk::PipelineStageFlagBits2::eNone);
+    release.setDstAccessMask(vk::AccessFlagBits2::eNone);
+
+    // Concurrent images are read by every family they were created for without a transfer
+    if (_needsOwnershipTransfer() && !image.isConcurrent()) {
+        release.setSrcQueueFamilyIndex(mCommandPool.getQueueFamilyIndex());
+        release.setDstQueueFamilyIndex(mDstQueueFamilyIndex);
+
+        // Read by the sampler pass, and by the fragment pass unless the queue has no graphics support
+        auto dstStage = vk::PipelineStageFlags2{ vk::PipelineStageFlagBits2::eComputeShader };
+        if (!mDevice.isHeadless()) dstStage |= vk::PipelineStageFlagBits2::eFragmentShader;
+
+        auto acquire = release;
+        acquire.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+        acquire.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+        acquire.setDstStageMask(dstStage);
+        acquire.setDstAccessMask(vk::AccessFlagBits2::eShaderRead);
+
+        mRecordingImageAcquires.push_back(acquire);
+    }
+
+    vk::DependencyInfo releaseInfo{};
+    releaseInfo.setImageMemoryBarriers(release);
+
+    buffer.pipelineBarrier2(releaseInfo);
+}
+
+void Uploader::uploadBuffer(const Buffer& dst, const void* data, vk::DeviceSize size, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+{
+    const auto staging = _stage(data, size);
+    auto buffer = _getRecording();
+
+    vk::BufferCopy region{};
+    region.setSrcOffset(staging.offset);
+    region.setDstOffset(0U);
+    region.setSize(size);
+
+    buffer.copyBuffer(staging.buffer, dst.getVkHandle(), region);
+
+    if (!_needsOwnershipTransfer()) {
+        return;
+    }
+
+    vk::BufferMemoryBarrier2 release{};
+    release.setBuffer(dst.getVkHandle());
+    release.setOffset(0U);
+    release.setSize(vk::WholeSize);
+    release.setSrcQueueFamilyIndex(mCommandPool.getQueueFamilyIndex());
+    release.setDstQueueFamilyIndex(mDstQueueFamilyIndex);
+    release.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer);
+    release.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+    release.setDstStageMask(vk::PipelineStageFlagBits2::eNone);
+    release.setDstAccessMask(vk::AccessFlagBits2::eNone);
+
+    auto acquire = release;
+    acquire.setSrcStageMask(vk::PipelineStageFlagBits2::eNone);
+    acquire.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+    acquire.setDstStageMask(dstStage);
+    acquire.setDstAccessMask(dstAccess);
+
+    mRecordingBufferAcquires.push_back(acquire);
+
+    vk::DependencyInfo releaseInfo{};
+    releaseInfo.setBufferMemoryBarriers(release);
+
+    buffer.pipelineBarrier2(releaseInfo);
+}
+
+void Uploader::flush()
+{
+    collect();
+
+    if (!mRecording) {
+        return;
+    }
+
+    mRecording->end();
+
+    mSubmittedValue++;
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{};
+    commandBufferInfo.setCommandBuffer(mRecording.get());
+
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.setSemaphore(mTimeline.getVkHandle());
+    signalInfo.setValue(mSubmittedValue);
+    signalInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos{ signalInfo };
+
+    if (mStagingArena.hasUncommitted()) {
+        signalInfos.push_back(mStagingArena.takeSignal());
+    }
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setCommandBufferInfos(commandBufferInfo);
+    submitInfo.setSignalSemaphoreInfos(signalInfos);
+
+    mDevice.getTransferQueue().submit2(submitInfo);
+
+    mImageAcquires.insert(mImageAcquires.end(), mRecordingImageAcquires.begin(), mRecordingImageAcquires.end());
+    mBufferAcquires.insert(mBufferAcquires.end(), mRecordingBufferAcquires.begin(), mRecordingBufferAcquires.end());
+    mRecordingImageAcquires.clear();
+    mRecordingBufferAcquires.clear();
+
+    mSubmissions.push_back(Submission{
+        .value = mSubmittedValue,
+
+        .commandBuffer = std::move(mRecording),
+        .staging = std::move(mRecordingStaging),
+    });
+
+    mRecordingStaging.clear();
+}
+
+void Uploader::recordAcquire(vk::CommandBuffer buffer)
+{
+    if (mImageAcquires.empty() && mBufferAcquires.empty()) {
+        return;
+    }
+
+    vk::DependencyInfo depInfo{};
+    depInfo.setImageMemoryBarriers(mImageAcquires);
+    depInfo.setBufferMemoryBarriers(mBufferAcquires);
+
+    buffer.pipelineBarrier2(depInfo);
+
+    mImageAcquires.clear();
+    mBufferAcquires.clear();
+}
+
+std::optional<vk::SemaphoreSubmitInfo> Uploader::takeWait()
+{
+    if (mTakenValue == mSubmittedValue) {
+        return std::nullopt;
+    }
+
+    mTakenValue = mSubmittedValue;
+
+    vk::SemaphoreSubmitInfo waitInfo{};
+    waitInfo.setSemaphore(mTimeline.getVkHandle());
+    waitInfo.setValue(mSubmittedValue);
+    waitInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    return waitInfo;
+}
+
+void Uploader::collect()
+{
+    if (mSubmissions.empty()) {
+        return;
+    }
+
+    const uint64_t completedValue = mTimeline.getValue();
+
+    while (!mSubmissions.empty() && mSubmissions.front().value <= completedValue) {
+        mSubmissions.pop_front();
+    }
+}
+
+const CommandPool& Uploader::getCommandPool() const noexcept
+{
+    return mCommandPool;
+}
+
+vk::CommandBuffer Uploader::_getRecording()
+{
+    if (!mRecording) {
+        auto buffers = createCommandBuffers(mDevice.getVkHandle(), mCommandPool.getVkHandle(), 1U);
+        mRecording = std::move(buffers[0]);
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+        mRecording->begin(beginInfo);
+    }
+
+    return mRecording.get();
+}
+
+Uploader::StagedData Uploader::_stage(const void* data, vk::DeviceSize size)
+{
+    auto range = mStagingArena.allocate(size);
+
+    // The arena is full of uploads in flight, so submit what is recorded and wait for them
+    if (!range.has_value() && size <= mStagingArena.getSize()) {
+        flush();
+        mStagingArena.wait();
+
+        range = mStagingArena.allocate(size);
+    }
+
+    if (range.has_value()) {
+        std::memcpy(range->data, data, static_cast<size_t>(size));
+
+        return StagedData{
+            .buffer = mStagingArena.getBuffer().getVkHandle(),
+            .offset = range->offset,
+        };
+    }
+
+    BufferConfig stagingConfig = {
+        .size = size,
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = mCommandPool,
+        .persistentMap = true,
+    };
+
+    auto& staging = mRecordingStaging.emplace_back(mDevice, stagingConfig);
+    std::memcpy(staging.getMappedData(), data, static_cast<size_t>(size));
+
+    return StagedData{
+        .buffer = staging.getVkHandle(),
+        .offset = 0U,
+    };
+}
+
+bool Uploader::_needsOwnershipTransfer() const noexcept
+{
+    return mCommandPool.getQueueFamilyIndex() != mDstQueueFamilyIndex;
+}
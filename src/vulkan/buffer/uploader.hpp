@@ -0,0 +1,98 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <vulkan/include.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/staging_arena.hpp>
+#include <vulkan/sync/semaphore.hpp>
+
+class Device;
+class TextureImage;
+
+struct UploaderConfig
+{
+    // Family of the queue that uses the uploaded images and buffers
+    uint32_t dstQueueFamilyIndex;
+
+    // Size of the staging arena, larger uploads fall back to a buffer of their own
+    vk::DeviceSize stagingSize;
+};
+
+// Batches uploads into one command buffer submitted on the transfer queue.
+// Nothing waits on the host: the submission signals a timeline semaphore that the first
+// submission using the data waits on, and ownership moves to the destination family
+// through the barriers recorded by recordAcquire when the transfer family is dedicated.
+class Uploader
+{
+public:
+    Uploader(const Device& device, const UploaderConfig& config);
+    ~Uploader();
+
+    Uploader(const Uploader&) = delete;
+    Uploader& operator=(const Uploader&) = delete;
+
+    // Fills a sampled image with tightly packed pixels, leaving it ready to sample
+    void uploadImage(const TextureImage& image, const void* pixels, vk::DeviceSize size);
+    // Fills a device-local buffer, read by `dstStage` with `dstAccess` once acquired
+    void uploadBuffer(const Buffer& dst, const void* data, vk::DeviceSize size, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess);
+
+    // Submits the uploads recorded since the last flush
+    void flush();
+
+    // Records the ownership acquires of flushed uploads into the consumer's command buffer
+    void recordAcquire(vk::CommandBuffer buffer);
+    // Wait to add to the submission recorded by recordAcquire, nullopt once taken
+    [[nodiscard]] std::optional<vk::SemaphoreSubmitInfo> takeWait();
+
+    // Frees staging memory of completed submissions
+    void collect();
+
+    [[nodiscard]] const CommandPool& getCommandPool() const noexcept;
+private:
+    struct Submission
+    {
+        uint64_t value;
+
+        vk::UniqueCommandBuffer commandBuffer;
+
+        // Uploads too large for the arena
+        std::vector<Buffer> staging;
+    };
+
+    struct StagedData
+    {
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+    };
+
+    vk::CommandBuffer _getRecording();
+    StagedData _stage(const void* data, vk::DeviceSize size);
+
+    [[nodiscard]] bool _needsOwnershipTransfer() const noexcept;
+
+    const Device& mDevice;
+    uint32_t mDstQueueFamilyIndex;
+
+    CommandPool mCommandPool;
+    TimelineSemaphore mTimeline;
+    StagingArena mStagingArena;
+
+    uint64_t mSubmittedValue = 0U;
+    uint64_t mTakenValue = 0U;
+
+    // Uploads recorded since the last flush
+    vk::UniqueCommandBuffer mRecording;
+    std::vector<Buffer> mRecordingStaging;
+    std::vector<vk::ImageMemoryBarrier2> mRecordingImageAcquires;
+    std::vector<vk::BufferMemoryBarrier2> mRecordingBufferAcquires;
+
+    // Flushed uploads whose acquire hasn't been recorded yet
+    std::vector<vk::ImageMemoryBarrier2> mImageAcquires;
+    std::vector<vk::BufferMemoryBarrier2> mBufferAcquires;
+
+    std::deque<Submission> mSubmissions;
+};
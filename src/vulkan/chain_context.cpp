@@ -0,0 +1,627 @@
+#include "chain_context.hpp"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <io/binary.hpp>
+#include <util/thread_pool.hpp>
+#include <vulkan/device.hpp>
+
+// Ops a single evaluation can hand to the fused kernel
+static const uint32_t gFusedOpCapacity = 256U;
+
+// Color LUTs kept alive at once, plus one transient LUT for exports
+static const uint32_t gLutCapacity = 8U;
+static const uint32_t gLutDescriptorCount = gLutCapacity + 1U;
+
+// Halvings a blur pyramid can hold, enough for the largest radius
+static const uint32_t gBlurMaxLevels = 4U;
+// Forward, backward and sample set of every level
+static const uint32_t gBlurLevelSetCount = 3U;
+
+// The one statistics buffer effects read, shared as they run one after another
+static const uint32_t gStatsDescriptorSetCount = 1U;
+
+// Up to 8192 pixels on the longer side, must match MAX_MIP_LEVELS in shaders/mip_downsample.glsl plus one
+static const uint32_t gMipMaxLevels = 13U;
+
+ChainContext::ChainContext(const Device& device, const ChainContextConfig& config)
+    : mDevice{ device }
+    , mCommandPool{ config.commandPool }
+    , mDescriptorPool{ config.descriptorPool }
+    , mWorkingFormat{ config.workingFormat }
+{
+    // Lattice and image edges must not blend with a border color
+    SamplerConfig clampSamplerConfig = {
+        .addressMode = vk::SamplerAddressMode::eClampToEdge,
+        .anisotropy = false,
+    };
+    mClampSampler.emplace(mDevice, clampSamplerConfig);
+
+    _createDescriptorLayouts();
+    _createPipelines(config);
+    _createChainRecorder(config);
+}
+
+ComputeDescriptorSet ChainContext::createDescriptors(const RenderImageSet& images, const Sampler& sampler, const Buffer& fusedOpBuffer) const
+{
+    std::vector<DescriptorSetImage> samplerImages;
+    samplerImages.reserve(2);
+    samplerImages.push_back(DescriptorSetImage{
+        .binding = 0U,
+        .texture = images.original,
+        .sampler = &sampler,
+        .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+    });
+    samplerImages.push_back(DescriptorSetImage{
+        .binding = 1U,
+        .texture = images.ping,
+        .layout = vk::ImageLayout::eGeneral,
+        .descriptorType = vk::DescriptorType::eStorageImage,
+    });
+
+    DescriptorSetConfig samplerConfig = {
+        .descriptorLayout = mSamplerDescriptorLayout.value(),
+        .descriptorPool = mDescriptorPool,
+    };
+
+    DescriptorSet samplerSet{ mDevice, samplerConfig };
+    samplerSet.update(DescriptorUpdateConfig{ .images = samplerImages });
+
+    std::vector<DescriptorSetImage> computeABImages;
+    computeABImages.reserve(2);
+    computeABImages.push_back(DescriptorSetImage{
+        .binding = 0U,
+        .texture = images.ping,
+        .layout = vk::ImageLayout::eGeneral,
+        .descriptorType = vk::DescriptorType::eStorageImage,
+    });
+    computeABImages.push_back(DescriptorSetImage{
+        .binding = 1U,
+        .texture = images.pong,
+        .layout = vk::ImageLayout::eGeneral,
+        .descriptorType = vk::DescriptorType::eStorageImage,
+    });
+
+    std::vector<DescriptorSetImage> computeBAImages;
+    computeBAImages.reserve(2);
+    computeBAImages.push_back(DescriptorSetImage{
+        .binding = 0U,
+        .texture = images.pong,
+        .layout = vk::ImageLayout::eGeneral,
+        .descriptorType = vk::DescriptorType::eStorageImage,
+    });
+    computeBAImages.push_back(DescriptorSetImage{
+        .binding = 1U,
+        .texture = images.ping,
+        .layout = vk::ImageLayout::eGeneral,
+        .descriptorType = vk::DescriptorType::eStorageImage,
+    });
+
+    DescriptorSetConfig computeConfig = {
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .descriptorPool = mDescriptorPool,
+    };
+
+    DescriptorSet computeAB{ mDevice, computeConfig };
+    computeAB.update(DescriptorUpdateConfig{ .images = computeABImages });
+
+    DescriptorSet computeBA{ mDevice, computeConfig };
+    computeBA.update(DescriptorUpdateConfig{ .images = computeBAImages });
+
+    std::vector<DescriptorSetBuffer> fusedBuffers{
+        DescriptorSetBuffer{
+            .binding = 2U,
+            .buffer = fusedOpBuffer,
+            .range = gFusedOpCapacity * sizeof(FusedOp),
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorSetConfig fusedConfig = {
+        .descriptorLayout = mFusedDescriptorLayout.value(),
+        .descriptorPool = mDescriptorPool,
+    };
+
+    DescriptorSet fusedAB{ mDevice, fusedConfig };
+    fusedAB.update(DescriptorUpdateConfig{ .images = computeABImages, .buffers = &fusedBuffers });
+
+    DescriptorSet fusedBA{ mDevice, fusedConfig };
+    fusedBA.update(DescriptorUpdateConfig{ .images = computeBAImages, .buffers = &fusedBuffers });
+
+    return ComputeDescriptorSet{
+        .sampler = std::move(samplerSet),
+
+        .computeAtoB = std::move(computeAB),
+        .computeBtoA = std::move(computeBA),
+
+        .fusedAtoB = std::move(fusedAB),
+        .fusedBtoA = std::move(fusedBA),
+    };
+}
+
+Buffer ChainContext::createFusedOpBuffer() const
+{
+    BufferConfig fusedOpConfig = {
+        .size = gFusedOpCapacity * sizeof(FusedOp),
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = mCommandPool,
+        .persistentMap = true,
+    };
+
+    return Buffer{ mDevice, fusedOpConfig };
+}
+
+ImageStatsTarget ChainContext::createStatsTarget(bool hostVisible) const
+{
+    const auto properties = hostVisible
+        ? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+        : vk::MemoryPropertyFlags{ vk::MemoryPropertyFlagBits::eDeviceLocal };
+
+    BufferConfig statsConfig = {
+        .size = sizeof(GpuImageStats),
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        .properties = properties,
+        .commandPool = mCommandPool,
+        .persistentMap = hostVisible,
+    };
+
+    Buffer statsBuffer{ mDevice, statsConfig };
+
+    std::vector<DescriptorSetBuffer> statsBuffers{
+        DescriptorSetBuffer{
+            .binding = 0U,
+            .buffer = statsBuffer,
+            .range = sizeof(GpuImageStats),
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorSet statsSet{ mDevice, DescriptorSetConfig{ .descriptorLayout = mStatsDescriptorLayout.value(), .descriptorPool = mDescriptorPool } };
+    statsSet.update(DescriptorUpdateConfig{ .images = {}, .buffers = &statsBuffers });
+
+    return ImageStatsTarget{
+        .buffer = std::move(statsBuffer),
+        .descriptorSet = std::move(statsSet),
+    };
+}
+
+MipChainDescriptorSet ChainContext::createMipDescriptors(const RenderImageSet& images) const
+{
+    BufferConfig counterConfig = {
+        .size = sizeof(uint32_t),
+        .usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+        .properties = vk::MemoryPropertyFlagBits::eDeviceLocal,
+        .commandPool = mCommandPool,
+    };
+
+    Buffer counter{ mDevice, counterConfig };
+
+    std::vector<DescriptorSetBuffer> counterBuffers{
+        DescriptorSetBuffer{
+            .binding = 2U,
+            .buffer = counter,
+            .range = sizeof(uint32_t),
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorSetConfig mipConfig = {
+        .descriptorLayout = mMipDescriptorLayout.value(),
+        .descriptorPool = mDescriptorPool,
+    };
+
+    auto createSet = [&](const TextureImage& image) {
+        std::vector<DescriptorSetImage> mipImages;
+        mipImages.reserve(gMipMaxLevels);
+        mipImages.push_back(DescriptorSetImage{
+            .binding = 0U,
+            .texture = image,
+            .layout = vk::ImageLayout::eGeneral,
+            .descriptorType = vk::DescriptorType::eStorageImage,
+        });
+
+        // Elements past the image's last level repeat it, the shader never touches them
+        for (uint32_t level = 1U; level < gMipMaxLevels; level++) {
+            mipImages.push_back(DescriptorSetImage{
+                .binding = 1U,
+                .texture = image,
+                .layout = vk::ImageLayout::eGeneral,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+                .arrayElement = level - 1U,
+                .view = image.getMipView(std::min(level, image.getMipLevels() - 1U)),
+            });
+        }
+
+        DescriptorSet mipSet{ mDevice, mipConfig };
+        mipSet.update(DescriptorUpdateConfig{ .images = mipImages, .buffers = &counterBuffers });
+
+        return mipSet;
+    };
+
+    auto pingSet = createSet(images.ping);
+    auto pongSet = createSet(images.pong);
+
+    return MipChainDescriptorSet{
+        .counter = std::move(counter),
+
+        .ping = std::move(pingSet),
+        .pong = std::move(pongSet),
+    };
+}
+
+EffectPipelines& ChainContext::getEffectPipelines() noexcept
+{
+    return mEffectPipelines.value();
+}
+
+ChainRecorder& ChainContext::getChainRecorder() noexcept
+{
+    return mChainRecorder.value();
+}
+
+LutCache& ChainContext::getLutCache() noexcept
+{
+    return mLutCache.value();
+}
+
+BlurCache& ChainContext::getBlurCache() noexcept
+{
+    return mBlurCache.value();
+}
+
+WorkingFormat ChainContext::getWorkingFormat() const noexcept
+{
+    return mWorkingFormat;
+}
+
+uint32_t ChainContext::getLutDescriptorCount() noexcept
+{
+    return gLutDescriptorCount;
+}
+
+uint32_t ChainContext::getBlurDescriptorSetCount(uint32_t chainsInFlight) noexcept
+{
+    return _getBlurCapacity(chainsInFlight) * gBlurMaxLevels * gBlurLevelSetCount;
+}
+
+uint32_t ChainContext::_getBlurCapacity(uint32_t chainsInFlight) noexcept
+{
+    // Every chain in flight may hold a pyramid of its own resolution, and the oldest of them
+    // has completed by the time the next one is recorded
+    return std::max(chainsInFlight, 1U);
+}
+
+uint32_t ChainContext::getStatsDescriptorSetCount() noexcept
+{
+    return gStatsDescriptorSetCount;
+}
+
+uint32_t ChainContext::getMaxMipLevels() noexcept
+{
+    return gMipMaxLevels;
+}
+
+bool ChainContext::_hasSubgroupArithmetic() const
+{
+    const auto properties = mDevice.getPhysicalDevice().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceSubgroupProperties>();
+    const auto& subgroup = properties.get<vk::PhysicalDeviceSubgroupProperties>();
+
+    const auto required = vk::SubgroupFeatureFlagBits::eBasic | vk::SubgroupFeatureFlagBits::eArithmetic;
+
+    return (subgroup.supportedStages & vk::ShaderStageFlagBits::eCompute) && (subgroup.supportedOperations & required) == required;
+}
+
+void ChainContext::_createDescriptorLayouts()
+{
+    std::vector<DescriptorLayoutBindingConfig> samplerBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eCombinedImageSampler,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 1U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+    };
+
+    DescriptorLayoutConfig samplerLayoutConfig = {
+        .bindings = samplerBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mSamplerDescriptorLayout.emplace(mDevice, samplerLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> effectBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 1U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+    };
+
+    DescriptorLayoutConfig effectLayoutConfig = {
+        .bindings = effectBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mEffectDescriptorLayout.emplace(mDevice, effectLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> fusedBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 1U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 2U,
+            .type = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorLayoutConfig fusedLayoutConfig = {
+        .bindings = fusedBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mFusedDescriptorLayout.emplace(mDevice, fusedLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> lutBakeBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 1U,
+            .type = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorLayoutConfig lutBakeLayoutConfig = {
+        .bindings = lutBakeBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mLutBakeDescriptorLayout.emplace(mDevice, lutBakeLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> lutSampleBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eCombinedImageSampler,
+        },
+    };
+
+    DescriptorLayoutConfig lutSampleLayoutConfig = {
+        .bindings = lutSampleBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mLutSampleDescriptorLayout.emplace(mDevice, lutSampleLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> statsBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorLayoutConfig statsLayoutConfig = {
+        .bindings = statsBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mStatsDescriptorLayout.emplace(mDevice, statsLayoutConfig);
+
+    std::vector<DescriptorLayoutBindingConfig> mipBindings{
+        DescriptorLayoutBindingConfig{
+            .binding = 0U,
+            .type = vk::DescriptorType::eStorageImage,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 1U,
+            .type = vk::DescriptorType::eStorageImage,
+            .count = gMipMaxLevels - 1U,
+        },
+        DescriptorLayoutBindingConfig{
+            .binding = 2U,
+            .type = vk::DescriptorType::eStorageBuffer,
+        },
+    };
+
+    DescriptorLayoutConfig mipLayoutConfig = {
+        .bindings = mipBindings,
+        .stages = vk::ShaderStageFlagBits::eCompute,
+    };
+
+    mMipDescriptorLayout.emplace(mDevice, mipLayoutConfig);
+}
+
+void ChainContext::_createPipelines(const ChainContextConfig& config)
+{
+    const uint32_t workerCount = std::max(1U, std::thread::hardware_concurrency());
+
+    // Every pipeline reads its own shader and compiles independently, and the cache is internally synchronized
+    ThreadPool pool{ workerCount };
+
+    auto build = [this, &pool](const ComputePipelineConfig& pipelineConfig) {
+        return pool.submit([this, pipelineConfig] { return ComputePipeline{ mDevice, pipelineConfig }; });
+    };
+
+    ComputePipelineConfig samplerConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("sampler.spv"), mWorkingFormat),
+        .descriptorLayout = mSamplerDescriptorLayout.value(),
+        .usePushConstants = false,
+    };
+
+    auto samplerPipeline = build(samplerConfig);
+
+    ComputePipelineConfig fusedConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("fused.spv"), mWorkingFormat, mDevice.isShaderFloat16Enabled()),
+        .descriptorLayout = mFusedDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = 2U * sizeof(uint32_t),
+    };
+
+    // Writes its own RGBA16F lattice, so it is the one pass without working format variants
+    ComputePipelineConfig lutBakeConfig = {
+        .shaderPath = BinaryReader::toShaderBinPath("lut_bake.spv"),
+        .descriptorLayout = mLutBakeDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = sizeof(uint32_t),
+    };
+
+    ComputePipelineConfig lutApplyConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("lut_apply.spv"), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .secondaryLayout = &mLutSampleDescriptorLayout.value(),
+        .usePushConstants = false,
+    };
+
+    ComputePipelineConfig blurPassConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("blur_pass.spv"), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = sizeof(BlurPassConstants),
+    };
+
+    ComputePipelineConfig blurApplyConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("blur_apply.spv"), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = sizeof(BlurApplyConstants),
+    };
+
+    // Reads the chain or a pyramid level through set 0 and writes the next level through set 1
+    ComputePipelineConfig blurDownConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("blur_down.spv"), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .secondaryLayout = &mEffectDescriptorLayout.value(),
+        .usePushConstants = false,
+    };
+
+    ComputePipelineConfig blurUpsampleConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("blur_upsample.spv"), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .secondaryLayout = &mLutSampleDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = sizeof(BlurApplyConstants),
+    };
+
+    // Reads the image through binding 0 of an effect set, so either ping/pong direction works.
+    // Devices without subgroup arithmetic get a build reducing through shared atomics alone.
+    const auto statsReduceShader = _hasSubgroupArithmetic() ? "stats_reduce.spv" : "stats_reduce_atomic.spv";
+    ComputePipelineConfig statsReduceConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath(statsReduceShader), mWorkingFormat),
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .secondaryLayout = &mStatsDescriptorLayout.value(),
+        .usePushConstants = false,
+    };
+
+    ComputePipelineConfig mipDownsampleConfig = {
+        .shaderPath = toShaderVariantPath(BinaryReader::toShaderBinPath("mip_downsample.spv"), mWorkingFormat),
+        .descriptorLayout = mMipDescriptorLayout.value(),
+        .usePushConstants = true,
+        .pushConstantSize = sizeof(int32_t),
+    };
+
+    auto fusedPipeline = build(fusedConfig);
+    auto lutBakePipeline = build(lutBakeConfig);
+    auto lutApplyPipeline = build(lutApplyConfig);
+    auto blurPassPipeline = build(blurPassConfig);
+    auto blurApplyPipeline = build(blurApplyConfig);
+    auto blurDownPipeline = build(blurDownConfig);
+    auto blurUpsamplePipeline = build(blurUpsampleConfig);
+    auto statsReducePipeline = build(statsReduceConfig);
+    auto mipDownsamplePipeline = build(mipDownsampleConfig);
+
+    // Effect pipelines are only built once an effect is used, or ahead of that when prewarmed
+    EffectPipelinesConfig effectConfig = {
+        .registry = config.registry,
+        .descriptorLayout = mEffectDescriptorLayout.value(),
+        .statsLayout = mStatsDescriptorLayout.value(),
+        .workingFormat = mWorkingFormat,
+        .workerCount = workerCount,
+    };
+
+    mEffectPipelines.emplace(mDevice, effectConfig);
+    mEffectPipelines->prewarm(config.prewarmEffects);
+
+    // Failures are rethrown here, the pool still finishes the remaining builds before it is destroyed
+    mSamplerPipeline.emplace(samplerPipeline.get());
+
+    mPipelineSet.emplace(PipelineSet{
+        .effectPipelines = mEffectPipelines.value(),
+        .fusedPipeline = fusedPipeline.get(),
+        .lutBakePipeline = lutBakePipeline.get(),
+        .lutApplyPipeline = lutApplyPipeline.get(),
+        .blurPassPipeline = blurPassPipeline.get(),
+        .blurApplyPipeline = blurApplyPipeline.get(),
+        .blurDownPipeline = blurDownPipeline.get(),
+        .blurUpsamplePipeline = blurUpsamplePipeline.get(),
+        .statsReducePipeline = statsReducePipeline.get(),
+        .mipDownsamplePipeline = mipDownsamplePipeline.get(),
+    });
+}
+
+void ChainContext::_createChainRecorder(const ChainContextConfig& config)
+{
+    LutCacheConfig lutCacheConfig = {
+        .commandPool = mCommandPool,
+        .descriptorPool = mDescriptorPool,
+
+        .bakeLayout = mLutBakeDescriptorLayout.value(),
+        .sampleLayout = mLutSampleDescriptorLayout.value(),
+        .bakePipeline = mPipelineSet->lutBakePipeline,
+        .sampler = mClampSampler.value(),
+
+        .size = config.lutSize,
+        .capacity = gLutCapacity,
+        .opCapacity = gFusedOpCapacity,
+    };
+
+    mLutCache.emplace(mDevice, lutCacheConfig);
+
+    // The LUT sample layout is a lone combined image sampler, which pyramid levels share
+    BlurCacheConfig blurCacheConfig = {
+        .commandPool = mCommandPool,
+        .descriptorPool = mDescriptorPool,
+
+        .levelLayout = mEffectDescriptorLayout.value(),
+        .sampleLayout = mLutSampleDescriptorLayout.value(),
+        .sampler = mClampSampler.value(),
+
+        .format = mWorkingFormat,
+        .capacity = _getBlurCapacity(config.chainsInFlight),
+        .maxLevels = gBlurMaxLevels,
+    };
+
+    mBlurCache.emplace(mDevice, blurCacheConfig);
+
+    mEffectStats.emplace(createStatsTarget(false));
+
+    // Float chains keep values outside [0, 1], so their color runs are always fused and the cache only exports .cube files
+    ChainRecorderConfig recorderConfig = {
+        .samplerPipeline = mSamplerPipeline.value(),
+        .pipelineSet = mPipelineSet.value(),
+        .stageCache = config.stageCache,
+        .lutCache = canBakeLut(mWorkingFormat) ? &mLutCache.value() : nullptr,
+        .blurCache = &mBlurCache.value(),
+        .effectStats = mEffectStats.value(),
+        .profiler = config.profiler,
+        .fusedOpCapacity = gFusedOpCapacity,
+        .blurMaxLevels = gBlurMaxLevels,
+    };
+
+    mChainRecorder.emplace(recorderConfig);
+}
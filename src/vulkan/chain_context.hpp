@@ -0,0 +1,114 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <effect/registry.hpp>
+#include <vulkan/include.hpp>
+#include <vulkan/sampler.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/buffer/blur_cache.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/chain_recorder.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/buffer/lut_cache.hpp>
+#include <vulkan/descriptor/descriptor_layout.hpp>
+#include <vulkan/descriptor/descriptor_pool.hpp>
+#include <vulkan/pipeline/compute_pipeline.hpp>
+#include <vulkan/pipeline/pipeline_set.hpp>
+#include <vulkan/query/image_stats.hpp>
+
+class Device;
+class GpuProfiler;
+class StageCache;
+
+struct ChainContextConfig
+{
+    const CommandPool& commandPool;
+    const DescriptorPool& descriptorPool;
+
+    const EffectRegistry& registry;
+
+    // Both optional, see ChainRecorderConfig
+    StageCache* stageCache;
+    GpuProfiler* profiler;
+
+    // Lattice points per axis of baked color LUTs
+    uint32_t lutSize;
+
+    // Format of the images passed to createDescriptors, selects the shader variants
+    WorkingFormat workingFormat = WorkingFormat::Rgba8;
+
+    // Chains that may be recorded before the oldest one completes, sizes the blur cache
+    uint32_t chainsInFlight = 1U;
+
+    // Effects whose pipelines start building in the background right away
+    std::vector<std::string> prewarmEffects = {};
+};
+
+// Descriptor layouts, compute pipelines and caches needed to evaluate effect chains,
+// shared by the windowed and the headless renderer
+class ChainContext
+{
+public:
+    ChainContext(const Device& device, const ChainContextConfig& config);
+
+    // Binds the ping/pong pair of `images` to every compute pass, reading the original through `sampler`
+    [[nodiscard]] ComputeDescriptorSet createDescriptors(const RenderImageSet& images, const Sampler& sampler, const Buffer& fusedOpBuffer) const;
+    [[nodiscard]] Buffer createFusedOpBuffer() const;
+    // With `hostVisible`, the statistics stay mapped for the host to read once the reduction completes
+    [[nodiscard]] ImageStatsTarget createStatsTarget(bool hostVisible) const;
+    // Binds every mip level of both images of `images` for ChainRecorder::recordMips
+    [[nodiscard]] MipChainDescriptorSet createMipDescriptors(const RenderImageSet& images) const;
+
+    [[nodiscard]] EffectPipelines& getEffectPipelines() noexcept;
+    [[nodiscard]] ChainRecorder& getChainRecorder() noexcept;
+    [[nodiscard]] LutCache& getLutCache() noexcept;
+    [[nodiscard]] BlurCache& getBlurCache() noexcept;
+    [[nodiscard]] WorkingFormat getWorkingFormat() const noexcept;
+
+    // Descriptor sets and descriptors of each type the LUT cache allocates from the pool
+    [[nodiscard]] static uint32_t getLutDescriptorCount() noexcept;
+    // Descriptor sets the blur cache allocates from the pool, each with two storage images or one sampled image
+    [[nodiscard]] static uint32_t getBlurDescriptorSetCount(uint32_t chainsInFlight) noexcept;
+    // Descriptor sets, each with one storage buffer, the context allocates for the statistics its effects read
+    [[nodiscard]] static uint32_t getStatsDescriptorSetCount() noexcept;
+    // Mip levels recordMips fills, including the full resolution one. Each set createMipDescriptors
+    // allocates holds this many storage images and one storage buffer, and it allocates two.
+    [[nodiscard]] static uint32_t getMaxMipLevels() noexcept;
+private:
+    [[nodiscard]] static uint32_t _getBlurCapacity(uint32_t chainsInFlight) noexcept;
+
+    // Whether the statistics reduction can combine invocations with subgroup arithmetic
+    bool _hasSubgroupArithmetic() const;
+    void _createDescriptorLayouts();
+    void _createPipelines(const ChainContextConfig& config);
+    void _createChainRecorder(const ChainContextConfig& config);
+
+    const Device& mDevice;
+    const CommandPool& mCommandPool;
+    const DescriptorPool& mDescriptorPool;
+    WorkingFormat mWorkingFormat;
+
+    // Shared by LUT lookups and blur upsampling
+    std::optional<Sampler> mClampSampler;
+
+    std::optional<DescriptorLayout> mSamplerDescriptorLayout;
+    std::optional<DescriptorLayout> mEffectDescriptorLayout;
+    std::optional<DescriptorLayout> mFusedDescriptorLayout;
+    std::optional<DescriptorLayout> mLutBakeDescriptorLayout;
+    std::optional<DescriptorLayout> mLutSampleDescriptorLayout;
+    std::optional<DescriptorLayout> mStatsDescriptorLayout;
+    std::optional<DescriptorLayout> mMipDescriptorLayout;
+
+    std::optional<ComputePipeline> mSamplerPipeline;
+    std::optional<EffectPipelines> mEffectPipelines;
+    std::optional<PipelineSet> mPipelineSet;
+
+    std::optional<LutCache> mLutCache;
+    std::optional<BlurCache> mBlurCache;
+    // Reduced from the input of every effect that reads image statistics, in turn
+    std::optional<ImageStatsTarget> mEffectStats;
+    std::optional<ChainRecorder> mChainRecorder;
+};
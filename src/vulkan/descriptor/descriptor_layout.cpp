@@ -11,7 +11,7 @@ DescriptorLayout::DescriptorLayout(const Device& device, const DescriptorLayoutC
 
         vk::DescriptorSetLayoutBinding binding{};
         binding.binding = configBinding.binding;
-        binding.descriptorCount = 1U;
+        binding.descriptorCount = configBinding.count;
         binding.descriptorType = configBinding.type;
         binding.pImmutableSamplers = nullptr;
         binding.stageFlags = config.stages;
@@ -10,6 +10,8 @@ struct DescriptorLayoutBindingConfig
 {
     uint32_t binding;
     vk::DescriptorType type;
+    // Array size of the binding
+    uint32_t count = 1U;
 };
 
 struct DescriptorLayoutConfig
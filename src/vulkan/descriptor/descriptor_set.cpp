@@ -3,6 +3,7 @@
 #include <utility>
 
 #include <vulkan/device.hpp>
+#include <vulkan/buffer/buffer.hpp>
 
 DescriptorSet::DescriptorSet(const Device& device, const DescriptorSetConfig& config)
     : mDevice{ device }
@@ -19,17 +20,21 @@ DescriptorSet::DescriptorSet(const Device& device, const DescriptorSetConfig& co
 
 void DescriptorSet::update(const DescriptorUpdateConfig& config) const
 {
+    const size_t bufferCount = config.buffers != nullptr ? config.buffers->size() : 0U;
+
     std::vector<vk::WriteDescriptorSet> descriptorWrites;
     std::vector<vk::DescriptorImageInfo> imageInfos;
-    descriptorWrites.reserve(config.images.size());
+    std::vector<vk::DescriptorBufferInfo> bufferInfos;
+    descriptorWrites.reserve(config.images.size() + bufferCount);
     imageInfos.reserve(config.images.size());
+    bufferInfos.reserve(bufferCount);
 
     for (size_t i = 0; i < config.images.size(); i++) {
         const auto& image = config.images[i];
 
         vk::DescriptorImageInfo imageInfo{};
         imageInfo.setImageLayout(image.layout);
-        imageInfo.setImageView(image.texture.getImageView());
+        imageInfo.setImageView(image.view ? image.view : image.texture.getImageView());
         if (image.sampler != nullptr)
             imageInfo.setSampler(image.sampler->getVkHandle());
 
@@ -38,7 +43,7 @@ void DescriptorSet::update(const DescriptorUpdateConfig& config) const
         vk::WriteDescriptorSet descriptorWrite{};
         descriptorWrite.setDstSet(mSet.get());
         descriptorWrite.setDstBinding(image.binding);
-        descriptorWrite.setDstArrayElement(0U);
+        descriptorWrite.setDstArrayElement(image.arrayElement);
         descriptorWrite.setDescriptorType(image.descriptorType);
         descriptorWrite.setDescriptorCount(1U);
         descriptorWrite.setPImageInfo(&imageInfos.back());
@@ -46,6 +51,27 @@ void DescriptorSet::update(const DescriptorUpdateConfig& config) const
         descriptorWrites.push_back(descriptorWrite);
     }
 
+    for (size_t i = 0; i < bufferCount; i++) {
+        const auto& buffer = config.buffers->at(i);
+
+        vk::DescriptorBufferInfo bufferInfo{};
+        bufferInfo.setBuffer(buffer.buffer.getVkHandle());
+        bufferInfo.setOffset(0U);
+        bufferInfo.setRange(buffer.range);
+
+        bufferInfos.push_back(bufferInfo);
+
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.setDstSet(mSet.get());
+        descriptorWrite.setDstBinding(buffer.binding);
+        descriptorWrite.setDstArrayElement(0U);
+        descriptorWrite.setDescriptorType(buffer.descriptorType);
+        descriptorWrite.setDescriptorCount(1U);
+        descriptorWrite.setPBufferInfo(&bufferInfos.back());
+
+        descriptorWrites.push_back(descriptorWrite);
+    }
+
     mDevice.getVkHandle().updateDescriptorSets(descriptorWrites, nullptr);
 }
 
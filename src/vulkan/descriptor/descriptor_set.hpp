@@ -8,6 +8,7 @@
 #include <vulkan/descriptor/descriptor_layout.hpp>
 #include <vulkan/descriptor/descriptor_pool.hpp>
 
+class Buffer;
 class Device;
 
 struct DescriptorSetConfig
@@ -23,11 +24,24 @@ struct DescriptorSetImage
     const Sampler* sampler;
     vk::ImageLayout layout;
     vk::DescriptorType descriptorType;
+
+    uint32_t arrayElement = 0U;
+    // Replaces the texture's own view when set, e.g. with a single mip level
+    vk::ImageView view = {};
+};
+
+struct DescriptorSetBuffer
+{
+    uint32_t binding;
+    const Buffer& buffer;
+    vk::DeviceSize range;
+    vk::DescriptorType descriptorType;
 };
 
 struct DescriptorUpdateConfig
 {
     const std::vector<DescriptorSetImage>& images;
+    const std::vector<DescriptorSetBuffer>* buffers = nullptr;
 };
 
 class DescriptorSet
@@ -1,29 +1,54 @@
 #include "device.hpp"
 
-#include <vulkan/renderer.hpp>
+#include <trace/trace.hpp>
 #include <vulkan/swapchain.hpp>
 #include <window.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 
-Device::Device(const VkRendererConfig& config, VkRenderer& renderer)
-    : mRenderer(renderer)
-    , mInstance{mRenderer.getInstance()}
-    , mWindow{config.window}
+static const vk::DeviceSize gMemoryBlockSize = 64U * 1024U * 1024U;
+
+Device::Device(const DeviceConfig& config)
+    : mInstance{ config.instance }
+    , mSurface{ config.surface }
+    , mWindow{ config.window }
 {
     mPhysicalDevice = _pickPhysicalDevice(config.deviceExtensions);
     mQueueFamilies = _findQueueFamilies(mPhysicalDevice);
+    _queryOptionalExtensions();
 
     auto deviceCreationResult = _createLogicalDevice(config);
     mDevice = std::move(deviceCreationResult.device);
     mGraphicsQueue = deviceCreationResult.graphicsQueue;
     mPresentQueue = deviceCreationResult.presentQueue;
     mComputeQueue = deviceCreationResult.computeQueue;
+    mTransferQueue = deviceCreationResult.transferQueue;
+    mAsyncComputeQueue = deviceCreationResult.asyncComputeQueue;
+
+    MemoryAllocatorConfig allocatorConfig = {
+        .physicalDevice = mPhysicalDevice,
+        .device = mDevice.get(),
+        .blockSize = gMemoryBlockSize,
+    };
+
+    mAllocator.emplace(allocatorConfig);
+
+    PipelineCacheConfig pipelineCacheConfig = {
+        .physicalDevice = mPhysicalDevice,
+        .device = mDevice.get(),
+        .path = config.pipelineCachePath,
+    };
 
-    recreateSwapchain();
+    mPipelineCache.emplace(pipelineCacheConfig);
+
+    if (!isHeadless()) {
+        recreateSwapchain();
+    }
 }
 
 vk::PhysicalDevice Device::_pickPhysicalDevice(const std::vector<const char*>& extensions)
@@ -31,7 +56,7 @@ vk::PhysicalDevice Device::_pickPhysicalDevice(const std::vector<const char*>& e
     vk::PhysicalDevice physicalDevice = VK_NULL_HANDLE;
     uint32_t deviceScore = 0;
 
-    auto devices = mInstance->enumeratePhysicalDevices();
+    auto devices = mInstance.enumeratePhysicalDevices();
 
     if (devices.size() == 0) {
         throw std::runtime_error("No found GPUs for Vulkan.");
@@ -81,19 +106,24 @@ uint32_t Device::_calculateDeviceScore(const vk::PhysicalDevice& device, const s
         break;
     }
 
+    // Anisotropic filtering only improves the preview, so it's preferred but not required
     auto features = device.getFeatures();
-    if (!features.samplerAnisotropy) {
-        return 0;
+    if (features.samplerAnisotropy) {
+        score += 100;
     }
 
     auto families = _findQueueFamilies(device);
-    if (!families.isComplete()) {
+    if (!families.isComplete(isHeadless())) {
         return 0;
     }
     if (!_verifyDeviceExtensionSupport(device, extensions)) {
         return 0;
     }
 
+    if (isHeadless()) {
+        return score;
+    }
+
     auto swapchainDetails = querySwapchainDetails(device);
 
     if (swapchainDetails.formats.empty() || swapchainDetails.presentModes.empty()) {
@@ -116,6 +146,20 @@ bool Device::_verifyDeviceExtensionSupport(vk::PhysicalDevice device, const std:
     return requiredExts.empty();
 }
 
+void Device::_queryOptionalExtensions()
+{
+    auto exts = mPhysicalDevice.enumerateDeviceExtensionProperties();
+
+    const bool hostImport = std::any_of(exts.begin(), exts.end(), [](const auto& ext) {
+        return std::string_view{ ext.extensionName } == VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME;
+    });
+
+    if (hostImport) {
+        auto props = mPhysicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>();
+        mHostImportAlignment = props.get<vk::PhysicalDeviceExternalMemoryHostPropertiesEXT>().minImportedHostPointerAlignment;
+    }
+}
+
 DeviceSwapchainDetails Device::querySwapchainDetails(vk::PhysicalDevice device) const
 {
     auto surface = getSurface();
@@ -138,7 +182,7 @@ DeviceSwapchainDetails Device::querySwapchainDetails() const
 
 const Window& Device::getWindow() const
 {
-    return mWindow;
+    return *mWindow;
 }
 
 const vk::PhysicalDevice Device::getPhysicalDevice() const
@@ -148,7 +192,7 @@ const vk::PhysicalDevice Device::getPhysicalDevice() const
 
 const vk::SurfaceKHR Device::getSurface() const
 {
-    return mRenderer.getSurface();
+    return mSurface;
 }
 
 const DeviceQueueFamilies& Device::getQueueFamilies() const
@@ -171,6 +215,61 @@ const vk::Queue& Device::getPresentQueue() const
     return mPresentQueue;
 }
 
+const vk::Queue& Device::getComputeQueue() const
+{
+    return mComputeQueue;
+}
+
+const vk::Queue& Device::getTransferQueue() const
+{
+    return mTransferQueue;
+}
+
+const vk::Queue& Device::getAsyncComputeQueue() const
+{
+    return mAsyncComputeQueue;
+}
+
+MemoryAllocator& Device::getAllocator() const noexcept
+{
+    return *mAllocator;
+}
+
+PipelineCache& Device::getPipelineCache() const noexcept
+{
+    return *mPipelineCache;
+}
+
+bool Device::isHeadless() const noexcept
+{
+    return !mSurface;
+}
+
+bool Device::isSamplerAnisotropyEnabled() const noexcept
+{
+    return mSamplerAnisotropy;
+}
+
+bool Device::isShaderFloat16Enabled() const noexcept
+{
+    return mShaderFloat16;
+}
+
+bool Device::hasAsyncCompute() const noexcept
+{
+    return mQueueFamilies.asyncComputeFamily.has_value();
+}
+
+bool Device::isHostImportSupported() const noexcept
+{
+    return mHostImportAlignment > 0U;
+}
+
+vk::DeviceSize Device::getHostImportAlignment() const noexcept
+{
+    return mHostImportAlignment;
+}
+
 const vk::Device Device::getVkHandle() const
 {
     return mDevice.get();
@@ -188,13 +287,47 @@ DeviceQueueFamilies Device::_findQueueFamilies(const vk::PhysicalDevice& device)
         if ((family.queueFlags & vk::QueueFlagBits::eGraphics) && (family.queueFlags & vk::QueueFlagBits::eCompute)) {
             indices.graphicsAndComputeFamily = i;
         }
+        if ((family.queueFlags & vk::QueueFlagBits::eCompute) && !indices.computeFamily.has_value()) {
+            indices.computeFamily = i;
+        }
+
+        if (isHeadless()) continue;
 
         auto presentSupport = device.getSurfaceSupportKHR(i, surface);
         if (presentSupport) {
             indices.presentFamily = i;
         }
 
-        if (indices.isComplete()) {
+        if (indices.isComplete(false)) {
+            break;
+        }
+    }
+
+    // Keep compute work on the graphics queue when there is one
+    if (indices.graphicsAndComputeFamily.has_value()) {
+        indices.computeFamily = indices.graphicsAndComputeFamily;
+    }
+
+    // Transfer-only families are usually backed by DMA engines that copy alongside rendering
+    for (uint32_t i = 0; i < families.size(); i++) {
+        const auto flags = families[i].queueFlags;
+
+        if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+            indices.transferFamily = i;
+            break;
+        }
+    }
+
+    if (!indices.transferFamily.has_value()) {
+        indices.transferFamily = indices.computeFamily;
+    }
+
+    // Headless devices already run everything on a compute queue
+    for (uint32_t i = 0; i < families.size() && !isHeadless(); i++) {
+        const auto flags = families[i].queueFlags;
+
+        if ((flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics)) {
+            indices.asyncComputeFamily = i;
             break;
         }
     }
@@ -202,10 +335,19 @@ DeviceQueueFamilies Device::_findQueueFamilies(const vk::PhysicalDevice& device)
     return indices;
 }
 
-_DeviceCreationResult Device::_createLogicalDevice(const VkRendererConfig& config)
+_DeviceCreationResult Device::_createLogicalDevice(const DeviceConfig& config)
 {
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
-    std::set uniqueQueueFamilies = { mQueueFamilies.graphicsAndComputeFamily.value(), mQueueFamilies.presentFamily.value() };
+    std::set uniqueQueueFamilies = { mQueueFamilies.computeFamily.value(), mQueueFamilies.transferFamily.value() };
+
+    if (!isHeadless()) {
+        uniqueQueueFamilies.insert(mQueueFamilies.graphicsAndComputeFamily.value());
+        uniqueQueueFamilies.insert(mQueueFamilies.presentFamily.value());
+    }
+
+    if (mQueueFamilies.asyncComputeFamily.has_value()) {
+        uniqueQueueFamilies.insert(mQueueFamilies.asyncComputeFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (auto queueFamily : uniqueQueueFamilies) {
@@ -217,18 +359,35 @@ _DeviceCreationResult Device::_createLogicalDevice(const VkRendererConfig& confi
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    mSamplerAnisotropy = mPhysicalDevice.getFeatures().samplerAnisotropy;
+
     vk::PhysicalDeviceFeatures deviceFeatures{};
-    deviceFeatures.setSamplerAnisotropy(vk::True);
+    deviceFeatures.setSamplerAnisotropy(mSamplerAnisotropy ? vk::True : vk::False);
+
+    // Float16 arithmetic only speeds up the RGBA16F shader variants, so it's enabled where supported
+    auto supported = mPhysicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+    mShaderFloat16 = supported.get<vk::PhysicalDeviceVulkan12Features>().shaderFloat16;
+
+    vk::PhysicalDeviceVulkan12Features features12{};
+    features12.setTimelineSemaphore(vk::True);
+    features12.setShaderFloat16(mShaderFloat16 ? vk::True : vk::False);
 
     vk::PhysicalDeviceVulkan13Features features{};
     features.setSynchronization2(vk::True);
+    features.setPNext(&features12);
 
     vk::DeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.setQueueCreateInfos(queueCreateInfos);
     deviceCreateInfo.setPEnabledFeatures(&deviceFeatures);
     deviceCreateInfo.setPNext(&features);
 
-    deviceCreateInfo.setPEnabledExtensionNames(config.deviceExtensions);
+    // Optional extensions only add faster paths, so they are enabled on top of the required ones
+    std::vector<const char*> extensions = config.deviceExtensions;
+    if (isHostImportSupported()) {
+        extensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+    }
+
+    deviceCreateInfo.setPEnabledExtensionNames(extensions);
 
     deviceCreateInfo.setEnabledLayerCount(0);
     if (config.enableValidationLayers) {
@@ -237,9 +396,22 @@ _DeviceCreationResult Device::_createLogicalDevice(const VkRendererConfig& confi
 
     auto device = mPhysicalDevice.createDeviceUnique(deviceCreateInfo);
 
-    auto graphicsQueue = device->getQueue(mQueueFamilies.graphicsAndComputeFamily.value(), 0);
-    auto presentQueue = device->getQueue(mQueueFamilies.presentFamily.value(), 0);
-    auto computeQueue = device->getQueue(mQueueFamilies.graphicsAndComputeFamily.value(), 0);
+    auto computeQueue = device->getQueue(mQueueFamilies.computeFamily.value(), 0);
+    auto transferQueue = device->getQueue(mQueueFamilies.transferFamily.value(), 0);
+
+    // A headless device has neither graphics nor presentation
+    vk::Queue graphicsQueue{};
+    vk::Queue presentQueue{};
+    vk::Queue asyncComputeQueue{};
+
+    if (!isHeadless()) {
+        graphicsQueue = device->getQueue(mQueueFamilies.graphicsAndComputeFamily.value(), 0);
+        presentQueue = device->getQueue(mQueueFamilies.presentFamily.value(), 0);
+    }
+
+    if (mQueueFamilies.asyncComputeFamily.has_value()) {
+        asyncComputeQueue = device->getQueue(mQueueFamilies.asyncComputeFamily.value(), 0);
+    }
 
     return _DeviceCreationResult{
         .device = std::move(device),
@@ -247,6 +419,8 @@ _DeviceCreationResult Device::_createLogicalDevice(const VkRendererConfig& confi
         .graphicsQueue = graphicsQueue,
         .presentQueue = presentQueue,
         .computeQueue = computeQueue,
+        .transferQueue = transferQueue,
+        .asyncComputeQueue = asyncComputeQueue,
     };
 }
 
@@ -259,6 +433,8 @@ vk::UniqueSwapchainKHR Device::createSwapchainKHR(const vk::SwapchainCreateInfoK
 
 vk::ResultValue<uint32_t> Device::acquireNextImageKHR(vk::Semaphore semaphore, uint64_t timeout) const
 {
+    TRACE_SCOPE("Acquire");
+
     return mDevice->acquireNextImageKHR(mSwapchain->getVkHandle(), timeout, semaphore);
 }
 
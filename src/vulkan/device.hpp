@@ -2,21 +2,47 @@
 
 #include <vulkan/include.hpp>
 #include <vulkan/swapchain.hpp>
+#include <vulkan/memory/allocator.hpp>
+#include <vulkan/pipeline/pipeline_cache.hpp>
 
+#include <filesystem>
 #include <optional>
 #include <vector>
 
-class VkRenderer;
-struct VkRendererConfig;
 class Window;
 
+struct DeviceConfig
+{
+    vk::Instance instance;
+
+    // Both null for a headless device, which only needs a compute queue
+    vk::SurfaceKHR surface;
+    const Window* window;
+
+    bool enableValidationLayers;
+    const std::vector<const char*>& validationLayers;
+    const std::vector<const char*>& deviceExtensions;
+
+    // File the pipeline cache is loaded from and saved to, empty keeps it in memory
+    std::filesystem::path pipelineCachePath;
+};
+
 struct DeviceQueueFamilies
 {
     std::optional<uint32_t> graphicsAndComputeFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> computeFamily;
+    // Transfer-only family when the device has one, the compute family otherwise
+    std::optional<uint32_t> transferFamily;
+    // Compute family without graphics support, whose queue runs alongside rendering
+    std::optional<uint32_t> asyncComputeFamily;
 
-    bool isComplete() const
+    bool isComplete(bool headless) const
     {
+        if (headless) {
+            return computeFamily.has_value();
+        }
+
         return graphicsAndComputeFamily.has_value() && presentFamily.has_value();
     }
 };
@@ -28,6 +54,8 @@ struct _DeviceCreationResult
     vk::Queue graphicsQueue;
     vk::Queue presentQueue;
     vk::Queue computeQueue;
+    vk::Queue transferQueue;
+    vk::Queue asyncComputeQueue;
 };
 
 struct DeviceSwapchainDetails
@@ -40,7 +68,7 @@ struct DeviceSwapchainDetails
 class Device
 {
 public:
-    Device(const VkRendererConfig& config, VkRenderer& renderer);
+    explicit Device(const DeviceConfig& config);
 
     DeviceSwapchainDetails querySwapchainDetails(vk::PhysicalDevice device) const;
     DeviceSwapchainDetails querySwapchainDetails() const;
@@ -58,6 +86,26 @@ public:
 
     const vk::Queue& getGraphicsQueue() const;
     const vk::Queue& getPresentQueue() const;
+    const vk::Queue& getComputeQueue() const;
+    const vk::Queue& getTransferQueue() const;
+    // Null unless the device has an async compute family
+    const vk::Queue& getAsyncComputeQueue() const;
+
+    // Resources only hold const references to the device, but draw their memory from its pools
+    [[nodiscard]] MemoryAllocator& getAllocator() const noexcept;
+    // Every pipeline is created through it
+    [[nodiscard]] PipelineCache& getPipelineCache() const noexcept;
+
+    [[nodiscard]] bool isHeadless() const noexcept;
+    [[nodiscard]] bool isSamplerAnisotropyEnabled() const noexcept;
+    // Float16 arithmetic in shaders, picks the half-math RGBA16F variants
+    [[nodiscard]] bool isShaderFloat16Enabled() const noexcept;
+    [[nodiscard]] bool hasAsyncCompute() const noexcept;
+
+    // VK_EXT_external_memory_host is enabled when the device supports it
+    [[nodiscard]] bool isHostImportSupported() const noexcept;
+    // Alignment of both the address and the size of imported host memory
+    [[nodiscard]] vk::DeviceSize getHostImportAlignment() const noexcept;
 
     const vk::Device getVkHandle() const;
 private:
@@ -66,14 +114,19 @@ private:
     uint32_t _calculateDeviceScore(const vk::PhysicalDevice& device, const std::vector<const char*>& extensions);
     DeviceQueueFamilies _findQueueFamilies(const vk::PhysicalDevice& device) const;
     bool _verifyDeviceExtensionSupport(vk::PhysicalDevice device, const std::vector<const char*>& extensions);
+    void _queryOptionalExtensions();
 
-    _DeviceCreationResult _createLogicalDevice(const VkRendererConfig& config);
+    _DeviceCreationResult _createLogicalDevice(const DeviceConfig& config);
 
     vk::UniqueDevice mDevice;
 
-    VkRenderer& mRenderer;
-    const vk::UniqueInstance& mInstance;
-    const Window& mWindow;
+    vk::Instance mInstance;
+    vk::SurfaceKHR mSurface;
+    const Window* mWindow;
+
+    bool mSamplerAnisotropy = false;
+    bool mShaderFloat16 = false;
+    vk::DeviceSize mHostImportAlignment = 0U;
 
     vk::PhysicalDevice mPhysicalDevice;
     DeviceQueueFamilies mQueueFamilies;
@@ -81,6 +134,12 @@ private:
     vk::Queue mGraphicsQueue;
     vk::Queue mPresentQueue;
     vk::Queue mComputeQueue;
+    vk::Queue mTransferQueue;
+    vk::Queue mAsyncComputeQueue;
 
     std::optional<DeviceSwapchain> mSwapchain;
+
+    // Declared last so they are destroyed before the device
+    mutable std::optional<MemoryAllocator> mAllocator;
+    mutable std::optional<PipelineCache> mPipelineCache;
 };
@@ -0,0 +1,328 @@
+#include "headless_renderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <io/path.hpp>
+
+#include <vulkan/buffer/commandbuffer.hpp>
+#include <vulkan/buffer/texture.hpp>
+
+// Descriptor sets of one image in flight: the sampler pass and both directions of the effect and fused passes
+static const uint32_t gEvaluationSetCount = 5U;
+
+// The ping/pong images hold linear values, the swapchain would normally encode them to sRGB
+static const std::array<uint8_t, 256> gLinearToSrgb = [] {
+    std::array<uint8_t, 256> table{};
+
+    for (size_t i = 0; i < table.size(); i++) {
+        double linear = static_cast<double>(i) / 255.0;
+        double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+
+        table[i] = static_cast<uint8_t>(std::lround(encoded * 255.0));
+    }
+
+    return table;
+}();
+
+// Float readback keeps more precision than 256 steps, so it is quantized finer before encoding
+static const size_t gFloatTableSize = 4096U;
+
+static const std::array<uint8_t, gFloatTableSize> gFloatLinearToSrgb = [] {
+    std::array<uint8_t, gFloatTableSize> table{};
+
+    for (size_t i = 0; i < table.size(); i++) {
+        double linear = static_cast<double>(i) / static_cast<double>(gFloatTableSize - 1U);
+        double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+
+        table[i] = static_cast<uint8_t>(std::lround(encoded * 255.0));
+    }
+
+    return table;
+}();
+
+static size_t _toTableIndex(float value, size_t tableSize)
+{
+    // Also maps NaN to zero
+    const float clamped = value > 0.0F ? std::min(value, 1.0F) : 0.0F;
+
+    return static_cast<size_t>(std::lround(clamped * static_cast<float>(tableSize - 1U)));
+}
+
+template<typename Texel, typename Decode>
+static void _encodeFloatTexels(const uint8_t* texels, std::vector<uint8_t>& pixels, Decode decode)
+{
+    for (size_t i = 0; i < pixels.size(); i++) {
+        Texel texel;
+        std::memcpy(&texel, texels + i * sizeof(Texel), sizeof(Texel));
+
+        const float value = decode(texel);
+
+        pixels[i] = (i % 4U) == 3U
+            ? static_cast<uint8_t>(_toTableIndex(value, 256U))
+            : gFloatLinearToSrgb[_toTableIndex(value, gFloatTableSize)];
+    }
+}
+
+void encodeLinearToSrgb(std::vector<uint8_t>& pixels)
+{
+    for (size_t i = 0; i + 3U < pixels.size(); i += 4U) {
+        pixels[i + 0U] = gLinearToSrgb[pixels[i + 0U]];
+        pixels[i + 1U] = gLinearToSrgb[pixels[i + 1U]];
+        pixels[i + 2U] = gLinearToSrgb[pixels[i + 2U]];
+    }
+}
+
+std::vector<uint8_t> encodeReadbackToSrgb(const uint8_t* texels, size_t pixelCount, vk::Format format)
+{
+    std::vector<uint8_t> pixels(pixelCount * 4U);
+
+    if (format == vk::Format::eR16G16B16A16Sfloat) {
+        _encodeFloatTexels<uint16_t>(texels, pixels, [](uint16_t texel) { return halfToFloat(texel); });
+    }
+    else if (format == vk::Format::eR32G32B32A32Sfloat) {
+        _encodeFloatTexels<float>(texels, pixels, [](float texel) { return texel; });
+    }
+    else {
+        std::memcpy(pixels.data(), texels, pixels.size());
+        encodeLinearToSrgb(pixels);
+    }
+
+    return pixels;
+}
+
+HeadlessRenderer::HeadlessRenderer(const HeadlessRendererConfig& config)
+    : mWorkingFormat{ config.workingFormat }
+{
+    _createInstance(config);
+    _createDevice(config);
+    _createCommandPool();
+    _createDescriptorPool(config);
+    _createChainContext(config);
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+    if (mDevice.has_value()) {
+        mDevice->getPipelineCache().save();
+    }
+}
+
+HeadlessImage HeadlessRenderer::process(const ImageLoadResult& image, const std::vector<EffectInstance>& effects, const EffectChainOptions& options)
+{
+    if (image.pixels == nullptr || image.texWidth <= 0 || image.texHeight <= 0) {
+        throw std::runtime_error("Cannot process an empty image.");
+    }
+
+    const auto& device = mDevice.value();
+    const auto& commandPool = mCommandPool.value();
+
+    const auto width = static_cast<uint32_t>(image.texWidth);
+    const auto height = static_cast<uint32_t>(image.texHeight);
+
+    SampledImageConfig sourceConfig = {
+        .commandPool = commandPool,
+        .width = width,
+        .height = height,
+    };
+
+    TextureImage source{ device, sourceConfig };
+
+    BufferConfig stagingConfig = {
+        .size = vk::DeviceSize{ width } * height * 4U,
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = commandPool,
+        .persistentMap = true,
+    };
+
+    Buffer staging{ device, stagingConfig };
+    std::memcpy(staging.getMappedData(), image.pixels, static_cast<size_t>(stagingConfig.size));
+
+    ComputeImageConfig pingPongConfig = {
+        .commandPool = commandPool,
+        .width = width,
+        .height = height,
+        .format = mWorkingFormat,
+    };
+
+    RenderImageSet images{
+        source,
+        TextureImage{ device, pingPongConfig },
+        TextureImage{ device, pingPongConfig },
+    };
+
+    auto descriptors = mChainContext->createDescriptors(images, mSampler.value(), mFusedOpBuffer.value());
+
+    BufferConfig readbackConfig = {
+        .size = vk::DeviceSize{ width } * height * getPixelSize(mWorkingFormat),
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+        .properties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        .commandPool = commandPool,
+        .persistentMap = true,
+    };
+
+    Buffer readback{ device, readbackConfig };
+
+    EffectChain chain{ effects, options };
+
+    {
+        auto commandBuffer = SingleTimeCommandBuffer{ device, commandPool };
+        auto buffer = commandBuffer.getVkHandle();
+
+        // The upload shares the submission with the chain instead of waiting on its own
+        source.recordUpload(buffer, staging.getVkHandle());
+
+        // Every earlier evaluation was waited on
+        const auto frame = nextFrame();
+
+        auto& recorder = mChainContext->getChainRecorder();
+        recorder.beginFrame(frame, frame - 1U);
+
+        bool resultInPong = recorder.record(buffer, chain, images, descriptors, mFusedOpBuffer.value());
+
+        const auto& resultImage = resultInPong ? images.pong : images.ping;
+        resultImage.recordReadback(buffer, readback);
+    }
+
+    return HeadlessImage{
+        .width = width,
+        .height = height,
+        .pixels = encodeReadbackToSrgb(static_cast<const uint8_t*>(readback.getMappedData()), size_t{ width } * height, toVkFormat(mWorkingFormat)),
+    };
+}
+
+const Device& HeadlessRenderer::getDevice() const noexcept
+{
+    return mDevice.value();
+}
+
+const CommandPool& HeadlessRenderer::getCommandPool() const noexcept
+{
+    return mCommandPool.value();
+}
+
+const Sampler& HeadlessRenderer::getSampler() const noexcept
+{
+    return mSampler.value();
+}
+
+ChainContext& HeadlessRenderer::getChainContext() noexcept
+{
+    return mChainContext.value();
+}
+
+WorkingFormat HeadlessRenderer::getWorkingFormat() const noexcept
+{
+    return mWorkingFormat;
+}
+
+uint64_t HeadlessRenderer::nextFrame() noexcept
+{
+    return ++mFrame;
+}
+
+void HeadlessRenderer::_createInstance(const HeadlessRendererConfig& config)
+{
+    InstanceConfig instanceConfig = {
+        .requiredExtensions = config.requiredExtensions,
+
+        .enableValidationLayers = config.enableValidationLayers,
+        .validationLayers = config.validationLayers,
+
+        .printExtensions = false,
+    };
+
+    mInstance.emplace(instanceConfig);
+}
+
+void HeadlessRenderer::_createDevice(const HeadlessRendererConfig& config)
+{
+    DeviceConfig deviceConfig = {
+        .instance = mInstance->getVkHandle(),
+
+        .surface = nullptr,
+        .window = nullptr,
+
+        .enableValidationLayers = config.enableValidationLayers,
+        .validationLayers = config.validationLayers,
+        .deviceExtensions = config.deviceExtensions,
+
+        .pipelineCachePath = Paths::PipelineCache,
+    };
+
+    mDevice.emplace(deviceConfig);
+}
+
+void HeadlessRenderer::_createCommandPool()
+{
+    CommandPoolConfig config = {
+        .queueFamilyIndex = mDevice->getQueueFamilies().computeFamily.value(),
+    };
+
+    mCommandPool.emplace(mDevice.value(), config);
+}
+
+void HeadlessRenderer::_createDescriptorPool(const HeadlessRendererConfig& config)
+{
+    const uint32_t lutDescriptorCount = ChainContext::getLutDescriptorCount();
+    const uint32_t blurSetCount = ChainContext::getBlurDescriptorSetCount(config.maxImagesInFlight);
+    const uint32_t statsSetCount = ChainContext::getStatsDescriptorSetCount();
+    const uint32_t slotCount = config.maxImagesInFlight;
+
+    std::vector<DescriptorPoolSize> poolSizes{
+        DescriptorPoolSize{
+            .type = vk::DescriptorType::eCombinedImageSampler,
+            .count = slotCount + lutDescriptorCount + blurSetCount,
+        },
+        DescriptorPoolSize{
+            .type = vk::DescriptorType::eStorageImage,
+            .count = slotCount * gEvaluationSetCount * 2U + lutDescriptorCount + blurSetCount * 2U,
+        },
+        DescriptorPoolSize{
+            .type = vk::DescriptorType::eStorageBuffer,
+            .count = slotCount * 2U + lutDescriptorCount + statsSetCount,
+        },
+    };
+
+    DescriptorPoolConfig poolConfig{
+        .sizes = poolSizes,
+        .maxSets = slotCount * gEvaluationSetCount + lutDescriptorCount * 2U + blurSetCount + statsSetCount,
+    };
+
+    mDescriptorPool.emplace(mDevice.value(), poolConfig);
+}
+
+void HeadlessRenderer::_createChainContext(const HeadlessRendererConfig& config)
+{
+    SamplerConfig samplerConfig = {};
+    mSampler.emplace(mDevice.value(), samplerConfig);
+
+    // Every image is evaluated from scratch, so there is nothing for a stage cache to reuse
+    ChainContextConfig contextConfig = {
+        .commandPool = mCommandPool.value(),
+        .descriptorPool = mDescriptorPool.value(),
+
+        .registry = config.registry,
+        .stageCache = nullptr,
+        .profiler = nullptr,
+
+        .lutSize = config.lutSize,
+        .workingFormat = config.workingFormat,
+        .chainsInFlight = config.maxImagesInFlight,
+    };
+
+    mChainContext.emplace(mDevice.value(), contextConfig);
+    mFusedOpBuffer.emplace(mChainContext->createFusedOpBuffer());
+
+    auto& pipelineCache = mDevice->getPipelineCache();
+    const auto stats = pipelineCache.getStats();
+
+    std::cout << "Pipeline cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.loadedBytes << " bytes loaded\n";
+
+    pipelineCache.save();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vulkan/include.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <effect/chain.hpp>
+#include <effect/instance.hpp>
+#include <effect/registry.hpp>
+#include <io/image.hpp>
+#include <vulkan/chain_context.hpp>
+#include <vulkan/device.hpp>
+#include <vulkan/instance.hpp>
+#include <vulkan/sampler.hpp>
+#include <vulkan/working_format.hpp>
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/buffer/commandpool.hpp>
+#include <vulkan/descriptor/descriptor_pool.hpp>
+
+struct HeadlessRendererConfig
+{
+    const EffectRegistry& registry;
+
+    const std::vector<const char*>& requiredExtensions;
+
+    bool enableValidationLayers;
+    const std::vector<const char*>& validationLayers;
+    // Must not contain VK_KHR_swapchain, there is nothing to present to
+    const std::vector<const char*>& deviceExtensions;
+
+    // Lattice points per axis of baked color LUTs
+    uint32_t lutSize;
+
+    // Evaluations that may be submitted before the oldest completes, see BatchProcessor
+    uint32_t maxImagesInFlight = 1U;
+
+    WorkingFormat workingFormat = WorkingFormat::Rgba8;
+};
+
+// Tightly packed sRGB RGBA8 pixels
+struct HeadlessImage
+{
+    uint32_t width;
+    uint32_t height;
+
+    std::vector<uint8_t> pixels;
+};
+
+// Encodes linear RGBA8 readback to sRGB in place, leaving alpha untouched
+void encodeLinearToSrgb(std::vector<uint8_t>& pixels);
+// Encodes linear readback of any working format to sRGB RGBA8, clamping float values to [0, 1]
+[[nodiscard]] std::vector<uint8_t> encodeReadbackToSrgb(const uint8_t* texels, size_t pixelCount, vk::Format format);
+
+// Evaluates effect chains without a window, surface or swapchain.
+// Only a compute queue is required, so it also runs on software devices such as lavapipe.
+class HeadlessRenderer
+{
+public:
+    explicit HeadlessRenderer(const HeadlessRendererConfig& config);
+    // Saves the pipeline cache again, with every effect pipeline built meanwhile
+    ~HeadlessRenderer();
+
+    HeadlessRenderer(const HeadlessRenderer&) = delete;
+    HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+
+    // Applies the chain to an sRGB image and reads the result back to host memory
+    [[nodiscard]] HeadlessImage process(const ImageLoadResult& image, const std::vector<EffectInstance>& effects, const EffectChainOptions& options = {});
+
+    [[nodiscard]] const Device& getDevice() const noexcept;
+    [[nodiscard]] const CommandPool& getCommandPool() const noexcept;
+    [[nodiscard]] const Sampler& getSampler() const noexcept;
+    [[nodiscard]] ChainContext& getChainContext() noexcept;
+    [[nodiscard]] WorkingFormat getWorkingFormat() const noexcept;
+
+    // Numbers the chains recorded through the chain context, whose caches recycle results of completed ones
+    [[nodiscard]] uint64_t nextFrame() noexcept;
+private:
+    void _createInstance(const HeadlessRendererConfig& config);
+    void _createDevice(const HeadlessRendererConfig& config);
+    void _createCommandPool();
+    void _createDescriptorPool(const HeadlessRendererConfig& config);
+    void _createChainContext(const HeadlessRendererConfig& config);
+
+    std::optional<Instance> mInstance;
+    std::optional<Device> mDevice;
+
+    std::optional<CommandPool> mCommandPool;
+    std::optional<DescriptorPool> mDescriptorPool;
+
+    std::optional<Sampler> mSampler;
+    std::optional<ChainContext> mChainContext;
+    std::optional<Buffer> mFusedOpBuffer;
+
+    WorkingFormat mWorkingFormat;
+    uint64_t mFrame = 0U;
+};
@@ -0,0 +1,96 @@
+#include "instance.hpp"
+
+#include <iostream>
+
+VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE;
+
+Instance::Instance(const InstanceConfig& config)
+{
+    VULKAN_HPP_DEFAULT_DISPATCHER.init();
+
+    vk::ApplicationInfo appInfo{};
+    appInfo.setPApplicationName("VkImg2D");
+    appInfo.setApplicationVersion(VK_MAKE_VERSION(0, 1, 0));
+    appInfo.setPEngineName("Custom");
+    appInfo.setEngineVersion(VK_MAKE_VERSION(1, 0, 0));
+    appInfo.setApiVersion(VK_API_VERSION_1_4);
+
+    vk::InstanceCreateInfo createInfo{};
+    createInfo.setPApplicationInfo(&appInfo);
+    createInfo.setFlags(vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR);
+    createInfo.setPEnabledExtensionNames(config.requiredExtensions);
+
+    vk::DebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
+    if (config.enableValidationLayers) {
+        createInfo.setPEnabledLayerNames(config.validationLayers);
+
+        _populateDebugMessengerCreateInfo(debugCreateInfo);
+        createInfo.setPNext(&debugCreateInfo);
+    } else {
+        createInfo.setEnabledLayerCount(0);
+    }
+
+    mInstance = vk::createInstanceUnique(createInfo, nullptr);
+
+    VULKAN_HPP_DEFAULT_DISPATCHER.init(mInstance.get());
+
+    if (config.printExtensions) {
+        _printExtensions();
+    }
+
+    if (config.enableValidationLayers) {
+        _setupDebugMessenger();
+    }
+}
+
+vk::Instance Instance::getVkHandle() const noexcept
+{
+    return mInstance.get();
+}
+
+static VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(
+    vk::DebugUtilsMessageSeverityFlagBitsEXT,
+    vk::DebugUtilsMessageTypeFlagsEXT,
+    const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData,
+    void*)
+{
+    std::cerr << "Validation layer: " << pCallbackData->pMessage << "\n";
+
+    return vk::False;
+}
+
+void Instance::_printExtensions()
+{
+    auto exts = vk::enumerateInstanceExtensionProperties();
+
+    std::cout << "Available extensions:\n";
+
+    for (const auto& ext : exts) {
+        std::cout << "\t" << ext.extensionName << "\n";
+    }
+}
+
+void Instance::_setupDebugMessenger()
+{
+    vk::DebugUtilsMessengerCreateInfoEXT createInfo;
+    _populateDebugMessengerCreateInfo(createInfo);
+
+    mDebugMessenger = mInstance->createDebugUtilsMessengerEXTUnique(createInfo);
+}
+
+void Instance::_populateDebugMessengerCreateInfo(vk::DebugUtilsMessengerCreateInfoEXT& createInfo)
+{
+    createInfo.setMessageSeverity(
+        // No info bit
+        vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose
+        | vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning
+        | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError
+    );
+    createInfo.setMessageType(
+        vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral
+        | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation
+        | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance
+    );
+    createInfo.setPfnUserCallback(debugCallback);
+    createInfo.setPUserData(nullptr);
+}
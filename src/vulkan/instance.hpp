@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include <vulkan/include.hpp>
+
+struct InstanceConfig
+{
+    const std::vector<const char*>& requiredExtensions;
+
+    bool enableValidationLayers;
+    const std::vector<const char*>& validationLayers;
+
+    bool printExtensions = true;
+};
+
+// Vulkan instance together with its validation layer messenger
+class Instance
+{
+public:
+    explicit Instance(const InstanceConfig& config);
+
+    [[nodiscard]] vk::Instance getVkHandle() const noexcept;
+private:
+    void _printExtensions();
+
+    void _setupDebugMessenger();
+    void _populateDebugMessengerCreateInfo(vk::DebugUtilsMessengerCreateInfoEXT& createInfo);
+
+    vk::UniqueInstance mInstance;
+    vk::UniqueDebugUtilsMessengerEXT mDebugMessenger;
+};
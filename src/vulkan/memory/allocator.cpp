@@ -0,0 +1,277 @@
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+// Small heaps, such as the host-visible window of a discrete GPU, get proportionally smaller blocks
+static const vk::DeviceSize gHeapBlockDivisor = 8U;
+
+static vk::DeviceSize _alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+{
+    return (value + alignment - 1U) / alignment * alignment;
+}
+
+MemoryAllocation::~MemoryAllocation()
+{
+    _release();
+}
+
+MemoryAllocation::MemoryAllocation(MemoryAllocation&& other) noexcept
+    : mAllocator{ std::exchange(other.mAllocator, nullptr) }
+    , mBlock{ std::exchange(other.mBlock, nullptr) }
+    , mMemory{ std::exchange(other.mMemory, vk::DeviceMemory{}) }
+    , mOffset{ std::exchange(other.mOffset, 0U) }
+    , mSize{ std::exchange(other.mSize, 0U) }
+    , mMappedData{ std::exchange(other.mMappedData, nullptr) }
+{
+}
+
+MemoryAllocation& MemoryAllocation::operator=(MemoryAllocation&& other) noexcept
+{
+    if (this != &other) {
+        _release();
+
+        mAllocator = std::exchange(other.mAllocator, nullptr);
+        mBlock = std::exchange(other.mBlock, nullptr);
+        mMemory = std::exchange(other.mMemory, vk::DeviceMemory{});
+        mOffset = std::exchange(other.mOffset, 0U);
+        mSize = std::exchange(other.mSize, 0U);
+        mMappedData = std::exchange(other.mMappedData, nullptr);
+    }
+
+    return *this;
+}
+
+vk::DeviceMemory MemoryAllocation::getMemory() const noexcept
+{
+    return mMemory;
+}
+
+vk::DeviceSize MemoryAllocation::getOffset() const noexcept
+{
+    return mOffset;
+}
+
+vk::DeviceSize MemoryAllocation::getSize() const noexcept
+{
+    return mSize;
+}
+
+void* MemoryAllocation::getMappedData() const noexcept
+{
+    return mMappedData;
+}
+
+void MemoryAllocation::_release() noexcept
+{
+    if (mAllocator == nullptr) {
+        return;
+    }
+
+    mAllocator->_free(static_cast<MemoryAllocator::Block*>(mBlock), mOffset, mSize);
+
+    mAllocator = nullptr;
+    mBlock = nullptr;
+}
+
+MemoryAllocator::MemoryAllocator(const MemoryAllocatorConfig& config)
+    : mDevice{ config.device }
+    , mMemoryProperties{ config.physicalDevice.getMemoryProperties() }
+    , mNonCoherentAtomSize{ config.physicalDevice.getProperties().limits.nonCoherentAtomSize }
+    , mBlockSize{ config.blockSize }
+{
+    mBuckets.resize(size_t{ mMemoryProperties.memoryTypeCount } * 2U);
+}
+
+MemoryAllocation MemoryAllocator::allocate(const MemoryRequest& request)
+{
+    const auto& requirements = request.requirements;
+
+    const uint32_t memoryType = _findMemoryType(requirements.memoryTypeBits, request.properties);
+    const auto typeFlags = mMemoryProperties.memoryTypes[memoryType].propertyFlags;
+
+    // Flushed and invalidated ranges of non-coherent memory must not share atoms with other allocations
+    vk::DeviceSize alignment = std::max<vk::DeviceSize>(requirements.alignment, 1U);
+    vk::DeviceSize size = requirements.size;
+
+    if ((typeFlags & vk::MemoryPropertyFlagBits::eHostVisible) && !(typeFlags & vk::MemoryPropertyFlagBits::eHostCoherent)) {
+        alignment = std::max(alignment, mNonCoherentAtomSize);
+        size = _alignUp(size, mNonCoherentAtomSize);
+    }
+
+    const auto heapSize = mMemoryProperties.memoryHeaps[mMemoryProperties.memoryTypes[memoryType].heapIndex].size;
+    const vk::DeviceSize blockSize = std::min(mBlockSize, heapSize / gHeapBlockDivisor);
+
+    const size_t bucketIndex = size_t{ memoryType } * 2U + (request.linear ? 1U : 0U);
+
+    std::lock_guard lock{ mMutex };
+
+    auto& bucket = mBuckets[bucketIndex];
+
+    Block* block = nullptr;
+    std::optional<vk::DeviceSize> offset;
+
+    // Resources larger than half a block would waste most of a shared one
+    if (size > blockSize / 2U) {
+        block = &_createBlock(bucketIndex, memoryType, size, true);
+        offset = _takeRange(*block, size, alignment);
+    }
+    else {
+        for (auto& candidate : bucket.blocks) {
+            if (candidate->dedicated) continue;
+
+            offset = _takeRange(*candidate, size, alignment);
+
+            if (offset.has_value()) {
+                block = candidate.get();
+                break;
+            }
+        }
+
+        if (!offset.has_value()) {
+            block = &_createBlock(bucketIndex, memoryType, blockSize, false);
+            offset = _takeRange(*block, size, alignment);
+        }
+    }
+
+    block->usedBytes += size;
+    block->allocationCount++;
+
+    MemoryAllocation allocation{};
+    allocation.mAllocator = this;
+    allocation.mBlock = block;
+    allocation.mMemory = block->memory.get();
+    allocation.mOffset = offset.value();
+    allocation.mSize = size;
+    allocation.mMappedData = block->mappedData != nullptr ? static_cast<uint8_t*>(block->mappedData) + offset.value() : nullptr;
+
+    return allocation;
+}
+
+MemoryStats MemoryAllocator::getStats() const
+{
+    std::lock_guard lock{ mMutex };
+
+    MemoryStats stats{};
+
+    for (const auto& bucket : mBuckets) {
+        for (const auto& block : bucket.blocks) {
+            stats.blockCount++;
+            stats.allocationCount += block->allocationCount;
+            stats.reservedBytes += block->size;
+            stats.usedBytes += block->usedBytes;
+        }
+    }
+
+    return stats;
+}
+
+void MemoryAllocator::_free(Block* block, vk::DeviceSize offset, vk::DeviceSize size) noexcept
+{
+    std::lock_guard lock{ mMutex };
+
+    block->usedBytes -= size;
+    block->allocationCount--;
+
+    auto& ranges = block->freeRanges;
+    auto range = ranges.emplace(offset, size).first;
+
+    auto next = std::next(range);
+    if (next != ranges.end() && range->first + range->second == next->first) {
+        range->second += next->second;
+        ranges.erase(next);
+    }
+
+    if (range != ranges.begin()) {
+        auto prev = std::prev(range);
+
+        if (prev->first + prev->second == range->first) {
+            prev->second += range->second;
+            ranges.erase(range);
+        }
+    }
+
+    if (block->allocationCount > 0U) {
+        return;
+    }
+
+    // Keep one empty shared block per bucket so a freed and recreated resource doesn't hit the driver
+    auto& blocks = mBuckets[block->bucketIndex].blocks;
+
+    const bool keep = !block->dedicated && std::count_if(blocks.begin(), blocks.end(), [](const auto& other) {
+        return !other->dedicated && other->allocationCount == 0U;
+    }) == 1;
+
+    if (keep) {
+        return;
+    }
+
+    blocks.erase(std::find_if(blocks.begin(), blocks.end(), [block](const auto& other) {
+        return other.get() == block;
+    }));
+}
+
+uint32_t MemoryAllocator::_findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const
+{
+    for (uint32_t i = 0; i < mMemoryProperties.memoryTypeCount; i++) {
+        if (typeFilter & (1 << i)
+            && (mMemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type.");
+}
+
+MemoryAllocator::Block& MemoryAllocator::_createBlock(size_t bucketIndex, uint32_t memoryType, vk::DeviceSize size, bool dedicated)
+{
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.setAllocationSize(size);
+    allocInfo.setMemoryTypeIndex(memoryType);
+
+    auto block = std::make_unique<Block>(Block{
+        .memory = mDevice.allocateMemoryUnique(allocInfo),
+        .size = size,
+        .mappedData = nullptr,
+
+        .bucketIndex = bucketIndex,
+        .dedicated = dedicated,
+    });
+
+    block->freeRanges.emplace(0U, size);
+
+    if (mMemoryProperties.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) {
+        block->mappedData = mDevice.mapMemory(block->memory.get(), 0U, vk::WholeSize, vk::MemoryMapFlags());
+    }
+
+    return *mBuckets[bucketIndex].blocks.emplace_back(std::move(block));
+}
+
+std::optional<vk::DeviceSize> MemoryAllocator::_takeRange(Block& block, vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    auto& ranges = block.freeRanges;
+
+    for (auto range = ranges.begin(); range != ranges.end(); range++) {
+        const vk::DeviceSize start = range->first;
+        const vk::DeviceSize end = start + range->second;
+        const vk::DeviceSize offset = _alignUp(start, alignment);
+
+        if (offset + size > end) continue;
+
+        ranges.erase(range);
+
+        // Padding in front of the aligned offset stays free for smaller allocations
+        if (offset > start) {
+            ranges.emplace(start, offset - start);
+        }
+        if (offset + size < end) {
+            ranges.emplace(offset + size, end - offset - size);
+        }
+
+        return offset;
+    }
+
+    return std::nullopt;
+}
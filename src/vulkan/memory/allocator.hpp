@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <vulkan/include.hpp>
+
+class MemoryAllocator;
+
+struct MemoryAllocatorConfig
+{
+    vk::PhysicalDevice physicalDevice;
+    vk::Device device;
+
+    // Size of the shared blocks, capped to a fraction of small heaps
+    vk::DeviceSize blockSize;
+};
+
+struct MemoryRequest
+{
+    vk::MemoryRequirements requirements;
+    vk::MemoryPropertyFlags properties;
+
+    // Buffers and linear images, kept apart from optimal images so bufferImageGranularity never applies
+    bool linear;
+};
+
+struct MemoryStats
+{
+    uint32_t blockCount = 0U;
+    uint32_t allocationCount = 0U;
+
+    vk::DeviceSize reservedBytes = 0U;
+    vk::DeviceSize usedBytes = 0U;
+};
+
+// Range of a pooled block, returned to the allocator when destroyed
+class MemoryAllocation
+{
+public:
+    MemoryAllocation() = default;
+    ~MemoryAllocation();
+
+    MemoryAllocation(MemoryAllocation&& other) noexcept;
+    MemoryAllocation& operator=(MemoryAllocation&& other) noexcept;
+
+    MemoryAllocation(const MemoryAllocation&) = delete;
+    MemoryAllocation& operator=(const MemoryAllocation&) = delete;
+
+    [[nodiscard]] vk::DeviceMemory getMemory() const noexcept;
+    [[nodiscard]] vk::DeviceSize getOffset() const noexcept;
+    [[nodiscard]] vk::DeviceSize getSize() const noexcept;
+
+    // Null unless the memory is host-visible, blocks stay mapped for their whole lifetime
+    [[nodiscard]] void* getMappedData() const noexcept;
+private:
+    friend class MemoryAllocator;
+
+    void _release() noexcept;
+
+    MemoryAllocator* mAllocator = nullptr;
+    void* mBlock = nullptr;
+
+    vk::DeviceMemory mMemory{};
+    vk::DeviceSize mOffset = 0U;
+    vk::DeviceSize mSize = 0U;
+
+    void* mMappedData = nullptr;
+};
+
+// Sub-allocates buffers and images from large blocks, one bucket per memory type and tiling.
+// Freed ranges are coalesced and reused, and a bucket keeps at most one empty block around.
+class MemoryAllocator
+{
+public:
+    explicit MemoryAllocator(const MemoryAllocatorConfig& config);
+
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+    [[nodiscard]] MemoryAllocation allocate(const MemoryRequest& request);
+
+    [[nodiscard]] MemoryStats getStats() const;
+private:
+    struct Block
+    {
+        vk::UniqueDeviceMemory memory;
+        vk::DeviceSize size;
+        void* mappedData;
+
+        size_t bucketIndex;
+        bool dedicated;
+
+        // Offset to size of every free range, adjacent ranges are always merged
+        std::map<vk::DeviceSize, vk::DeviceSize> freeRanges;
+
+        vk::DeviceSize usedBytes = 0U;
+        uint32_t allocationCount = 0U;
+    };
+
+    struct Bucket
+    {
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    friend class MemoryAllocation;
+
+    void _free(Block* block, vk::DeviceSize offset, vk::DeviceSize size) noexcept;
+
+    uint32_t _findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
+    Block& _createBlock(size_t bucketIndex, uint32_t memoryType, vk::DeviceSize size, bool dedicated);
+
+    static std::optional<vk::DeviceSize> _takeRange(Block& block, vk::DeviceSize size, vk::DeviceSize alignment);
+
+    vk::Device mDevice;
+    vk::PhysicalDeviceMemoryProperties mMemoryProperties;
+    vk::DeviceSize mNonCoherentAtomSize;
+    vk::DeviceSize mBlockSize;
+
+    mutable std::mutex mMutex;
+
+    // Indexed by memory type * 2 + linear
+    std::vector<Bucket> mBuckets;
+};
@@ -0,0 +1,137 @@
+#include "host_import.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include <vulkan/device.hpp>
+
+static const auto gHostHandleType = vk::ExternalMemoryHandleTypeFlagBits::eHostAllocationEXT;
+
+HostAllocation::HostAllocation(size_t size, size_t alignment)
+    : mSize{ size }
+    , mCapacity{ (size + alignment - 1U) / alignment * alignment }
+    , mAlignment{ alignment }
+{
+    mData = ::operator new(mCapacity, std::align_val_t{ mAlignment });
+}
+
+HostAllocation::~HostAllocation()
+{
+    _release();
+}
+
+HostAllocation::HostAllocation(HostAllocation&& other) noexcept
+    : mData{ std::exchange(other.mData, nullptr) }
+    , mSize{ std::exchange(other.mSize, 0U) }
+    , mCapacity{ std::exchange(other.mCapacity, 0U) }
+    , mAlignment{ std::exchange(other.mAlignment, 0U) }
+{
+}
+
+HostAllocation& HostAllocation::operator=(HostAllocation&& other) noexcept
+{
+    if (this != &other) {
+        _release();
+
+        mData = std::exchange(other.mData, nullptr);
+        mSize = std::exchange(other.mSize, 0U);
+        mCapacity = std::exchange(other.mCapacity, 0U);
+        mAlignment = std::exchange(other.mAlignment, 0U);
+    }
+
+    return *this;
+}
+
+void* HostAllocation::getData() const noexcept
+{
+    return mData;
+}
+
+size_t HostAllocation::getSize() const noexcept
+{
+    return mSize;
+}
+
+size_t HostAllocation::getCapacity() const noexcept
+{
+    return mCapacity;
+}
+
+void HostAllocation::_release() noexcept
+{
+    if (mData == nullptr) {
+        return;
+    }
+
+    ::operator delete(mData, std::align_val_t{ mAlignment });
+    mData = nullptr;
+}
+
+HostImportBuffer::HostImportBuffer(vk::UniqueDeviceMemory memory, vk::UniqueBuffer buffer)
+    : mMemory{ std::move(memory) }
+    , mBuffer{ std::move(buffer) }
+{
+}
+
+std::optional<HostImportBuffer> HostImportBuffer::tryImport(const Device& device, const HostAllocation& allocation)
+{
+    if (!device.isHostImportSupported()) {
+        return std::nullopt;
+    }
+
+    const vk::DeviceSize alignment = device.getHostImportAlignment();
+    const auto address = reinterpret_cast<uintptr_t>(allocation.getData());
+
+    if (address % alignment != 0U || allocation.getCapacity() % alignment != 0U) {
+        return std::nullopt;
+    }
+
+    auto vkDevice = device.getVkHandle();
+
+    try {
+        const auto hostProps = vkDevice.getMemoryHostPointerPropertiesEXT(gHostHandleType, allocation.getData());
+
+        vk::ExternalMemoryBufferCreateInfo externalInfo{};
+        externalInfo.setHandleTypes(gHostHandleType);
+
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.setSize(allocation.getCapacity());
+        bufferInfo.setUsage(vk::BufferUsageFlagBits::eTransferSrc);
+        bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
+        bufferInfo.setPNext(&externalInfo);
+
+        auto buffer = vkDevice.createBufferUnique(bufferInfo);
+
+        const auto requirements = vkDevice.getBufferMemoryRequirements(buffer.get());
+        const uint32_t typeBits = requirements.memoryTypeBits & hostProps.memoryTypeBits;
+
+        if (typeBits == 0U) {
+            return std::nullopt;
+        }
+
+        // Imported memory can't be pooled, every import is its own allocation
+        vk::ImportMemoryHostPointerInfoEXT importInfo{};
+        importInfo.setHandleType(gHostHandleType);
+        importInfo.setPHostPointer(allocation.getData());
+
+        vk::MemoryAllocateInfo allocInfo{};
+        allocInfo.setAllocationSize(allocation.getCapacity());
+        allocInfo.setMemoryTypeIndex(static_cast<uint32_t>(std::countr_zero(typeBits)));
+        allocInfo.setPNext(&importInfo);
+
+        auto memory = vkDevice.allocateMemoryUnique(allocInfo);
+        vkDevice.bindBufferMemory(buffer.get(), memory.get(), 0U);
+
+        return HostImportBuffer{ std::move(memory), std::move(buffer) };
+    }
+    catch (const vk::SystemError&) {
+        return std::nullopt;
+    }
+}
+
+vk::Buffer HostImportBuffer::getVkHandle() const noexcept
+{
+    return mBuffer.get();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <vulkan/include.hpp>
+
+class Device;
+
+// Host memory aligned and padded to `alignment`, so it can be imported as device memory
+class HostAllocation
+{
+public:
+    HostAllocation(size_t size, size_t alignment);
+    ~HostAllocation();
+
+    HostAllocation(HostAllocation&& other) noexcept;
+    HostAllocation& operator=(HostAllocation&& other) noexcept;
+
+    HostAllocation(const HostAllocation&) = delete;
+    HostAllocation& operator=(const HostAllocation&) = delete;
+
+    [[nodiscard]] void* getData() const noexcept;
+    [[nodiscard]] size_t getSize() const noexcept;
+    // Size rounded up to the alignment, the whole capacity is imported
+    [[nodiscard]] size_t getCapacity() const noexcept;
+private:
+    void _release() noexcept;
+
+    void* mData = nullptr;
+    size_t mSize = 0U;
+    size_t mCapacity = 0U;
+    size_t mAlignment = 0U;
+};
+
+// Transfer source wrapping host memory through VK_EXT_external_memory_host, so uploads
+// copy straight from it instead of going through a staging buffer first.
+// The host memory must outlive every submission that reads the buffer.
+class HostImportBuffer
+{
+public:
+    // Nullopt when the extension is missing or the driver rejects the memory, callers then stage it
+    [[nodiscard]] static std::optional<HostImportBuffer> tryImport(const Device& device, const HostAllocation& allocation);
+
+    [[nodiscard]] vk::Buffer getVkHandle() const noexcept;
+private:
+    HostImportBuffer(vk::UniqueDeviceMemory memory, vk::UniqueBuffer buffer);
+
+    vk::UniqueDeviceMemory mMemory;
+    vk::UniqueBuffer mBuffer;
+};
@@ -1,18 +1,28 @@
 #include "compute_pipeline.hpp"
 
+#include <vector>
+
+#include <trace/trace.hpp>
+
 #include <vulkan/device.hpp>
-#include <vulkan/descriptor/descriptor_layout.hpp>
 #include <vulkan/shader.hpp>
+#include <vulkan/descriptor/descriptor_layout.hpp>
 
 ComputePipeline::ComputePipeline(const Device& device, const ComputePipelineConfig& config)
     : mDevice{ device }
 {
+    TRACE_SCOPE("ComputePipeline");
+
     ShaderConfig shaderConfig{ .type = ShaderType::Compute };
     Shader shader{ mDevice, config.shaderPath, shaderConfig };
 
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-    const auto descriptorLayout = config.descriptorLayout.getVkHandle();
-    pipelineLayoutInfo.setSetLayouts(descriptorLayout);
+    std::vector<vk::DescriptorSetLayout> descriptorLayouts{ config.descriptorLayout.getVkHandle() };
+    if (config.secondaryLayout != nullptr) {
+        descriptorLayouts.push_back(config.secondaryLayout->getVkHandle());
+    }
+
+    pipelineLayoutInfo.setSetLayouts(descriptorLayouts);
 
     if (config.usePushConstants) {
         vk::PushConstantRange pushConstantRange{};
@@ -32,7 +42,14 @@ ComputePipeline::ComputePipeline(const Device& device, const ComputePipelineConf
     pipelineInfo.setStage(shader.getStageInfo());
     pipelineInfo.setLayout(mPipelineLayout.get());
 
-    mPipeline = device.getVkHandle().createComputePipelineUnique(nullptr, pipelineInfo).value;
+    vk::PipelineCreationFeedback feedback{};
+    vk::PipelineCreationFeedbackCreateInfo feedbackInfo{};
+    feedbackInfo.setPPipelineCreationFeedback(&feedback);
+    pipelineInfo.setPNext(&feedbackInfo);
+
+    auto& pipelineCache = mDevice.getPipelineCache();
+    mPipeline = device.getVkHandle().createComputePipelineUnique(pipelineCache.getVkHandle(), pipelineInfo).value;
+    pipelineCache.record(feedback);
 }
 
 const vk::Pipeline ComputePipeline::getVkHandle() const
@@ -12,6 +12,8 @@ struct ComputePipelineConfig
     std::filesystem::path shaderPath;
 
     const DescriptorLayout& descriptorLayout;
+    // Bound as set 1, for resources that don't vary with the ping/pong direction
+    const DescriptorLayout* secondaryLayout = nullptr;
 
     bool usePushConstants;
     uint32_t pushConstantSize;
@@ -132,7 +132,14 @@ GraphicsPipeline::GraphicsPipeline(const Device& device, const GraphicsPipelineC
     pipelineInfo.setBasePipelineHandle(nullptr);
     pipelineInfo.setBasePipelineIndex(-1);
 
-    mPipeline = mDevice.getVkHandle().createGraphicsPipelineUnique(nullptr, pipelineInfo).value;
+    vk::PipelineCreationFeedback feedback{};
+    vk::PipelineCreationFeedbackCreateInfo feedbackInfo{};
+    feedbackInfo.setPPipelineCreationFeedback(&feedback);
+    pipelineInfo.setPNext(&feedbackInfo);
+
+    auto& pipelineCache = mDevice.getPipelineCache();
+    mPipeline = mDevice.getVkHandle().createGraphicsPipelineUnique(pipelineCache.getVkHandle(), pipelineInfo).value;
+    pipelineCache.record(feedback);
 }
 
 const vk::Pipeline GraphicsPipeline::getVkHandle() const
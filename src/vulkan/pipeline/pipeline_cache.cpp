@@ -0,0 +1,130 @@
+#include "pipeline_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <io/binary.hpp>
+
+PipelineCache::PipelineCache(const PipelineCacheConfig& config)
+    : mDevice{ config.device }
+    , mProperties{ config.physicalDevice.getProperties() }
+    , mPath{ config.path }
+{
+    const auto data = _load();
+
+    vk::PipelineCacheCreateInfo createInfo{};
+
+    if (!data.empty()) {
+        createInfo.setInitialDataSize(data.size());
+        createInfo.setPInitialData(data.data());
+        mLoadedBytes = data.size();
+    }
+
+    mCache = mDevice.createPipelineCacheUnique(createInfo);
+}
+
+vk::PipelineCache PipelineCache::getVkHandle() const noexcept
+{
+    return mCache.get();
+}
+
+void PipelineCache::record(const vk::PipelineCreationFeedback& feedback) noexcept
+{
+    if (!(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid)) {
+        return;
+    }
+
+    if (feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+        mHits++;
+    }
+    else {
+        mMisses++;
+    }
+}
+
+void PipelineCache::save() const
+{
+    if (mPath.empty()) {
+        return;
+    }
+
+    auto tempPath = mPath;
+    tempPath += ".tmp";
+
+    try {
+        const auto data = mDevice.getPipelineCacheData(mCache.get());
+
+        if (mPath.has_parent_path()) {
+            std::filesystem::create_directories(mPath.parent_path());
+        }
+
+        {
+            std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+            if (!file) {
+                throw std::runtime_error("Failed to write " + tempPath.string() + ".");
+            }
+        }
+
+        // Replaces the previous file in one step, readers see either the old or the new cache
+        std::filesystem::rename(tempPath, mPath);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to save pipeline cache: " << e.what() << "\n";
+
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+PipelineCacheStats PipelineCache::getStats() const noexcept
+{
+    return PipelineCacheStats{
+        .hits = mHits.load(),
+        .misses = mMisses.load(),
+        .loadedBytes = mLoadedBytes,
+    };
+}
+
+std::vector<char> PipelineCache::_load() const
+{
+    if (mPath.empty() || !std::filesystem::exists(mPath)) {
+        return {};
+    }
+
+    try {
+        auto data = BinaryReader::readFromPath(mPath);
+
+        if (!_validate(data)) {
+            std::cout << "Discarding pipeline cache " << mPath.string() << ", it was written by another device or driver\n";
+            return {};
+        }
+
+        return data;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to load pipeline cache: " << e.what() << "\n";
+        return {};
+    }
+}
+
+bool PipelineCache::_validate(const std::vector<char>& data) const
+{
+    vk::PipelineCacheHeaderVersionOne header{};
+
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header)
+        && header.headerVersion == vk::PipelineCacheHeaderVersion::eOne
+        && header.vendorID == mProperties.vendorID
+        && header.deviceID == mProperties.deviceID
+        && std::ranges::equal(header.pipelineCacheUUID, mProperties.pipelineCacheUUID);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/include.hpp>
+
+struct PipelineCacheConfig
+{
+    vk::PhysicalDevice physicalDevice;
+    vk::Device device;
+
+    // Empty keeps the cache in memory only
+    std::filesystem::path path;
+};
+
+struct PipelineCacheStats
+{
+    // Pipelines whose creation feedback reported a cache hit or miss
+    uint32_t hits = 0U;
+    uint32_t misses = 0U;
+
+    // Size of the data the cache was seeded with, zero when the file was missing or rejected
+    size_t loadedBytes = 0U;
+};
+
+// VkPipelineCache seeded from and saved to a file. Data written by another device,
+// vendor or driver build is rejected through the header's IDs and cache UUID,
+// and saving goes through a temporary file so a crash never leaves a truncated cache.
+class PipelineCache
+{
+public:
+    explicit PipelineCache(const PipelineCacheConfig& config);
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    [[nodiscard]] vk::PipelineCache getVkHandle() const noexcept;
+
+    // Counts a pipeline creation from the feedback chained into its create info
+    void record(const vk::PipelineCreationFeedback& feedback) noexcept;
+
+    // Failures are reported but not thrown, the cache only saves time
+    void save() const;
+
+    [[nodiscard]] PipelineCacheStats getStats() const noexcept;
+private:
+    std::vector<char> _load() const;
+    bool _validate(const std::vector<char>& data) const;
+
+    vk::Device mDevice;
+    vk::PhysicalDeviceProperties mProperties;
+    std::filesystem::path mPath;
+
+    vk::UniquePipelineCache mCache;
+
+    // Pipelines may be created from several threads
+    std::atomic<uint32_t> mHits = 0U;
+    std::atomic<uint32_t> mMisses = 0U;
+    size_t mLoadedBytes = 0U;
+};
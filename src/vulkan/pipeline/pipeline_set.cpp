@@ -0,0 +1,131 @@
+#include "pipeline_set.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include <effect/registry.hpp>
+#include <vulkan/device.hpp>
+
+EffectPipelines::EffectPipelines(const Device& device, const EffectPipelinesConfig& config)
+    : mDevice{ device }
+    , mRegistry{ config.registry }
+    , mDescriptorLayout{ config.descriptorLayout }
+    , mStatsLayout{ config.statsLayout }
+    , mWorkingFormat{ config.workingFormat }
+    , mPool{ config.workerCount }
+{
+}
+
+const ComputePipeline* EffectPipelines::find(const std::string& id)
+{
+    _collect();
+
+    if (auto pipeline = mPipelines.find(id); pipeline != mPipelines.end()) {
+        return &pipeline->second;
+    }
+
+    _queue(id);
+
+    return nullptr;
+}
+
+const ComputePipeline& EffectPipelines::get(const std::string& id)
+{
+    if (const auto* pipeline = find(id)) {
+        return *pipeline;
+    }
+
+    auto build = mBuilds.extract(id);
+    const auto& pipeline = mPipelines.try_emplace(id, build.mapped().get()).first->second;
+
+    mUnsavedCount++;
+    _saveIfDrained();
+
+    return pipeline;
+}
+
+void EffectPipelines::prewarm(const std::vector<std::string>& ids)
+{
+    for (const auto& id : ids) {
+        const auto* effect = mRegistry.getById(id);
+        if (effect == nullptr || !effect->hasOwnPipeline() || mPipelines.contains(id)) continue;
+
+        _queue(id);
+    }
+}
+
+std::unordered_set<std::string> EffectPipelines::getPending()
+{
+    _collect();
+
+    std::unordered_set<std::string> pending;
+
+    for (const auto& [id, build] : mBuilds) {
+        pending.insert(id);
+    }
+
+    return pending;
+}
+
+void EffectPipelines::_queue(const std::string& id)
+{
+    if (mBuilds.contains(id)) {
+        return;
+    }
+
+    const auto* effect = mRegistry.getById(id);
+
+    if (effect == nullptr) {
+        throw std::runtime_error("Unknown effect \"" + id + "\".");
+    }
+
+    if (!effect->hasOwnPipeline()) {
+        throw std::runtime_error("Effect \"" + id + "\" runs through the blur passes, it has no pipeline of its own.");
+    }
+
+    uint32_t pushConstantSize = effect->getParams().size() * sizeof(float);
+
+    ComputePipelineConfig config = {
+        .shaderPath = toShaderVariantPath(effect->getShaderPath(), mWorkingFormat, mDevice.isShaderFloat16Enabled()),
+        .descriptorLayout = mDescriptorLayout,
+        .secondaryLayout = effect->readsImageStats() ? &mStatsLayout : nullptr,
+        .usePushConstants = pushConstantSize > 0U,
+        .pushConstantSize = pushConstantSize,
+    };
+
+    mBuilds.emplace(id, mPool.submit([this, config] { return ComputePipeline{ mDevice, config }; }));
+}
+
+void EffectPipelines::_collect()
+{
+    for (auto build = mBuilds.begin(); build != mBuilds.end();) {
+        if (build->second.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+            build++;
+            continue;
+        }
+
+        auto node = mBuilds.extract(build++);
+
+        // A failed build rethrows here, on the thread that asked for the pipeline
+        mPipelines.try_emplace(node.key(), node.mapped().get());
+        mUnsavedCount++;
+    }
+
+    _saveIfDrained();
+}
+
+void EffectPipelines::_saveIfDrained()
+{
+    if (mUnsavedCount == 0U || !mBuilds.empty()) {
+        return;
+    }
+
+    auto& pipelineCache = mDevice.getPipelineCache();
+    const auto stats = pipelineCache.getStats();
+
+    std::cout << "Pipeline cache: saved after " << mUnsavedCount << " effect pipeline builds, " << stats.hits << " hits, " << stats.misses << " misses in total\n";
+
+    pipelineCache.save();
+    mUnsavedCount = 0U;
+}
@@ -1,10 +1,92 @@
 #pragma once
 
+#include <future>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include <util/thread_pool.hpp>
+#include <vulkan/working_format.hpp>
 #include <vulkan/pipeline/compute_pipeline.hpp>
 
+class Device;
+class EffectRegistry;
+
+struct EffectPipelinesConfig
+{
+    const EffectRegistry& registry;
+    const DescriptorLayout& descriptorLayout;
+    // Bound as set 1 by effects reading image statistics
+    const DescriptorLayout& statsLayout;
+
+    // Selects the variant of every effect shader
+    WorkingFormat workingFormat;
+
+    // Background compile threads
+    uint32_t workerCount;
+};
+
+// Per-effect compute pipelines, built on first use by background workers so startup
+// only pays for the effects that are actually used. Not thread-safe, it belongs to the recording thread.
+class EffectPipelines
+{
+public:
+    EffectPipelines(const Device& device, const EffectPipelinesConfig& config);
+
+    EffectPipelines(const EffectPipelines&) = delete;
+    EffectPipelines& operator=(const EffectPipelines&) = delete;
+
+    // Null while the pipeline builds, the first call queues its build
+    [[nodiscard]] const ComputePipeline* find(const std::string& id);
+    // Waits for the pipeline, queueing its build if needed
+    [[nodiscard]] const ComputePipeline& get(const std::string& id);
+
+    // Queues builds ahead of their first use, unknown ids and blur effects are ignored
+    void prewarm(const std::vector<std::string>& ids);
+
+    // Ids of the effects whose build hasn't finished yet
+    [[nodiscard]] std::unordered_set<std::string> getPending();
+private:
+    void _queue(const std::string& id);
+    void _collect();
+    // Persists pipelines built since the last save once no build is left, so later runs start from them
+    void _saveIfDrained();
+
+    const Device& mDevice;
+    const EffectRegistry& mRegistry;
+    const DescriptorLayout& mDescriptorLayout;
+    const DescriptorLayout& mStatsLayout;
+    WorkingFormat mWorkingFormat;
+
+    std::unordered_map<std::string, ComputePipeline> mPipelines;
+    std::unordered_map<std::string, std::future<ComputePipeline>> mBuilds;
+    uint32_t mUnsavedCount = 0U;
+
+    // Declared last so queued builds finish before the maps are destroyed
+    ThreadPool mPool;
+};
+
 struct PipelineSet
 {
-    std::unordered_map<std::string, ComputePipeline> effectPipelines;
+    EffectPipelines& effectPipelines;
+
+    // Runs a list of per-pixel ops in a single dispatch
+    ComputePipeline fusedPipeline;
+
+    // Bakes a run of color ops into a 3D LUT, and samples it per pixel
+    ComputePipeline lutBakePipeline;
+    ComputePipeline lutApplyPipeline;
+
+    // Separable gaussian passes shared by the blur effects, with a box-filtered pyramid for large radii
+    ComputePipeline blurPassPipeline;
+    ComputePipeline blurApplyPipeline;
+    ComputePipeline blurDownPipeline;
+    ComputePipeline blurUpsamplePipeline;
+
+    // Histograms, min, max and mean of an image into a statistics buffer
+    ComputePipeline statsReducePipeline;
+
+    // Fills the mip chain of a displayed result in a single dispatch
+    ComputePipeline mipDownsamplePipeline;
 };
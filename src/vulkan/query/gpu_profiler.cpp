@@ -0,0 +1,170 @@
+#include "gpu_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include <vulkan/device.hpp>
+
+GpuProfiler::GpuProfiler(const Device& device, const GpuProfilerConfig& config)
+    : mDevice{ device }
+    , mMaxScopes{ config.maxScopes }
+    , mHistorySize{ config.historySize }
+    , mFrameScopes(config.framesInFlight)
+{
+    const auto physicalDevice = device.getPhysicalDevice();
+    const auto families = physicalDevice.getQueueFamilyProperties();
+
+    uint32_t validBits = 64U;
+    for (auto index : config.queueFamilyIndices) {
+        validBits = std::min(validBits, families.at(index).timestampValidBits);
+    }
+
+    // A queue without timestamp support leaves every scope unmeasured
+    if (validBits == 0U) {
+        return;
+    }
+
+    mPeriodNs = physicalDevice.getProperties().limits.timestampPeriod;
+    mValidMask = validBits >= 64U ? ~uint64_t{ 0U } : (uint64_t{ 1U } << validBits) - 1U;
+
+    vk::QueryPoolCreateInfo poolInfo{};
+    poolInfo.setQueryType(vk::QueryType::eTimestamp);
+    poolInfo.setQueryCount(config.framesInFlight * config.maxScopes * 2U);
+
+    mQueryPool = device.getVkHandle().createQueryPoolUnique(poolInfo);
+}
+
+void GpuProfiler::beginFrame(vk::CommandBuffer buffer, uint32_t frame)
+{
+    if (!isSupported()) return;
+
+    // The caller waited for the last frame in this slot, so its queries are either written or never will be
+    _collect(frame);
+
+    mCurrentFrame = frame;
+    buffer.resetQueryPool(mQueryPool.get(), frame * mMaxScopes * 2U, mMaxScopes * 2U);
+
+    mFrameScope = begin(buffer, "Frame");
+}
+
+void GpuProfiler::endFrame(vk::CommandBuffer buffer)
+{
+    end(buffer, mFrameScope);
+    mFrameScope.reset();
+}
+
+std::optional<uint32_t> GpuProfiler::begin(vk::CommandBuffer buffer, std::string name)
+{
+    auto& scopes = mFrameScopes.at(mCurrentFrame);
+
+    if (!isSupported() || scopes.size() >= mMaxScopes) {
+        return std::nullopt;
+    }
+
+    const auto scope = static_cast<uint32_t>(scopes.size());
+    scopes.push_back(std::move(name));
+
+    // Both timestamps wait for all earlier work, so a scope doesn't absorb the tail of the previous pass
+    buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, mQueryPool.get(), (mCurrentFrame * mMaxScopes + scope) * 2U);
+
+    return scope;
+}
+
+void GpuProfiler::end(vk::CommandBuffer buffer, std::optional<uint32_t> scope)
+{
+    if (!scope.has_value()) return;
+
+    buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, mQueryPool.get(), (mCurrentFrame * mMaxScopes + scope.value()) * 2U + 1U);
+}
+
+std::vector<GpuTimingStats> GpuProfiler::getStats() const
+{
+    std::vector<GpuTimingStats> stats;
+    stats.reserve(mTimings.size());
+
+    for (const auto& timing : mTimings) {
+        std::vector<double> sorted(timing.samples.begin(), timing.samples.end());
+        std::ranges::sort(sorted);
+
+        // Nearest-rank percentile
+        auto percentile = [&sorted](double p) {
+            const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+            return sorted.at(std::max<size_t>(rank, 1U) - 1U);
+        };
+
+        stats.push_back(GpuTimingStats{
+            .name = timing.name,
+            .lastMs = timing.samples.back(),
+            .averageMs = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size()),
+            .p50Ms = percentile(0.50),
+            .p95Ms = percentile(0.95),
+            .p99Ms = percentile(0.99),
+        });
+    }
+
+    return stats;
+}
+
+bool GpuProfiler::isSupported() const noexcept
+{
+    return static_cast<bool>(mQueryPool);
+}
+
+void GpuProfiler::_collect(uint32_t frame)
+{
+    auto& scopes = mFrameScopes.at(frame);
+
+    if (scopes.empty()) {
+        return;
+    }
+
+    const auto queryCount = static_cast<uint32_t>(scopes.size()) * 2U;
+
+    // Each query is followed by its availability, zero for queries the frame didn't reach
+    auto results = mDevice.getVkHandle().getQueryPoolResults<uint64_t>(
+        mQueryPool.get(),
+        frame * mMaxScopes * 2U,
+        queryCount,
+        queryCount * 2U * sizeof(uint64_t),
+        2U * sizeof(uint64_t),
+        vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability
+    );
+
+    const auto& values = results.value;
+
+    for (size_t i = 0; i < scopes.size(); i++) {
+        const auto beginValue = values.at(i * 4U);
+        const auto endValue = values.at(i * 4U + 2U);
+
+        if (values.at(i * 4U + 1U) == 0U || values.at(i * 4U + 3U) == 0U) continue;
+
+        const auto ticks = (endValue - beginValue) & mValidMask;
+        _addSample(scopes.at(i), static_cast<double>(ticks) * mPeriodNs / 1.0e6);
+    }
+
+    scopes.clear();
+    mCollectedFrames++;
+
+    // Scopes that stopped being recorded, like removed effects, drop out once their history would have
+    std::erase_if(mTimings, [this](const Timing& timing) {
+        return timing.lastFrame + mHistorySize < mCollectedFrames;
+    });
+}
+
+void GpuProfiler::_addSample(const std::string& name, double milliseconds)
+{
+    auto timing = std::ranges::find(mTimings, name, &Timing::name);
+
+    if (timing == mTimings.end()) {
+        timing = mTimings.insert(mTimings.end(), Timing{ .name = name, .samples = {}, .lastFrame = 0U });
+    }
+
+    timing->samples.push_back(milliseconds);
+    timing->lastFrame = mCollectedFrames;
+
+    if (timing->samples.size() > mHistorySize) {
+        timing->samples.pop_front();
+    }
+}
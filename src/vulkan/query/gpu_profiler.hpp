@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <vulkan/include.hpp>
+
+class Device;
+
+struct GpuProfilerConfig
+{
+    // Families of the queues the profiled command buffers are submitted to
+    std::vector<uint32_t> queueFamilyIndices;
+
+    uint32_t framesInFlight;
+
+    // Scopes a frame can time, later ones are not measured
+    uint32_t maxScopes;
+    // Samples per scope the averages and percentiles are computed over
+    uint32_t historySize;
+};
+
+struct GpuTimingStats
+{
+    std::string name;
+
+    double lastMs;
+    double averageMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+};
+
+// Timestamp queries around the passes of each frame. Every frame in flight owns a range of the
+// query pool, read back without waiting once the frame's fence has been waited and its
+// command buffer is recorded again, so results lag `framesInFlight` frames behind.
+class GpuProfiler
+{
+public:
+    GpuProfiler(const Device& device, const GpuProfilerConfig& config);
+
+    // Collects the previous results of `frame` and resets its queries, recorded before any scope
+    void beginFrame(vk::CommandBuffer buffer, uint32_t frame);
+    void endFrame(vk::CommandBuffer buffer);
+
+    // Returns the scope to end, nullopt when timestamps are unsupported or the frame is out of queries
+    [[nodiscard]] std::optional<uint32_t> begin(vk::CommandBuffer buffer, std::string name);
+    void end(vk::CommandBuffer buffer, std::optional<uint32_t> scope);
+
+    // Scopes measured within the last `historySize` frames, in the order they were first seen
+    [[nodiscard]] std::vector<GpuTimingStats> getStats() const;
+
+    [[nodiscard]] bool isSupported() const noexcept;
+private:
+    struct Timing
+    {
+        std::string name;
+        std::deque<double> samples;
+        uint64_t lastFrame;
+    };
+
+    void _collect(uint32_t frame);
+    void _addSample(const std::string& name, double milliseconds);
+
+    const Device& mDevice;
+
+    vk::UniqueQueryPool mQueryPool;
+
+    uint32_t mMaxScopes;
+    uint32_t mHistorySize;
+
+    double mPeriodNs = 0.0;
+    uint64_t mValidMask = 0U;
+
+    // Scope names recorded into each frame's range, scope `i` owns queries `2i` and `2i + 1`
+    std::vector<std::vector<std::string>> mFrameScopes;
+    uint32_t mCurrentFrame = 0U;
+    std::optional<uint32_t> mFrameScope;
+
+    uint64_t mCollectedFrames = 0U;
+    std::vector<Timing> mTimings;
+};
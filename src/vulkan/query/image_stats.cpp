@@ -0,0 +1,34 @@
+#include "image_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+
+// Steps per unit of the fixed point sums, STATS_SUM_SCALE in shaders/include/stats.glsl
+static const double gSumScale = 4096.0;
+
+static float _orderedToFloat(uint32_t ordered)
+{
+    return std::bit_cast<float>((ordered & 0x80000000U) != 0U ? ordered & 0x7FFFFFFFU : ~ordered);
+}
+
+ImageStats decodeImageStats(const GpuImageStats& stats)
+{
+    ImageStats result{};
+    result.pixelCount = stats.pixelCount;
+
+    const double pixelCount = std::max(static_cast<double>(stats.pixelCount), 1.0);
+
+    for (size_t channel = 0; channel < ImageStatsLayout::ChannelCount; channel++) {
+        for (size_t bin = 0; bin < ImageStatsLayout::BinCount; bin++) {
+            result.histogram[channel][bin] = static_cast<float>(stats.histogram[channel * ImageStatsLayout::BinCount + bin] / pixelCount);
+        }
+
+        const double sum = (static_cast<double>(stats.sumHigh[channel]) * 4294967296.0 + stats.sumLow[channel]) / gSumScale;
+
+        result.min[channel] = _orderedToFloat(stats.minBits[channel]);
+        result.max[channel] = _orderedToFloat(stats.maxBits[channel]);
+        result.mean[channel] = static_cast<float>(sum / pixelCount);
+    }
+
+    return result;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <vulkan/buffer/buffer.hpp>
+#include <vulkan/descriptor/descriptor_set.hpp>
+
+// Must match the STATS_ defines in shaders/include/stats.glsl
+namespace ImageStatsLayout
+{
+    // Red, green, blue and luminance
+    inline constexpr size_t ChannelCount = 4U;
+    inline constexpr size_t Luminance = 3U;
+
+    // Bins cover [0, 1], values outside land in the first or the last one
+    inline constexpr size_t BinCount = 256U;
+}
+
+// std430 layout of ImageStatsBuffer in shaders/include/stats.glsl
+struct GpuImageStats
+{
+    std::array<uint32_t, ImageStatsLayout::ChannelCount * ImageStatsLayout::BinCount> histogram;
+
+    // Floats remapped so that their unsigned order matches, see orderedToFloat
+    std::array<uint32_t, ImageStatsLayout::ChannelCount> minBits;
+    std::array<uint32_t, ImageStatsLayout::ChannelCount> maxBits;
+
+    // Fixed point sums split into 32-bit words, see STATS_SUM_SCALE
+    std::array<uint32_t, ImageStatsLayout::ChannelCount> sumLow;
+    std::array<uint32_t, ImageStatsLayout::ChannelCount> sumHigh;
+
+    uint32_t pixelCount;
+};
+
+static_assert(sizeof(GpuImageStats) == (ImageStatsLayout::ChannelCount * ImageStatsLayout::BinCount + ImageStatsLayout::ChannelCount * 4U + 1U) * sizeof(uint32_t));
+
+// Statistics of one image, with every histogram normalized by the pixel count
+struct ImageStats
+{
+    std::array<std::array<float, ImageStatsLayout::BinCount>, ImageStatsLayout::ChannelCount> histogram;
+
+    std::array<float, ImageStatsLayout::ChannelCount> min;
+    std::array<float, ImageStatsLayout::ChannelCount> max;
+    std::array<float, ImageStatsLayout::ChannelCount> mean;
+
+    uint32_t pixelCount;
+};
+
+// Buffer a statistics reduction accumulates into, with the set binding it
+struct ImageStatsTarget
+{
+    Buffer buffer;
+    DescriptorSet descriptorSet;
+};
+
+[[nodiscard]] ImageStats decodeImageStats(const GpuImageStats& stats);
@@ -1,69 +1,87 @@
 #include "renderer.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <set>
 #include <utility>
 #include <stdexcept>
 
 #include <io/binary.hpp>
+#include <io/image.hpp>
 #include <io/path.hpp>
+#include <trace/trace.hpp>
+#include <vulkan/headless_renderer.hpp>
 
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
-VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE;
+// Effects of earlier sessions whose pipelines are built in the background at startup
+static const size_t gRecentEffectCount = 16U;
+
+// Timestamp scopes per frame, and frames the profiler's statistics cover
+static const uint32_t gProfilerScopeCount = 64U;
+static const uint32_t gProfilerHistorySize = 240U;
 
 VkRenderer::VkRenderer(VkRendererConfig config)
     : mAppData{ config.appData }
     , mWindow{ config.window }
 {
-    VULKAN_HPP_DEFAULT_DISPATCHER.init();
-
     _createInstance(config);
-    _printExtensions();
-
-    if (config.enableValidationLayers) {
-        _setupDebugMessenger();
-    }
-
     _createSurface(config.window);
-
-    mDevice.emplace(config, *this);
+    _createDevice(config);
 
     _createRenderpass();
     _createFramebuffers();
-    _createCommandPool();
+    _createCommandPool(config);
+    _createProfiler(config);
     _createBuffers(config);
     _createTextures(config);
+    _createReadbackRing();
     _createDescriptorLayouts(config);
+    _createDescriptorPool(config);
+    _createChainContext(config);
     _createDescriptorSets(config);
     _createPipelines();
     _setupImGui(config);
-    _createCommandBuffers(config);
     _createSyncObjects(config);
-}
-
-const vk::UniqueInstance& VkRenderer::getInstance() const noexcept
-{
-    return mInstance;
-}
-
-vk::SurfaceKHR VkRenderer::getSurface() const noexcept
-{
-    return mSurface->getVkHandle();
+    _createCommandBuffers(config);
 }
 
 void VkRenderer::draw()
 {
+    TRACE_SCOPE("VkRenderer::draw");
+
+    mAppData.memoryStats = mDevice->getAllocator().getStats();
+    mAppData.pendingEffects = mChainContext->getEffectPipelines().getPending();
+    mAppData.gpuTimings = mGpuProfiler->getStats();
     mImGuiRenderer->draw();
 
+    if (mAppData.pendingLutExport.has_value()) {
+        _exportLut(mAppData.pendingLutExport.value());
+        mAppData.pendingLutExport.reset();
+    }
+
+    _pollImageExports();
+    mUploader->collect();
+
     const auto& swapchain = mDevice->getSwapchain();
 
-    const auto& inFlightFence = mInFlightFences->getFence(mCurrentFrame);
-    const auto& imageAvailableSemaphore = mImageAvailableSemaphores->getVkHandle(mCurrentFrame);
+    {
+        TRACE_SCOPE("Frame wait");
+        mFrameScheduler->beginFrame();
+    }
+
+    const auto frameIndex = mFrameScheduler->getFrameIndex();
 
-    inFlightFence.wait();
-    inFlightFence.reset();
+    // The frame's previous submission has completed, so its statistics are readable
+    if (auto stats = mCommandBuffers->takeStats(frameIndex)) {
+        mAppData.imageStats = std::move(stats);
+    }
+
+    const auto& imageAvailableSemaphore = mImageAvailableSemaphores->getVkHandle(frameIndex);
 
     auto nextImageKHR = mDevice->acquireNextImageKHR(imageAvailableSemaphore);
 
@@ -79,26 +97,81 @@ void VkRenderer::draw()
 
     const auto& renderedPerImageSemaphore = mRenderedPerImageSemaphores->getVkHandle(imageIndex);
 
-    inFlightFence.reset();
+    mCommandBuffers->reset(frameIndex);
 
-    mCommandBuffers->reset(mCurrentFrame);
-    mCommandBuffers->record(mCurrentFrame, imageIndex);
+    bool readback = mAppData.pendingImageExport.has_value();
+    auto ticket = mCommandBuffers->record(frameIndex, imageIndex, readback);
+
+    // A full ring keeps the export pending until earlier ones have been encoded
+    if (ticket.has_value()) {
+        mImageExports.push_back(ImageExport{ .ticket = ticket.value(), .path = mAppData.pendingImageExport.value() });
+        mAppData.pendingImageExport.reset();
+    }
 
-    vk::SubmitInfo submitInfo{};
-    vk::PipelineStageFlags waitMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    submitInfo.setWaitSemaphores(imageAvailableSemaphore);
-    submitInfo.setWaitDstStageMask({ waitMask });
+    vk::SemaphoreSubmitInfo imageAvailableInfo{};
+    imageAvailableInfo.setSemaphore(imageAvailableSemaphore);
+    imageAvailableInfo.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
 
-    const auto commandBuffer = mCommandBuffers->getVkHandle(mCurrentFrame);
-    submitInfo.setCommandBuffers(commandBuffer);
+    std::vector<vk::SemaphoreSubmitInfo> waitInfos{ imageAvailableInfo };
+
+    auto uploadWait = mUploader->takeWait();
+
+    if (uploadWait.has_value()) {
+        waitInfos.push_back(uploadWait.value());
+    }
 
-    vk::Semaphore signalSemaphores[] = { renderedPerImageSemaphore };
-    submitInfo.setSignalSemaphores(signalSemaphores);
+    // The chain goes out first, the previous frame may still be rendering or presenting meanwhile
+    if (auto chainBuffer = mCommandBuffers->getChainVkHandle(frameIndex)) {
+        vk::CommandBufferSubmitInfo chainBufferInfo{};
+        chainBufferInfo.setCommandBuffer(chainBuffer.value());
 
-    mDevice->getGraphicsQueue().submit(submitInfo, inFlightFence.getVkHandle());
+        const auto chainFinishedInfo = mFrameScheduler->createComputeSignal();
+
+        std::vector<vk::SemaphoreSubmitInfo> chainWaitInfos;
+
+        if (uploadWait.has_value()) {
+            chainWaitInfos.push_back(uploadWait.value());
+        }
+
+        vk::SubmitInfo2 chainSubmitInfo{};
+        chainSubmitInfo.setWaitSemaphoreInfos(chainWaitInfos);
+        chainSubmitInfo.setCommandBufferInfos(chainBufferInfo);
+        chainSubmitInfo.setSignalSemaphoreInfos(chainFinishedInfo);
+
+        {
+            TRACE_SCOPE("Submit chain");
+            mDevice->getAsyncComputeQueue().submit2(chainSubmitInfo);
+        }
+
+        // Graphics work starts with acquiring the images the chain released
+        waitInfos.push_back(mFrameScheduler->createComputeWait(vk::PipelineStageFlagBits2::eAllCommands));
+    }
+
+    vk::CommandBufferSubmitInfo commandBufferInfo{};
+    commandBufferInfo.setCommandBuffer(mCommandBuffers->getVkHandle(frameIndex));
+
+    vk::SemaphoreSubmitInfo renderedInfo{};
+    renderedInfo.setSemaphore(renderedPerImageSemaphore);
+    renderedInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    std::vector<vk::SemaphoreSubmitInfo> signalInfos{ renderedInfo, mFrameScheduler->takeFrameSignal() };
+
+    if (mReadbackRing->hasUnsubmitted()) {
+        signalInfos.push_back(mReadbackRing->takeSignal());
+    }
+
+    vk::SubmitInfo2 submitInfo{};
+    submitInfo.setWaitSemaphoreInfos(waitInfos);
+    submitInfo.setCommandBufferInfos(commandBufferInfo);
+    submitInfo.setSignalSemaphoreInfos(signalInfos);
+
+    {
+        TRACE_SCOPE("Submit");
+        mDevice->getGraphicsQueue().submit2(submitInfo);
+    }
 
     vk::PresentInfoKHR presentInfo{};
-    presentInfo.setWaitSemaphores(signalSemaphores);
+    presentInfo.setWaitSemaphores(renderedPerImageSemaphore);
 
     const auto swapchainHandle = swapchain.getVkHandle();
     presentInfo.setSwapchains(swapchainHandle);
@@ -106,7 +179,12 @@ void VkRenderer::draw()
 
     presentInfo.setPResults(nullptr);
 
-    auto result = mDevice->getPresentQueue().presentKHR(presentInfo);
+    vk::Result result;
+
+    {
+        TRACE_SCOPE("Present");
+        result = mDevice->getPresentQueue().presentKHR(presentInfo);
+    }
 
     if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || mWindow.mFramebufferResized) {
         mWindow.mFramebufferResized = false;
@@ -115,94 +193,55 @@ void VkRenderer::draw()
     else if (result != vk::Result::eSuccess) {
         throw std::runtime_error("Failed to present swapchain image.");
     }
-
-    mCurrentFrame = (mCurrentFrame + 1) % mFramesInFlight;
 }
 
 void VkRenderer::cleanup()
 {
     mDevice.value().getVkHandle().waitIdle();
-}
 
-void VkRenderer::_createInstance(const VkRendererConfig& config)
-{
-    vk::ApplicationInfo appInfo{};
-    appInfo.setPApplicationName("VkImg2D");
-    appInfo.setApplicationVersion(VK_MAKE_VERSION(0, 1, 0));
-    appInfo.setPEngineName("Custom");
-    appInfo.setEngineVersion(VK_MAKE_VERSION(1, 0, 0));
-    appInfo.setApiVersion(VK_API_VERSION_1_4);
-
-    vk::InstanceCreateInfo createInfo{};
-    createInfo.setPApplicationInfo(&appInfo);
-    createInfo.setFlags(vk::InstanceCreateFlagBits::eEnumeratePortabilityKHR);
-    createInfo.setPEnabledExtensionNames(config.requiredExtensions);
-
-    vk::DebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
-    if (config.enableValidationLayers) {
-        createInfo.setPEnabledLayerNames(config.validationLayers);
-
-        _populateDebugMessengerCreateInfo(debugCreateInfo);
-        createInfo.setPNext(&debugCreateInfo);
-    } else {
-        createInfo.setEnabledLayerCount(0);
-    }
+    _pollImageExports();
 
-    mInstance = vk::createInstanceUnique(createInfo, nullptr);
+    for (auto& encode : mImageEncodes) {
+        encode.wait();
+    }
 
-    VULKAN_HPP_DEFAULT_DISPATCHER.init(mInstance.get());
+    _saveRecentEffects();
+    mDevice->getPipelineCache().save();
 }
 
-VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(
-    vk::DebugUtilsMessageSeverityFlagBitsEXT,
-    vk::DebugUtilsMessageTypeFlagsEXT,
-    const vk::DebugUtilsMessengerCallbackDataEXT* pCallbackData,
-    void*)
+void VkRenderer::_createInstance(const VkRendererConfig& config)
 {
-    std::cerr << "Validation layer: " << pCallbackData->pMessage << "\n";
+    InstanceConfig instanceConfig = {
+        .requiredExtensions = config.requiredExtensions,
+
+        .enableValidationLayers = config.enableValidationLayers,
+        .validationLayers = config.validationLayers,
+    };
 
-    return vk::False;
+    mInstance.emplace(instanceConfig);
 }
 
-void VkRenderer::_printExtensions()
+void VkRenderer::_createSurface(const Window& window)
 {
-    auto exts = vk::enumerateInstanceExtensionProperties();
-
-    std::cout << "Available extensions:\n";
-
-    for (const auto& ext : exts) {
-        std::cout << "\t" << ext.extensionName << "\n";
-    }
+    mSurface.emplace(mInstance->getVkHandle(), window);
 }
 
-void VkRenderer::_setupDebugMessenger()
+void VkRenderer::_createDevice(const VkRendererConfig& config)
 {
-    vk::DebugUtilsMessengerCreateInfoEXT createInfo;
-    _populateDebugMessengerCreateInfo(createInfo);
+    DeviceConfig deviceConfig = {
+        .instance = mInstance->getVkHandle(),
 
-    mDebugMessenger = mInstance->createDebugUtilsMessengerEXTUnique(createInfo);
-}
+        .surface = mSurface->getVkHandle(),
+        .window = &config.window,
 
-void VkRenderer::_populateDebugMessengerCreateInfo(vk::DebugUtilsMessengerCreateInfoEXT& createInfo)
-{
-    createInfo.setMessageSeverity(
-        // No info bit
-        vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose
-        | vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning
-        | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError
-    );
-    createInfo.setMessageType(
-        vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral
-        | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation
-        | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance
-    );
-    createInfo.setPfnUserCallback(debugCallback);
-    createInfo.setPUserData(nullptr);
-}
+        .enableValidationLayers = config.enableValidationLayers,
+        .validationLayers = config.validationLayers,
+        .deviceExtensions = config.deviceExtensions,
 
-void VkRenderer::_createSurface(const Window& window)
-{
-    mSurface.emplace(mInstance.get(), window);
+        .pipelineCachePath = Paths::PipelineCache,
+    };
+
+    mDevice.emplace(deviceConfig);
 }
 
 void VkRenderer::_createRenderpass()
@@ -232,19 +271,47 @@ void VkRenderer::_createFramebuffers()
     }
 }
 
-void VkRenderer::_createCommandPool()
+void VkRenderer::_createCommandPool(const VkRendererConfig& config)
 {
-    CommandPoolConfig config = {
+    CommandPoolConfig poolConfig = {
         .queueFamilyIndex = mDevice->getQueueFamilies().graphicsAndComputeFamily.value(),
     };
 
-    mCommandPool.emplace(mDevice.value(), config);
+    mCommandPool.emplace(mDevice.value(), poolConfig);
+
+    if (config.useAsyncCompute && mDevice->hasAsyncCompute()) {
+        CommandPoolConfig computePoolConfig = {
+            .queueFamilyIndex = mDevice->getQueueFamilies().asyncComputeFamily.value(),
+        };
+
+        mComputeCommandPool.emplace(mDevice.value(), computePoolConfig);
+        std::cout << "Effect chains run on async compute queue family " << computePoolConfig.queueFamilyIndex << "\n";
+    }
+
+    UploaderConfig uploaderConfig = {
+        .dstQueueFamilyIndex = poolConfig.queueFamilyIndex,
+        .stagingSize = config.stagingSize,
+    };
+
+    mUploader.emplace(mDevice.value(), uploaderConfig);
+}
+
+void VkRenderer::_createProfiler(const VkRendererConfig& config)
+{
+    GpuProfilerConfig profilerConfig = {
+        .queueFamilyIndices = { mCommandPool->getQueueFamilyIndex(), _getChainCommandPool().getQueueFamilyIndex() },
+        .framesInFlight = config.framesInFlight,
+        .maxScopes = gProfilerScopeCount,
+        .historySize = gProfilerHistorySize,
+    };
+
+    mGpuProfiler.emplace(mDevice.value(), profilerConfig);
 }
 
 void VkRenderer::_createBuffers(const VkRendererConfig& config)
 {
-    mVertexBuffer.emplace(Buffer::createVertex(mDevice.value(), mCommandPool.value(), config.vertices));
-    mIndexBuffer.emplace(Buffer::createIndex(mDevice.value(), mCommandPool.value(), config.indices));
+    mVertexBuffer.emplace(Buffer::createVertex(mDevice.value(), mCommandPool.value(), mUploader.value(), config.vertices));
+    mIndexBuffer.emplace(Buffer::createIndex(mDevice.value(), mCommandPool.value(), mUploader.value(), config.indices));
 }
 
 void VkRenderer::_createTextures(const VkRendererConfig& config)
@@ -252,22 +319,44 @@ void VkRenderer::_createTextures(const VkRendererConfig& config)
     auto image = Image{ Paths::Samples / "sculpture_statue.jpg" };
     auto loadedImage = image.load();
 
+    // Sampled by the chain and by the fragment pass, which may run on different queues at once
+    const auto& families = mDevice->getQueueFamilies();
+    std::set<uint32_t> textureFamilies{ mCommandPool->getQueueFamilyIndex(), _getChainCommandPool().getQueueFamilyIndex() };
+
+    if (mComputeCommandPool.has_value()) {
+        textureFamilies.insert(families.transferFamily.value());
+    }
+
     TextureImageConfig imageConfig = {
         .commandPool = mCommandPool.value(),
+        .uploader = mUploader.value(),
         .image = loadedImage,
 
         .type = TextureImageType::Sampled,
+
+        .sharedQueueFamilies = { textureFamilies.begin(), textureFamilies.end() },
     };
 
     mTexture.emplace(mDevice.value(), imageConfig);
 
-    SamplerConfig samplerConfig = {};
+    // Vertex, index and texture data go out in one submission that the first frame waits on
+    mUploader->flush();
+
+    // Zoomed out, the result is sampled from its mip chain instead of aliasing
+    SamplerConfig samplerConfig = {
+        .maxLod = vk::LodClampNone,
+    };
     mSampler.emplace(mDevice.value(), samplerConfig);
 
+    const auto width = static_cast<uint32_t>(loadedImage.texWidth);
+    const auto height = static_cast<uint32_t>(loadedImage.texHeight);
+
     ComputeImageConfig pingPongConfig = {
-        .commandPool = mCommandPool.value(),
-        .width = static_cast<uint32_t>(loadedImage.texWidth),
-        .height = static_cast<uint32_t>(loadedImage.texHeight),
+        .commandPool = _getChainCommandPool(),
+        .width = width,
+        .height = height,
+        .format = config.workingFormat,
+        .mipLevels = std::min(TextureImage::getFullMipLevels(width, height), ChainContext::getMaxMipLevels()),
     };
 
     mImages.clear();
@@ -280,6 +369,27 @@ void VkRenderer::_createTextures(const VkRendererConfig& config)
             TextureImage{ mDevice.value(), pingPongConfig }
         );
     }
+
+    StageCacheConfig stageCacheConfig = {
+        .commandPool = _getChainCommandPool(),
+        .width = pingPongConfig.width,
+        .height = pingPongConfig.height,
+        .format = config.workingFormat,
+        .budget = config.stageCacheBudget,
+    };
+
+    mStageCache.emplace(mDevice.value(), stageCacheConfig);
+}
+
+void VkRenderer::_createReadbackRing()
+{
+    // Room for a couple of exports of the working image in flight
+    ReadbackRingConfig config = {
+        .commandPool = mCommandPool.value(),
+        .size = vk::DeviceSize{ mTexture->getWidth() } * mTexture->getHeight() * mImages.front().ping.getPixelSize() * 2U,
+    };
+
+    mReadbackRing.emplace(mDevice.value(), config);
 }
 
 void VkRenderer::_createDescriptorLayouts(const VkRendererConfig& config)
@@ -301,144 +411,90 @@ void VkRenderer::_createDescriptorLayouts(const VkRendererConfig& config)
     };
 
     mFragmentDescriptorLayout.emplace(mDevice.value(), fragmentLayoutConfig);
-
-    std::vector<DescriptorLayoutBindingConfig> samplerBindings{
-        DescriptorLayoutBindingConfig{
-            .binding = 0U,
-            .type = vk::DescriptorType::eCombinedImageSampler,
-        },
-        DescriptorLayoutBindingConfig{
-            .binding = 1U,
-            .type = vk::DescriptorType::eStorageImage,
-        },
-    };
-
-    DescriptorLayoutConfig samplerLayoutConfig = {
-        .bindings = samplerBindings,
-        .stages = vk::ShaderStageFlagBits::eCompute,
-    };
-
-    mSamplerDescriptorLayout.emplace(mDevice.value(), samplerLayoutConfig);
-
-    std::vector<DescriptorLayoutBindingConfig> effectBindings{
-        DescriptorLayoutBindingConfig{
-            .binding = 0U,
-            .type = vk::DescriptorType::eStorageImage,
-        },
-        DescriptorLayoutBindingConfig{
-            .binding = 1U,
-            .type = vk::DescriptorType::eStorageImage,
-        },
-    };
-
-    DescriptorLayoutConfig effectLayoutConfig = {
-        .bindings = effectBindings,
-        .stages = vk::ShaderStageFlagBits::eCompute,
-    };
-
-    mEffectDescriptorLayout.emplace(mDevice.value(), effectLayoutConfig);
 }
 
-void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
+void VkRenderer::_createDescriptorPool(const VkRendererConfig& config)
 {
+    const uint32_t lutDescriptorCount = ChainContext::getLutDescriptorCount();
+    const uint32_t blurSetCount = ChainContext::getBlurDescriptorSetCount(config.framesInFlight);
+    // Per frame for the displayed result, plus the chain context's own
+    const uint32_t statsSetCount = static_cast<uint32_t>(config.framesInFlight) + ChainContext::getStatsDescriptorSetCount();
+    // A ping and a pong set per frame
+    const uint32_t mipSetCount = static_cast<uint32_t>(config.framesInFlight) * 2U;
+
     std::vector<DescriptorPoolSize> poolSizes;
-    poolSizes.reserve(2U);
+    poolSizes.reserve(3U);
 
     DescriptorPoolSize samplerPoolSize{
         .type = vk::DescriptorType::eCombinedImageSampler,
-        .count = static_cast<uint32_t>(config.framesInFlight) * 10,
+        .count = static_cast<uint32_t>(config.framesInFlight) * 10 + lutDescriptorCount + blurSetCount,
     };
     DescriptorPoolSize storagePoolSize{
         .type = vk::DescriptorType::eStorageImage,
-        .count = static_cast<uint32_t>(config.framesInFlight) * 150,
+        .count = static_cast<uint32_t>(config.framesInFlight) * 150 + lutDescriptorCount + blurSetCount * 2U + mipSetCount * ChainContext::getMaxMipLevels(),
+    };
+
+    DescriptorPoolSize bufferPoolSize{
+        .type = vk::DescriptorType::eStorageBuffer,
+        .count = static_cast<uint32_t>(config.framesInFlight) * 10 + lutDescriptorCount + statsSetCount + mipSetCount,
     };
 
     poolSizes.push_back(samplerPoolSize);
     poolSizes.push_back(storagePoolSize);
+    poolSizes.push_back(bufferPoolSize);
 
     DescriptorPoolConfig poolConfig{
         .sizes = poolSizes,
-        .maxSets = static_cast<uint32_t>(config.framesInFlight) * 200 + IMGUI_IMPL_VULKAN_MINIMUM_IMAGE_SAMPLER_POOL_SIZE,
+        .maxSets = static_cast<uint32_t>(config.framesInFlight) * 200 + lutDescriptorCount * 2U + blurSetCount + statsSetCount + mipSetCount + IMGUI_IMPL_VULKAN_MINIMUM_IMAGE_SAMPLER_POOL_SIZE,
     };
 
     mDescriptorPool.emplace(mDevice.value(), poolConfig);
+}
 
-    mDescriptors.clear();
-    mDescriptors.reserve(config.framesInFlight);
+void VkRenderer::_createChainContext(const VkRendererConfig& config)
+{
+    mRecentEffects = _loadRecentEffects();
 
-    for (size_t i = 0; i < config.framesInFlight; i++)
-    {
-        const auto& images = mImages.at(i);
+    ChainContextConfig contextConfig = {
+        .commandPool = _getChainCommandPool(),
+        .descriptorPool = mDescriptorPool.value(),
 
-        std::vector<DescriptorSetImage> samplerImages;
-        samplerImages.reserve(2);
-        samplerImages.push_back(DescriptorSetImage{
-            .binding = 0U,
-            .texture = mTexture.value(),
-            .sampler = &mSampler.value(),
-            .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
-            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-        });
-        samplerImages.push_back(DescriptorSetImage{
-            .binding = 1U,
-            .texture = images.ping,
-            .layout = vk::ImageLayout::eGeneral,
-            .descriptorType = vk::DescriptorType::eStorageImage,
-        });
+        .registry = mAppData.registry,
+        .stageCache = &mStageCache.value(),
+        .profiler = &mGpuProfiler.value(),
 
-        DescriptorSetConfig samplerConfig = {
-            .descriptorLayout = mSamplerDescriptorLayout.value(),
-            .descriptorPool = mDescriptorPool.value()
-        };
+        .lutSize = config.lutSize,
+        .workingFormat = config.workingFormat,
+        .chainsInFlight = config.framesInFlight,
 
-        DescriptorSet sampler{ mDevice.value(), samplerConfig };
-        sampler.update(DescriptorUpdateConfig{ .images = samplerImages });
+        .prewarmEffects = mRecentEffects,
+    };
 
-        std::vector<DescriptorSetImage> computeABImages;
-        computeABImages.reserve(2);
-        computeABImages.push_back(DescriptorSetImage{
-            .binding = 0U,
-            .texture = images.ping,
-            .layout = vk::ImageLayout::eGeneral,
-            .descriptorType = vk::DescriptorType::eStorageImage,
-        });
-        computeABImages.push_back(DescriptorSetImage{
-            .binding = 1U,
-            .texture = images.pong,
-            .layout = vk::ImageLayout::eGeneral,
-            .descriptorType = vk::DescriptorType::eStorageImage,
-        });
+    mChainContext.emplace(mDevice.value(), contextConfig);
 
-        DescriptorSetConfig computeABConfig = {
-            .descriptorLayout = mEffectDescriptorLayout.value(),
-            .descriptorPool = mDescriptorPool.value()
-        };
+    mFusedOpBuffers.clear();
+    mFusedOpBuffers.reserve(config.framesInFlight);
 
-        DescriptorSet computeAB{ mDevice.value(), computeABConfig };
-        computeAB.update(DescriptorUpdateConfig{ .images = computeABImages });
+    for (size_t i = 0; i < config.framesInFlight; i++) {
+        mFusedOpBuffers.emplace_back(mChainContext->createFusedOpBuffer());
+    }
 
-        std::vector<DescriptorSetImage> computeBAImages;
-        computeBAImages.reserve(2);
-        computeBAImages.push_back(DescriptorSetImage{
-            .binding = 0U,
-            .texture = images.pong,
-            .layout = vk::ImageLayout::eGeneral,
-            .descriptorType = vk::DescriptorType::eStorageImage,
-        });
-        computeBAImages.push_back(DescriptorSetImage{
-            .binding = 1U,
-            .texture = images.ping,
-            .layout = vk::ImageLayout::eGeneral,
-            .descriptorType = vk::DescriptorType::eStorageImage,
-        });
+    mStatsTargets.clear();
+    mStatsTargets.reserve(config.framesInFlight);
 
-        DescriptorSetConfig computeBAConfig = {
-            .descriptorLayout = mEffectDescriptorLayout.value(),
-            .descriptorPool = mDescriptorPool.value()
-        };
+    for (size_t i = 0; i < config.framesInFlight; i++) {
+        mStatsTargets.emplace_back(mChainContext->createStatsTarget(true));
+    }
+}
+
+void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
+{
+    mDescriptors.clear();
+    mDescriptors.reserve(config.framesInFlight);
 
-        DescriptorSet computeBA{ mDevice.value(), computeBAConfig };
-        computeBA.update(DescriptorUpdateConfig{ .images = computeBAImages });
+    for (size_t i = 0; i < config.framesInFlight; i++)
+    {
+        const auto& images = mImages.at(i);
 
         std::vector<DescriptorSetImage> graphicsAImages;
         graphicsAImages.reserve(2);
@@ -448,6 +504,7 @@ void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
             .sampler = &mSampler.value(),
             .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
             .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .view = images.ping.getMipChainView(),
         });
         graphicsAImages.push_back(DescriptorSetImage{
             .binding = 1U,
@@ -473,6 +530,7 @@ void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
             .sampler = &mSampler.value(),
             .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
             .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            .view = images.pong.getMipChainView(),
         });
         graphicsBImages.push_back(DescriptorSetImage{
             .binding = 1U,
@@ -491,10 +549,8 @@ void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
         graphicsB.update(DescriptorUpdateConfig{ .images = graphicsBImages });
 
         mDescriptors.emplace_back(RenderDescriptorSet{
-            .sampler = std::move(sampler),
-
-            .computeAtoB = std::move(computeAB),
-            .computeBtoA = std::move(computeBA),
+            .compute = mChainContext->createDescriptors(images, mSampler.value(), mFusedOpBuffers.at(i)),
+            .mips = mChainContext->createMipDescriptors(images),
 
             .graphicsA = std::move(graphicsA),
             .graphicsB = std::move(graphicsB),
@@ -504,14 +560,6 @@ void VkRenderer::_createDescriptorSets(const VkRendererConfig& config)
 
 void VkRenderer::_createPipelines()
 {
-    ComputePipelineConfig samplerConfig = {
-        .shaderPath = BinaryReader::toShaderBinPath("sampler.spv"),
-        .descriptorLayout = mSamplerDescriptorLayout.value(),
-        .usePushConstants = false,
-    };
-
-    mSamplerPipeline.emplace(mDevice.value(), samplerConfig);
-
     GraphicsPipelineConfig graphicsConfig = {
         .vertexShaderPath = BinaryReader::toShaderBinPath("vertex.spv"),
         .fragmentShaderPath = BinaryReader::toShaderBinPath("fragment.spv"),
@@ -529,25 +577,14 @@ void VkRenderer::_createPipelines()
 
     mGraphicsPipeline.emplace(mDevice.value(), graphicsConfig);
 
-    std::unordered_map<std::string, ComputePipeline> effectPipelines;
-
-    for (const auto& effect : mAppData.registry.getEffects()) {
-        const auto& id = effect.getId();
-        const auto& shaderPath = effect.getShaderPath();
+    // Counts the pipelines built at startup. Effect pipelines build in the background and are
+    // saved once their builds drain, and at cleanup.
+    auto& pipelineCache = mDevice->getPipelineCache();
+    const auto stats = pipelineCache.getStats();
 
-        uint32_t pushConstantSize = effect.getParams().size() * sizeof(float);
-
-        ComputePipelineConfig pipeConfig = {
-            .shaderPath = shaderPath,
-            .descriptorLayout = mEffectDescriptorLayout.value(),
-            .usePushConstants = pushConstantSize > 0U,
-            .pushConstantSize = pushConstantSize,
-        };
+    std::cout << "Pipeline cache: " << stats.hits << " hits, " << stats.misses << " misses, " << stats.loadedBytes << " bytes loaded\n";
 
-        effectPipelines.try_emplace(id, mDevice.value(), pipeConfig);
-    }
-
-    mPipelineSet.emplace(std::move(effectPipelines));
+    pipelineCache.save();
 }
 
 void VkRenderer::_setupImGui(const VkRendererConfig& config)
@@ -579,12 +616,12 @@ void VkRenderer::_setupImGui(const VkRendererConfig& config)
 
     ImGui_ImplVulkan_InitInfo initInfo{};
     initInfo.ApiVersion = VK_API_VERSION_1_4;
-    initInfo.Instance = mInstance.get();
+    initInfo.Instance = mInstance->getVkHandle();
     initInfo.PhysicalDevice = mDevice->getPhysicalDevice(),
     initInfo.Device = mDevice->getVkHandle();
     initInfo.QueueFamily = families.graphicsAndComputeFamily.value();
     initInfo.Queue = mDevice->getGraphicsQueue();
-    initInfo.PipelineCache = nullptr;
+    initInfo.PipelineCache = mDevice->getPipelineCache().getVkHandle();
     initInfo.DescriptorPool = mDescriptorPool->getVkHandle();
     initInfo.MinImageCount = config.framesInFlight;
     initInfo.ImageCount = mDevice->getSwapchain().getImageCount();
@@ -609,14 +646,20 @@ void VkRenderer::_createCommandBuffers(const VkRendererConfig& rendererConfig)
         .appData = mAppData,
 
         .commandPool = mCommandPool.value(),
+        .computeCommandPool = mComputeCommandPool.has_value() ? &mComputeCommandPool.value() : nullptr,
         .renderpass = mRenderpass.value(),
         .framebuffers = &mFramebuffers,
 
         .renderDescriptors = mDescriptors,
         .renderImages = mImages,
-        .samplerPipeline = mSamplerPipeline.value(),
         .graphicsPipeline = mGraphicsPipeline.value(),
-        .pipelineSet = mPipelineSet.value(),
+        .chainRecorder = mChainContext->getChainRecorder(),
+        .fusedOpBuffers = mFusedOpBuffers,
+        .statsTargets = mStatsTargets,
+        .readbackRing = mReadbackRing.value(),
+        .uploader = mUploader.value(),
+        .profiler = mGpuProfiler.value(),
+        .scheduler = mFrameScheduler.value(),
 
         .extent = mDevice->getSwapchain().getExtent(),
 
@@ -634,12 +677,15 @@ void VkRenderer::_createCommandBuffers(const VkRendererConfig& rendererConfig)
 
 void VkRenderer::_createSyncObjects(const VkRendererConfig& config)
 {
+    mFrameScheduler.emplace(mDevice.value(), FrameSchedulerConfig{ .framesInFlight = config.framesInFlight });
+
     mImageAvailableSemaphores.emplace(mDevice.value(), config.framesInFlight);
     mRenderedPerImageSemaphores.emplace(mDevice.value(), mDevice.value().getSwapchain().getImageCount());
-    mInFlightFences.emplace(mDevice.value(), FenceConfig{ .signaled = true }, config.framesInFlight);
+}
 
-    mCurrentFrame = 0;
-    mFramesInFlight = config.framesInFlight;
+const CommandPool& VkRenderer::_getChainCommandPool() const
+{
+    return mComputeCommandPool.has_value() ? mComputeCommandPool.value() : mCommandPool.value();
 }
 
 void VkRenderer::_recreateSwapchain()
@@ -659,3 +705,93 @@ void VkRenderer::_recreateSwapchain()
 
     mCommandBuffers->updateFramebuffers(&mFramebuffers, mDevice->getSwapchain().getExtent());
 }
+
+void VkRenderer::_exportLut(const std::filesystem::path& path)
+{
+    EffectChain chain{ mAppData.effects };
+
+    if (!chain.isColorOnly()) {
+        std::cerr << "Only chains of color effects can be exported as a LUT.\n";
+        return;
+    }
+
+    mChainContext->getLutCache().exportCube(chain.getFusedOps(0U, chain.getStages().size()), path);
+
+    std::cout << "Exported LUT to " << path.string() << "\n";
+}
+
+std::vector<std::string> VkRenderer::_loadRecentEffects()
+{
+    std::vector<std::string> ids;
+    std::ifstream file{ Paths::RecentEffects };
+
+    for (std::string id; std::getline(file, id);) {
+        if (!id.empty()) ids.push_back(id);
+    }
+
+    return ids;
+}
+
+void VkRenderer::_saveRecentEffects() const
+{
+    std::vector<std::string> ids;
+
+    auto add = [&ids](const std::string& id) {
+        if (ids.size() < gRecentEffectCount && std::ranges::find(ids, id) == ids.end()) {
+            ids.push_back(id);
+        }
+    };
+
+    for (const auto& effect : mAppData.effects) {
+        add(effect.effect->getId());
+    }
+    for (const auto& id : mRecentEffects) {
+        add(id);
+    }
+
+    std::filesystem::create_directories(Paths::RecentEffects.parent_path());
+
+    std::ofstream file{ Paths::RecentEffects };
+    for (const auto& id : ids) {
+        file << id << "\n";
+    }
+}
+
+void VkRenderer::_pollImageExports()
+{
+    // Tickets complete in submission order, so polling stops at the first pending one
+    while (!mImageExports.empty() && mReadbackRing->isReady(mImageExports.front().ticket)) {
+        auto imageExport = std::move(mImageExports.front());
+        mImageExports.pop_front();
+
+        const auto& ticket = imageExport.ticket;
+        const auto* data = mReadbackRing->getData(ticket);
+
+        std::vector<uint8_t> texels(data, data + ticket.size);
+        mReadbackRing->release(ticket);
+
+        // Encoding takes far longer than a frame, so it runs off the render loop
+        mImageEncodes.push_back(std::async(std::launch::async, [path = std::move(imageExport.path), width = ticket.width, height = ticket.height, format = ticket.format, texels = std::move(texels)]() {
+            const auto pixels = encodeReadbackToSrgb(texels.data(), size_t{ width } * height, format);
+
+            if (path.has_parent_path()) {
+                std::filesystem::create_directories(path.parent_path());
+            }
+
+            Image::save(path, width, height, pixels);
+
+            std::cout << "Exported image to " << path.string() << "\n";
+        }));
+    }
+
+    while (!mImageEncodes.empty() && mImageEncodes.front().wait_for(std::chrono::seconds{ 0 }) == std::future_status::ready) {
+        try {
+            mImageEncodes.front().get();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Failed to export image: " << e.what() << "\n";
+        }
+
+        mImageEncodes.pop_front();
+    }
+}
@@ -2,25 +2,37 @@
 
 #include <vulkan/include.hpp>
 
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <app_data.hpp>
+#include <effect/chain.hpp>
+#include <vulkan/chain_context.hpp>
 #include <vulkan/device.hpp>
 #include <vulkan/glfw_surface.hpp>
+#include <vulkan/instance.hpp>
 #include <vulkan/renderpass.hpp>
 #include <vulkan/sampler.hpp>
 #include <vulkan/vertex.hpp>
+#include <vulkan/working_format.hpp>
 #include <vulkan/buffer/buffer.hpp>
 #include <vulkan/buffer/commandbuffer.hpp>
 #include <vulkan/buffer/commandpool.hpp>
 #include <vulkan/buffer/framebuffer.hpp>
+#include <vulkan/buffer/readback_ring.hpp>
+#include <vulkan/buffer/stage_cache.hpp>
 #include <vulkan/buffer/texture.hpp>
+#include <vulkan/buffer/uploader.hpp>
 #include <vulkan/descriptor/descriptor_layout.hpp>
 #include <vulkan/descriptor/descriptor_pool.hpp>
-#include <vulkan/pipeline/compute_pipeline.hpp>
 #include <vulkan/pipeline/graphics_pipeline.hpp>
-#include <vulkan/pipeline/pipeline_set.hpp>
-#include <vulkan/sync/fence.hpp>
+#include <vulkan/query/gpu_profiler.hpp>
+#include <vulkan/query/image_stats.hpp>
+#include <vulkan/sync/frame_scheduler.hpp>
 #include <vulkan/sync/semaphore.hpp>
 #include <imgui_renderer.hpp>
 #include <window.hpp>
@@ -39,6 +51,17 @@ struct VkRendererConfig
     const std::vector<uint32_t>& indices;
 
     uint32_t framesInFlight;
+    vk::DeviceSize stageCacheBudget;
+    // Ring that uploads copy their source data through
+    vk::DeviceSize stagingSize;
+
+    // Lattice points per axis of baked color LUTs
+    uint32_t lutSize;
+    // Storage format of the ping/pong images and cached stages
+    WorkingFormat workingFormat;
+    // Records effect chains for a dedicated compute queue when the device has one, so the chain
+    // of the next frame runs while the current one is rendered and presented
+    bool useAsyncCompute;
     
     Window& window;
 };
@@ -48,41 +71,52 @@ class VkRenderer
 public:
     VkRenderer(VkRendererConfig config);
 
-    [[nodiscard]] const vk::UniqueInstance& getInstance() const noexcept;
-    [[nodiscard]] vk::SurfaceKHR getSurface() const noexcept;
-
     void draw();
 
     void cleanup();
 private:
-    void _createInstance(const VkRendererConfig& config);
-    void _printExtensions();
-
-    void _setupDebugMessenger();
-    void _populateDebugMessengerCreateInfo(vk::DebugUtilsMessengerCreateInfoEXT& createInfo);
+    struct ImageExport
+    {
+        ReadbackTicket ticket;
+        std::filesystem::path path;
+    };
 
+    void _createInstance(const VkRendererConfig& config);
     void _createSurface(const Window& window);
+    void _createDevice(const VkRendererConfig& config);
 
     void _createRenderpass();
     void _createFramebuffers();
-    void _createCommandPool();
+    void _createCommandPool(const VkRendererConfig& config);
+    void _createProfiler(const VkRendererConfig& config);
     void _createBuffers(const VkRendererConfig& config);
     void _createTextures(const VkRendererConfig& config);
+    void _createReadbackRing();
     void _createDescriptorLayouts(const VkRendererConfig& config);
+    void _createDescriptorPool(const VkRendererConfig& config);
+    void _createChainContext(const VkRendererConfig& config);
     void _createDescriptorSets(const VkRendererConfig& config);
     void _createPipelines();
     void _setupImGui(const VkRendererConfig& config);
     void _createCommandBuffers(const VkRendererConfig& config);
     void _createSyncObjects(const VkRendererConfig& config);
 
+    // Pool of the queue effect chains run on, which owns the images only they use
+    [[nodiscard]] const CommandPool& _getChainCommandPool() const;
+
     void _recreateSwapchain();
+    void _exportLut(const std::filesystem::path& path);
+    void _pollImageExports();
+
+    // Ids of effects used in earlier sessions, most recent first, whose pipelines are prewarmed
+    static std::vector<std::string> _loadRecentEffects();
+    void _saveRecentEffects() const;
 
     AppData& mAppData;
 
     Window& mWindow;
 
-    vk::UniqueInstance mInstance;
-    vk::UniqueDebugUtilsMessengerEXT mDebugMessenger;
+    std::optional<Instance> mInstance;
     std::optional<GLFWVkSurface> mSurface;
 
     std::optional<Device> mDevice;
@@ -91,35 +125,44 @@ private:
 
     std::vector<Framebuffer> mFramebuffers;
 
-    uint32_t mCurrentFrame;
-    uint32_t mFramesInFlight;
-
     std::optional<CommandPool> mCommandPool;
+    // Only created when chains run on the async compute queue
+    std::optional<CommandPool> mComputeCommandPool;
+    std::optional<Uploader> mUploader;
+    std::optional<GpuProfiler> mGpuProfiler;
 
     std::optional<Buffer> mVertexBuffer;
     std::optional<Buffer> mIndexBuffer;
+    std::vector<Buffer> mFusedOpBuffers;
 
     std::optional<TextureImage> mTexture;
     std::optional<Sampler> mSampler;
     std::vector<RenderImageSet> mImages;
+    std::optional<StageCache> mStageCache;
+
+    // Exports are copied into the ring by a frame and encoded once that frame completes
+    std::optional<ReadbackRing> mReadbackRing;
+    std::deque<ImageExport> mImageExports;
+    std::deque<std::future<void>> mImageEncodes;
 
     std::optional<DescriptorLayout> mFragmentDescriptorLayout;
-    std::optional<DescriptorLayout> mSamplerDescriptorLayout;
-    std::optional<DescriptorLayout> mEffectDescriptorLayout;
 
     std::optional<DescriptorPool> mDescriptorPool;
+    std::optional<ChainContext> mChainContext;
+    // Sets come from the descriptor pool, so these are destroyed before it
+    std::vector<ImageStatsTarget> mStatsTargets;
+    std::vector<std::string> mRecentEffects;
     std::vector<RenderDescriptorSet> mDescriptors;
 
     std::optional<ImGuiRenderer> mImGuiRenderer;
 
     std::optional<CommandBuffer> mCommandBuffers;
 
-    std::optional<ComputePipeline> mSamplerPipeline;
-    std::optional<ComputePipeline> mGrayscalePipeline;
     std::optional<GraphicsPipeline> mGraphicsPipeline;
-    std::optional<PipelineSet> mPipelineSet;
 
+    std::optional<FrameScheduler> mFrameScheduler;
+
+    // Binary, as swapchain acquire and present can't use timeline semaphores
     std::optional<BatchedSemaphores> mImageAvailableSemaphores;
     std::optional<BatchedSemaphores> mRenderedPerImageSemaphores;
-    std::optional<BatchedFences> mInFlightFences;
 };
@@ -7,14 +7,16 @@ Sampler::Sampler(const Device& device, const SamplerConfig& config)
     vk::SamplerCreateInfo samplerInfo{};
     samplerInfo.magFilter = vk::Filter::eLinear;
     samplerInfo.minFilter = vk::Filter::eLinear;
-    samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToBorder;
-    samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToBorder;
-    samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToBorder;
+    samplerInfo.addressModeU = config.addressMode;
+    samplerInfo.addressModeV = config.addressMode;
+    samplerInfo.addressModeW = config.addressMode;
 
     auto deviceProps = device.getPhysicalDevice().getProperties();
 
-    samplerInfo.anisotropyEnable = vk::True;
-    samplerInfo.maxAnisotropy = deviceProps.limits.maxSamplerAnisotropy;
+    bool anisotropy = config.anisotropy && device.isSamplerAnisotropyEnabled();
+
+    samplerInfo.anisotropyEnable = anisotropy ? vk::True : vk::False;
+    samplerInfo.maxAnisotropy = anisotropy ? deviceProps.limits.maxSamplerAnisotropy : 1.0f;
 
     samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
     samplerInfo.unnormalizedCoordinates = vk::False;
@@ -24,7 +26,7 @@ Sampler::Sampler(const Device& device, const SamplerConfig& config)
     samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = config.maxLod;
 
     mSampler = device.getVkHandle().createSamplerUnique(samplerInfo);
 }
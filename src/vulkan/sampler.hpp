@@ -6,6 +6,10 @@ class Device;
 
 struct SamplerConfig
 {
+    vk::SamplerAddressMode addressMode = vk::SamplerAddressMode::eClampToBorder;
+    bool anisotropy = true;
+    // Highest mip level sampled, vk::LodClampNone for the whole chain
+    float maxLod = 0.0f;
 };
 
 class Sampler
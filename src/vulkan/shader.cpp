@@ -1,15 +1,42 @@
 #include "shader.hpp"
 
+#include <memory>
+#include <vector>
+
 #include <io/binary.hpp>
+#include <io/path.hpp>
+#include <io/shader_archive.hpp>
 #include <vulkan/device.hpp>
 
+// Mapped once per process, null when shaders were compiled without packing them
+static const ShaderArchive* _getArchive()
+{
+    static const auto archive = []() -> std::unique_ptr<ShaderArchive> {
+        if (!std::filesystem::exists(Paths::ShaderArchive)) {
+            return nullptr;
+        }
+
+        return std::make_unique<ShaderArchive>(Paths::ShaderArchive);
+    }();
+
+    return archive.get();
+}
+
 Shader::Shader(const Device& device, const std::filesystem::path& filepath, const ShaderConfig& config)
     : mDevice{device}
     , mStageInfo{}
 {
-    auto shaderCode = BinaryReader::readFromPath(filepath);
+    // Packed shaders are read straight from the mapping, anything else from its own file
+    const auto* archive = filepath.parent_path() == Paths::ShadersBin ? _getArchive() : nullptr;
+
+    if (auto code = archive != nullptr ? archive->find(filepath.filename().string()) : std::nullopt) {
+        _createShaderModule(code.value());
+    }
+    else {
+        auto bytecode = BinaryReader::readFromPath(filepath);
+        _createShaderModule(std::span{ reinterpret_cast<const uint32_t*>(bytecode.data()), bytecode.size() / sizeof(uint32_t) });
+    }
 
-    _createShaderModule(shaderCode);
     _createShaderStageInfo(config);
 }
 
@@ -23,11 +50,11 @@ const vk::PipelineShaderStageCreateInfo& Shader::getStageInfo() const
     return mStageInfo;
 }
 
-void Shader::_createShaderModule(const std::vector<char>& bytecode)
+void Shader::_createShaderModule(std::span<const uint32_t> code)
 {
     vk::ShaderModuleCreateInfo createInfo{};
-    createInfo.setCodeSize(bytecode.size());
-    createInfo.setPCode(reinterpret_cast<const uint32_t*>(bytecode.data()));
+    createInfo.setCodeSize(code.size_bytes());
+    createInfo.setPCode(code.data());
 
     mModule = mDevice.getVkHandle().createShaderModuleUnique(createInfo);
 }
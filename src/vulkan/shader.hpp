@@ -2,8 +2,9 @@
 
 #include <vulkan/include.hpp>
 
+#include <cstdint>
 #include <filesystem>
-#include <vector>
+#include <span>
 
 class Device;
 
@@ -27,7 +28,7 @@ public:
     const vk::ShaderModule& getModule() const;
     const vk::PipelineShaderStageCreateInfo& getStageInfo() const;
 private:
-    void _createShaderModule(const std::vector<char>& bytecode);
+    void _createShaderModule(std::span<const uint32_t> code);
 
     static vk::ShaderStageFlagBits _convertShaderType(const ShaderType& type);
     void _createShaderStageInfo(const ShaderConfig& config);
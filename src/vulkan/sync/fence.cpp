@@ -25,25 +25,3 @@ void Fence::wait(uint64_t timeout) const
 {
     mDevice.getVkHandle().waitForFences(getVkHandle(), vk::True, timeout);
 }
-
-BatchedFences::BatchedFences(const Device& device, const FenceConfig& config, uint32_t count)
-{
-    mFences.reserve(count);
-
-    std::generate_n(std::back_inserter(mFences), count, [&device, config]() { return Fence{ device, config }; });
-}
-
-const Fence& BatchedFences::getFence(uint32_t index) const noexcept
-{
-    return mFences[index];
-}
-
-const vk::Fence BatchedFences::getVkHandle(uint32_t index) const noexcept
-{
-    return getFence(index).getVkHandle();
-}
-
-uint32_t BatchedFences::getCount() const noexcept
-{
-    return static_cast<uint32_t>(mFences.size());
-}
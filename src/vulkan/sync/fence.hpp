@@ -1,7 +1,5 @@
 #pragma once
 
-#include <vector>
-
 #include <vulkan/include.hpp>
 
 class Device;
@@ -25,15 +23,3 @@ private:
 
     vk::UniqueFence mFence;
 };
-
-class BatchedFences
-{
-public:
-    BatchedFences(const Device& device, const FenceConfig& config, uint32_t count);
-
-    [[nodiscard]] const Fence& getFence(uint32_t index) const noexcept;
-    [[nodiscard]] const vk::Fence getVkHandle(uint32_t index) const noexcept;
-    [[nodiscard]] uint32_t getCount() const noexcept;
-private:
-    std::vector<Fence> mFences;
-};
@@ -0,0 +1,80 @@
+#include "frame_scheduler.hpp"
+
+#include <algorithm>
+
+#include <vulkan/device.hpp>
+
+FrameScheduler::FrameScheduler(const Device& device, const FrameSchedulerConfig& config)
+    : mFramesInFlight{ std::max(config.framesInFlight, 1U) }
+    , mFrameTimeline{ device }
+    , mComputeTimeline{ device }
+{
+}
+
+void FrameScheduler::beginFrame()
+{
+    mFrame++;
+
+    if (mFrame <= mFramesInFlight) {
+        return;
+    }
+
+    // Frames that were never submitted are skipped, a later one completing covers them
+    const auto reusedFrame = std::min(mFrame - mFramesInFlight, mSubmittedFrame);
+
+    if (reusedFrame > 0U) {
+        mFrameTimeline.wait(reusedFrame);
+    }
+}
+
+uint64_t FrameScheduler::getFrame() const noexcept
+{
+    return mFrame;
+}
+
+uint32_t FrameScheduler::getFrameIndex() const noexcept
+{
+    return static_cast<uint32_t>(mFrame % mFramesInFlight);
+}
+
+uint32_t FrameScheduler::getFramesInFlight() const noexcept
+{
+    return mFramesInFlight;
+}
+
+uint64_t FrameScheduler::getCompletedFrame() const
+{
+    return mFrameTimeline.getValue();
+}
+
+vk::SemaphoreSubmitInfo FrameScheduler::takeFrameSignal()
+{
+    mSubmittedFrame = mFrame;
+
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.setSemaphore(mFrameTimeline.getVkHandle());
+    signalInfo.setValue(mFrame);
+    signalInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    return signalInfo;
+}
+
+vk::SemaphoreSubmitInfo FrameScheduler::createComputeSignal() const
+{
+    vk::SemaphoreSubmitInfo signalInfo{};
+    signalInfo.setSemaphore(mComputeTimeline.getVkHandle());
+    signalInfo.setValue(mFrame);
+    signalInfo.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+
+    return signalInfo;
+}
+
+vk::SemaphoreSubmitInfo FrameScheduler::createComputeWait(vk::PipelineStageFlags2 stageMask) const
+{
+    vk::SemaphoreSubmitInfo waitInfo{};
+    waitInfo.setSemaphore(mComputeTimeline.getVkHandle());
+    waitInfo.setValue(mFrame);
+    waitInfo.setStageMask(stageMask);
+
+    return waitInfo;
+}
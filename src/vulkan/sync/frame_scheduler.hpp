@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/include.hpp>
+#include <vulkan/sync/semaphore.hpp>
+
+class Device;
+
+struct FrameSchedulerConfig
+{
+    uint32_t framesInFlight;
+};
+
+// Paces frames on a timeline semaphore counting them. Frame n signals n once its last submission
+// completes, so anything it used can be reclaimed when the counter reaches n. Queues wait on each
+// other's timelines on the GPU, the host only blocks before reusing the slot of an older frame.
+class FrameScheduler
+{
+public:
+    FrameScheduler(const Device& device, const FrameSchedulerConfig& config);
+
+    // Starts the next frame, waiting until the last frame that used its slot has completed
+    void beginFrame();
+
+    [[nodiscard]] uint64_t getFrame() const noexcept;
+    // Slot of the per-frame resources the current frame uses
+    [[nodiscard]] uint32_t getFrameIndex() const noexcept;
+    [[nodiscard]] uint32_t getFramesInFlight() const noexcept;
+
+    // Latest frame whose submissions all completed
+    [[nodiscard]] uint64_t getCompletedFrame() const;
+
+    // Signal for the last submission of the current frame, a frame that takes none is never waited on
+    [[nodiscard]] vk::SemaphoreSubmitInfo takeFrameSignal();
+
+    // Signal for the async compute work of the current frame, and the wait on it for the submission consuming its results
+    [[nodiscard]] vk::SemaphoreSubmitInfo createComputeSignal() const;
+    [[nodiscard]] vk::SemaphoreSubmitInfo createComputeWait(vk::PipelineStageFlags2 stageMask) const;
+private:
+    uint32_t mFramesInFlight;
+
+    TimelineSemaphore mFrameTimeline;
+    TimelineSemaphore mComputeTimeline;
+
+    uint64_t mFrame = 0U;
+    uint64_t mSubmittedFrame = 0U;
+};
@@ -1,5 +1,7 @@
 #include "semaphore.hpp"
 
+#include <stdexcept>
+
 #include <vulkan/device.hpp>
 
 static constexpr vk::SemaphoreCreateInfo gSemaphoreInfo{};
@@ -15,6 +17,42 @@ const vk::Semaphore Semaphore::getVkHandle() const
     return mSemaphore.get();
 }
 
+TimelineSemaphore::TimelineSemaphore(const Device& device, uint64_t initialValue)
+    : mDevice{ device }
+{
+    vk::SemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.setSemaphoreType(vk::SemaphoreType::eTimeline);
+    typeInfo.setInitialValue(initialValue);
+
+    vk::SemaphoreCreateInfo createInfo{};
+    createInfo.setPNext(&typeInfo);
+
+    mSemaphore = mDevice.getVkHandle().createSemaphoreUnique(createInfo);
+}
+
+const vk::Semaphore TimelineSemaphore::getVkHandle() const noexcept
+{
+    return mSemaphore.get();
+}
+
+uint64_t TimelineSemaphore::getValue() const
+{
+    return mDevice.getVkHandle().getSemaphoreCounterValue(mSemaphore.get());
+}
+
+void TimelineSemaphore::wait(uint64_t value, uint64_t timeout) const
+{
+    auto semaphore = mSemaphore.get();
+
+    vk::SemaphoreWaitInfo waitInfo{};
+    waitInfo.setSemaphores(semaphore);
+    waitInfo.setValues(value);
+
+    if (mDevice.getVkHandle().waitSemaphores(waitInfo, timeout) != vk::Result::eSuccess) {
+        throw std::runtime_error("Timed out waiting for a timeline semaphore.");
+    }
+}
+
 BatchedSemaphores::BatchedSemaphores(const Device& device, size_t count)
 {
     mSemaphores.reserve(count);
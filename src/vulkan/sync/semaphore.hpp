@@ -18,6 +18,22 @@ private:
     vk::UniqueSemaphore mSemaphore;
 };
 
+// Semaphore with a monotonically increasing counter, waitable from the host
+class TimelineSemaphore
+{
+public:
+    TimelineSemaphore(const Device& device, uint64_t initialValue = 0U);
+
+    [[nodiscard]] const vk::Semaphore getVkHandle() const noexcept;
+
+    [[nodiscard]] uint64_t getValue() const;
+    void wait(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+private:
+    const Device& mDevice;
+
+    vk::UniqueSemaphore mSemaphore;
+};
+
 class BatchedSemaphores
 {
 public:
@@ -0,0 +1,93 @@
+#include "working_format.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+
+static const std::array gWorkingFormats{ WorkingFormat::Rgba8, WorkingFormat::Rgba16f, WorkingFormat::Rgba32f };
+
+vk::Format toVkFormat(WorkingFormat format) noexcept
+{
+    switch (format) {
+    case WorkingFormat::Rgba16f:
+        return vk::Format::eR16G16B16A16Sfloat;
+    case WorkingFormat::Rgba32f:
+        return vk::Format::eR32G32B32A32Sfloat;
+    default:
+        return vk::Format::eR8G8B8A8Unorm;
+    }
+}
+
+uint32_t getPixelSize(WorkingFormat format) noexcept
+{
+    switch (format) {
+    case WorkingFormat::Rgba16f:
+        return 8U;
+    case WorkingFormat::Rgba32f:
+        return 16U;
+    default:
+        return 4U;
+    }
+}
+
+bool canBakeLut(WorkingFormat format) noexcept
+{
+    return format == WorkingFormat::Rgba8;
+}
+
+std::string_view getWorkingFormatName(WorkingFormat format) noexcept
+{
+    switch (format) {
+    case WorkingFormat::Rgba16f:
+        return "rgba16f";
+    case WorkingFormat::Rgba32f:
+        return "rgba32f";
+    default:
+        return "rgba8";
+    }
+}
+
+std::optional<WorkingFormat> parseWorkingFormat(std::string_view name) noexcept
+{
+    for (auto format : gWorkingFormats) {
+        if (getWorkingFormatName(format) == name) {
+            return format;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::filesystem::path toShaderVariantPath(const std::filesystem::path& path, WorkingFormat format, bool halfMath)
+{
+    // RGBA8 binaries keep their plain names
+    if (format == WorkingFormat::Rgba8) {
+        return path;
+    }
+
+    auto variant = path;
+    const std::string math = halfMath && format == WorkingFormat::Rgba16f ? ".f16" : "";
+    variant.replace_filename(path.stem().string() + "." + std::string{ getWorkingFormatName(format) } + math + path.extension().string());
+
+    return variant;
+}
+
+float halfToFloat(uint16_t half) noexcept
+{
+    const uint32_t exponent = (half >> 10U) & 0x1FU;
+    const uint32_t mantissa = half & 0x3FFU;
+
+    float value;
+    if (exponent == 0U) {
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+    }
+    else if (exponent == 0x1FU) {
+        value = mantissa != 0U ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+    }
+    else {
+        value = std::ldexp(static_cast<float>(mantissa | 0x400U), static_cast<int>(exponent) - 25);
+    }
+
+    return (half & 0x8000U) ? -value : value;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include <vulkan/include.hpp>
+
+// Storage format of the ping/pong images and cached stages the effect chain runs in.
+// Float formats keep values outside [0, 1] and avoid 8-bit banding between stages.
+enum class WorkingFormat
+{
+    Rgba8,
+    Rgba16f,
+    Rgba32f,
+};
+
+[[nodiscard]] vk::Format toVkFormat(WorkingFormat format) noexcept;
+// Bytes per texel
+[[nodiscard]] uint32_t getPixelSize(WorkingFormat format) noexcept;
+
+// LUTs clamp every op to [0, 1] as RGBA8 stages do, float chains fuse their color runs instead
+[[nodiscard]] bool canBakeLut(WorkingFormat format) noexcept;
+
+// "rgba8", "rgba16f" or "rgba32f", as in shader variant names and benchmark results
+[[nodiscard]] std::string_view getWorkingFormatName(WorkingFormat format) noexcept;
+[[nodiscard]] std::optional<WorkingFormat> parseWorkingFormat(std::string_view name) noexcept;
+
+// Binary of a shader writing the chain images built for `format`, e.g. "fused.spv" becomes "fused.rgba16f.spv".
+// `halfMath` picks the RGBA16F build computing in float16, "fused.rgba16f.f16.spv", and needs shaderFloat16.
+// Only the fused kernel and the effect shaders have one.
+[[nodiscard]] std::filesystem::path toShaderVariantPath(const std::filesystem::path& path, WorkingFormat format, bool halfMath = false);
+
+// IEEE 754 binary16, as stored by RGBA16F images
+[[nodiscard]] float halfToFloat(uint16_t half) noexcept;